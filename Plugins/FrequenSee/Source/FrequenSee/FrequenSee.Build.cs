@@ -7,6 +7,11 @@ public class FrequenSee : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
+		// Public headers expose FrequenSeeDSP types (FFT plans, split-complex spectra)
+		PublicDependencyModuleNames.Add("FrequenSeeDSP");
+		// ...and FrequenSeeCore types (arrivals, band count); the tracing itself runs in the engine-independent core
+		PublicDependencyModuleNames.Add("FrequenSeeCore");
+
 		PrivateDependencyModuleNames.AddRange(new string[] {
 			"Core",
 			"CoreUObject",
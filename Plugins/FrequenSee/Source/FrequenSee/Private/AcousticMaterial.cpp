@@ -1 +1,20 @@
 ﻿#include "AcousticMaterial.h"
+
+float UAcousticMaterial::GetBandReflectance(int32 Band) const
+{
+	if (Absorption.Num() == 0)
+	{
+		return 1.0f;
+	}
+	const float Absorbed = Absorption[FMath::Min(Band, Absorption.Num() - 1)].Value;
+	return FMath::Clamp(1.0f - Absorbed, 0.0f, 1.0f);
+}
+
+float UAcousticMaterial::GetBandTransmission(int32 Band) const
+{
+	if (Transmission.Num() == 0)
+	{
+		return 0.0f;
+	}
+	return FMath::Clamp(Transmission[FMath::Min(Band, Transmission.Num() - 1)].Value, 0.0f, 1.0f);
+}
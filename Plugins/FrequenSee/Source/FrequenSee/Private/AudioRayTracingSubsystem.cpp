@@ -2,11 +2,126 @@
 
 #include <unordered_map>
 
+#include "Async/ParallelFor.h"
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
 #include "EngineUtils.h"
 #include "FrequenSeeAudioComponent.h"
+#include "FrequenSeeCallbackMonitor.h"
+#include "FrequenSeeSourceRegistry.h"
+#include "FrequenSeeDecay.h"
+#include "FrequenSeeSlabPool.h"
+#include "FrequenSeeStats.h"
+#include "FrequenSeeWorldScene.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarMaxConvolutionSources(
+    TEXT("FrequenSee.Reverb.MaxConvolutionSources"), 8,
+    TEXT("How many convolution reverbs may run at once, per source or per shared cluster; other sources render the FDN fallback."));
+
+static TAutoConsoleVariable<int32> CVarReverbClustering(
+    TEXT("FrequenSee.Reverb.Clustering"), 1,
+    TEXT("1 to convolve sources with similar impulse responses once per cluster on the reverb submix, 0 to convolve each source."));
+
+static TAutoConsoleVariable<int32> CVarListenerBus(
+    TEXT("FrequenSee.Reverb.ListenerBus"), 0,
+    TEXT("1 to send every playing source to a single listener reverb on the submix, convolved with the loudest source's IR. Overrides clustering, the distance limit and the convolution budget."));
+
+static TAutoConsoleVariable<float> CVarClusterThresholdDb(
+    TEXT("FrequenSee.Reverb.ClusterThresholdDb"), 3.0f,
+    TEXT("Largest RMS difference (dB) between two sources' decay profiles for them to share a reverb cluster."));
+
+static TAutoConsoleVariable<float> CVarConvolutionMaxDistance(
+    TEXT("FrequenSee.Reverb.ConvolutionMaxDistance"), 3000.0f,
+    TEXT("Listener distance (cm) beyond which sources always render the FDN fallback."));
+
+static TAutoConsoleVariable<int32> CVarTraceSeed(
+    TEXT("FrequenSee.Trace.Seed"), 0,
+    TEXT("Seed of the path tracer. Every trace is seeded from it, the source and how many traces the source has done, so a replay with the same seed traces the same paths."));
+
+static TAutoConsoleVariable<int32> CVarTraceSobol(
+    TEXT("FrequenSee.Trace.Sobol"), 1,
+    TEXT("1 to sample ray directions from an Owen-scrambled Sobol sequence, which converges faster per ray; 0 for independent random directions."));
+
+static TAutoConsoleVariable<int32> CVarTraceEstimator(
+    TEXT("FrequenSee.Trace.Estimator"), 0,
+    TEXT("0 to connect source and listener subpaths (bidirectional); 1 for diffuse rain, which only traces from the source and connects every bounce to the listener. Rain is cheaper per ray and usually less noisy in open, well-connected rooms."));
+
+static TAutoConsoleVariable<int32> CVarOcclusionOnly(
+    TEXT("FrequenSee.Trace.OcclusionOnly"), 0,
+    TEXT("1 to only update the sources' occlusion, skipping their reverb traces, as if every source had bOcclusionOnly set."));
+
+static TAutoConsoleVariable<int32> CVarOcclusionJitterRays(
+    TEXT("FrequenSee.Occlusion.JitterRays"), 4,
+    TEXT("Occlusion rays per source besides the direct one, from points around the source, so occlusion fades in and out as a source passes an edge."));
+
+static TAutoConsoleVariable<float> CVarOcclusionJitterRadius(
+    TEXT("FrequenSee.Occlusion.JitterRadius"), 50.0f,
+    TEXT("Distance from the source, in world units, of the points the jittered occlusion rays start from."));
+
+static TAutoConsoleVariable<int32> CVarTraceParallel(
+    TEXT("FrequenSee.Trace.Parallel"), 1,
+    TEXT("1 to split each source's rays across worker threads. The paths traced are the same either way."));
+
+static TAutoConsoleVariable<int32> CVarImageSourceOrder(
+    TEXT("FrequenSee.ImageSources.Order"), 2,
+    TEXT("Reflection orders (up to 3) whose specular reflections are rendered exactly by image sources over the registered geometry, leaving the path tracer the scattered energy; 0 to trace everything."));
+
+static TAutoConsoleVariable<float> CVarImageSourceRayScale(
+    TEXT("FrequenSee.ImageSources.RayScale"), 0.25f,
+    TEXT("Share of the path tracer's rays kept while image sources render the early specular reflections, which the tracer's noise would otherwise have to resolve."));
+
+namespace
+{
+    /** Tracer settings from the FrequenSee.Trace CVars; tracing and evaluating a path have to agree on the estimator. */
+    FrequenSeeCore::FTracerSettings MakeTracerSettings()
+    {
+        FrequenSeeCore::FTracerSettings Settings;
+        Settings.SamplePattern = CVarTraceSobol.GetValueOnGameThread() != 0 ? FrequenSeeCore::ESamplePattern::Sobol : FrequenSeeCore::ESamplePattern::Random;
+        Settings.Estimator = CVarTraceEstimator.GetValueOnGameThread() == 1 ? FrequenSeeCore::EPathEstimator::DiffuseRain : FrequenSeeCore::EPathEstimator::Bidirectional;
+        return Settings;
+    }
+
+    FPathEnergyResult ToEnergyResult(const FrequenSeeCore::FPathEnergy& Energy)
+    {
+        FPathEnergyResult Result;
+        Result.DelaySeconds = Energy.DelaySeconds;
+        Result.Gain = Energy.Gain;
+        Result.ReflectionOrder = Energy.ReflectionOrder;
+        Result.bDeterministic = Energy.bDeterministic;
+        FMemory::Memcpy(Result.BandReflectance, Energy.BandReflectance, sizeof(Result.BandReflectance));
+        Result.Direction = FVector3f(Energy.Direction.X, Energy.Direction.Y, Energy.Direction.Z);
+        return Result;
+    }
+
+    /** Heap copy of one of Batch's paths, for drawing that outlives the batch. */
+    FSoundPath ToSoundPath(const FrequenSeeCore::FPathBatch& Batch, const FrequenSeeCore::FPathRange& Path)
+    {
+        FSoundPath SoundPath;
+        SoundPath.Nodes.Reserve(Path.NumVertices);
+        const FrequenSeeCore::FPathVertex* Vertices = Batch.GetVertices(Path);
+        for (int32 Index = 0; Index < Path.NumVertices; ++Index)
+        {
+            FSoundPathNode& Node = SoundPath.Nodes.AddDefaulted_GetRef();
+            Node.Position = FFrequenSeeWorldScene::ToVector(Vertices[Index].Position);
+            Node.Normal = FFrequenSeeWorldScene::ToVector(Vertices[Index].Normal);
+            Node.Probability = Vertices[Index].Probability;
+        }
+        if (Path.NumForwardVertices > 0)
+        {
+            SoundPath.ForwardConnectionPos = SoundPath.Nodes[Path.NumForwardVertices - 1].Position;
+            SoundPath.BackwardConnectionPos = SoundPath.Nodes[Path.NumForwardVertices].Position;
+        }
+
+        const FrequenSeeCore::FPathEnergy Energy = FrequenSeeCore::EvaluatePath(MakeTracerSettings(), Vertices, Path.NumVertices, Path.NumForwardVertices);
+        SoundPath.TotalLength = Energy.TotalLength;
+        SoundPath.EnergyContribution = Energy.Gain;
+        return SoundPath;
+    }
+}
 
 float AverageArray(const TArray<float>& Values)
 {
@@ -38,13 +153,17 @@ void UAudioRayTracingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 void UAudioRayTracingSubsystem::Deinitialize()
 {
     Super::Deinitialize();
+    // The world's sources have handed their buffers back by now; don't keep them cached across worlds
+    FFrequenSeeSlabPool::Get().Trim();
     UE_LOG(LogTemp, Warning, TEXT("Deinitializing."));
 }
 
 
 void UAudioRayTracingSubsystem::RegisterSource(UFrequenSeeAudioComponent* InComp)
 {
-    ActiveSources.Add({ InComp });
+    FActiveSource& Src = ActiveSources.Add_GetRef({ InComp, GetTypeHash(InComp->GetPathName()) });
+    // Spreads the first updates over an interval, so sources registered together don't all trace on the same tick
+    Src.TimeUntilUpdate = InComp->RaycastInterval * static_cast<float>(Src.SeedKey % 1024) / 1024.0f;
 }
 
 void UAudioRayTracingSubsystem::UnRegisterSource(UFrequenSeeAudioComponent* InComp)
@@ -54,6 +173,9 @@ void UAudioRayTracingSubsystem::UnRegisterSource(UFrequenSeeAudioComponent* InCo
 
 void UAudioRayTracingSubsystem::Tick(float DeltaTime)
 {
+    // Impulse responses the audio thread let go of are freed here rather than on the audio thread
+    FFrequenSeeSourceRegistry::Get().CollectRetiredImpulseResponses();
+
     static float TimeBeforeFirstTick = 1.0f;
     if (TimeBeforeFirstTick >= 0.0f)
     {
@@ -81,9 +203,154 @@ void UAudioRayTracingSubsystem::Tick(float DeltaTime)
         if (!PlayerPawn.IsValid()) return; // still not spawned – just wait until next tick
     }
 
+    UpdateReverbLOD();
     UpdateSources(DeltaTime);
 }
 
+void UAudioRayTracingSubsystem::UpdateReverbLOD()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::UpdateReverbLOD);
+    const FVector ListenerLocation = PlayerPawn->GetActorLocation();
+    const float MaxDistanceSquared = FMath::Square(CVarConvolutionMaxDistance.GetValueOnGameThread());
+    const bool bListenerBus = CVarListenerBus.GetValueOnGameThread() != 0;
+
+    // Rank by how loud the reverb is at the listener: the traced IR energy already includes the distance falloff
+    TArray<TPair<float, UFrequenSeeAudioComponent*>, TInlineAllocator<32>> Candidates;
+    for (const FActiveSource& Src : ActiveSources)
+    {
+        UFrequenSeeAudioComponent* Comp = Src.AudioComp.Get();
+        if (!Comp) continue;
+        Comp->bUseConvolutionReverb = false;
+        Comp->ReverbCluster = INDEX_NONE;
+        if (Comp->IsPlaying() && (bListenerBus || FVector::DistSquared(Comp->GetComponentLocation(), ListenerLocation) <= MaxDistanceSquared))
+        {
+            const float Loudness = FMath::Square(Comp->VolumeMultiplier) * Comp->GetLateReverbEnergy();
+            Candidates.Emplace(Loudness, Comp);
+        }
+    }
+
+    Candidates.Sort([](const TPair<float, UFrequenSeeAudioComponent*>& A, const TPair<float, UFrequenSeeAudioComponent*>& B)
+    {
+        return A.Key > B.Key;
+    });
+    // The callback governor takes convolutions away first when the audio thread runs out of time
+    const FFrequenSeeCallbackMonitor& CallbackMonitor = FFrequenSeeCallbackMonitor::Get();
+    const int32 MaxConvolutions = CallbackMonitor.LimitConvolutionSources(FMath::Max(CVarMaxConvolutionSources.GetValueOnGameThread(), 0));
+
+    FFrequenSeeReverbClusters Clusters;
+    ReverbClusterRepresentatives.SetNum(FFrequenSeeReverbClusters::MaxClusters);
+    if (!bListenerBus && CVarReverbClustering.GetValueOnGameThread() == 0)
+    {
+        const int32 NumConvolved = FMath::Min(Candidates.Num(), MaxConvolutions);
+        for (int32 Index = 0; Index < NumConvolved; ++Index)
+        {
+            Candidates[Index].Value->bUseConvolutionReverb = true;
+        }
+        for (TWeakObjectPtr<UFrequenSeeAudioComponent>& Representative : ReverbClusterRepresentatives)
+        {
+            Representative.Reset();
+        }
+        FFrequenSeeSourceRegistry::Get().PublishReverbClusters(Clusters);
+        return;
+    }
+
+    // The listener bus is a single cluster everyone joins. Its IR follows the loudest source, with 3 dB of hysteresis
+    // so two equally loud sources don't keep swapping it
+    if (bListenerBus && Candidates.Num() > 0)
+    {
+        const int32 Current = Candidates.IndexOfByPredicate([this](const TPair<float, UFrequenSeeAudioComponent*>& Candidate)
+        {
+            return ReverbClusterRepresentatives[0] == Candidate.Value;
+        });
+        if (Current != INDEX_NONE && Candidates[0].Key > 2.0f * Candidates[Current].Key)
+        {
+            ReverbClusterRepresentatives[0].Reset();
+        }
+    }
+
+    // Keep last tick's representatives that are still candidates, loudest first, so cluster IRs stay put
+    const int32 MaxClusters = bListenerBus ? CallbackMonitor.LimitConvolutionSources(1) : FMath::Min(MaxConvolutions, FFrequenSeeReverbClusters::MaxClusters);
+    int32 NumClusters = 0;
+    bool bKeptSlot[FFrequenSeeReverbClusters::MaxClusters] = {};
+    for (const TPair<float, UFrequenSeeAudioComponent*>& Candidate : Candidates)
+    {
+        const int32 Slot = ReverbClusterRepresentatives.IndexOfByKey(Candidate.Value);
+        if (Slot != INDEX_NONE && NumClusters < MaxClusters && Candidate.Key > 0.0f)
+        {
+            Candidate.Value->ReverbCluster = Slot;
+            bKeptSlot[Slot] = true;
+            ++NumClusters;
+        }
+    }
+    for (int32 Slot = 0; Slot < ReverbClusterRepresentatives.Num(); ++Slot)
+    {
+        if (!bKeptSlot[Slot])
+        {
+            ReverbClusterRepresentatives[Slot].Reset();
+        }
+    }
+
+    // Everyone else joins the most similar cluster, opens a new one while the budget lasts, or falls back to the FDN
+    const float ThresholdDb = bListenerBus ? MAX_flt : CVarClusterThresholdDb.GetValueOnGameThread();
+    for (const TPair<float, UFrequenSeeAudioComponent*>& Candidate : Candidates)
+    {
+        UFrequenSeeAudioComponent* Comp = Candidate.Value;
+        if (Comp->ReverbCluster != INDEX_NONE || Candidate.Key <= 0.0f)
+        {
+            continue;
+        }
+
+        int32 BestSlot = INDEX_NONE;
+        float BestDistance = ThresholdDb;
+        int32 FreeSlot = INDEX_NONE;
+        for (int32 Slot = 0; Slot < ReverbClusterRepresentatives.Num(); ++Slot)
+        {
+            const UFrequenSeeAudioComponent* Representative = ReverbClusterRepresentatives[Slot].Get();
+            if (!Representative)
+            {
+                FreeSlot = FreeSlot == INDEX_NONE ? Slot : FreeSlot;
+                continue;
+            }
+            const float Distance = FrequenSeeDecay::ProfileDistanceDb(Comp->GetReverbProfile(), Representative->GetReverbProfile(),
+                                                                      UFrequenSeeAudioComponent::ReverbProfilePoints);
+            if (Distance <= BestDistance)
+            {
+                BestSlot = Slot;
+                BestDistance = Distance;
+            }
+        }
+
+        if (BestSlot == INDEX_NONE && FreeSlot != INDEX_NONE && NumClusters < MaxClusters)
+        {
+            ReverbClusterRepresentatives[FreeSlot] = Comp;
+            BestSlot = FreeSlot;
+            ++NumClusters;
+        }
+        Comp->ReverbCluster = BestSlot;
+    }
+
+    // Members reuse the representative's IR scaled to their own level; energies are sums of squares, so amplitude is
+    // their square root
+    for (const TPair<float, UFrequenSeeAudioComponent*>& Candidate : Candidates)
+    {
+        UFrequenSeeAudioComponent* Comp = Candidate.Value;
+        if (Comp->ReverbCluster == INDEX_NONE)
+        {
+            continue;
+        }
+        const UFrequenSeeAudioComponent* Representative = ReverbClusterRepresentatives[Comp->ReverbCluster].Get();
+        Comp->bUseConvolutionReverb = true;
+        Comp->ReverbClusterGain = FMath::Sqrt(Comp->GetLateReverbEnergy() / Representative->GetLateReverbEnergy());
+    }
+
+    for (int32 Slot = 0; Slot < ReverbClusterRepresentatives.Num(); ++Slot)
+    {
+        const UFrequenSeeAudioComponent* Representative = ReverbClusterRepresentatives[Slot].Get();
+        Clusters.RepresentativeIds[Slot] = Representative ? Representative->GetAudioComponentID() : 0;
+    }
+    FFrequenSeeSourceRegistry::Get().PublishReverbClusters(Clusters);
+}
+
 void UAudioRayTracingSubsystem::TraceAndApply(FAudioDevice* /*Device*/, const FVector& Listener, const FActiveSource& Src) const
 {
     if (!Src.AudioComp.IsValid()) return;
@@ -99,6 +366,13 @@ void UAudioRayTracingSubsystem::TraceAndApply(FAudioDevice* /*Device*/, const FV
 
 void UAudioRayTracingSubsystem::UpdateSources(float DeltaTime, bool bForceUpdate)
 {
+    // Traces on worker threads look materials up here instead of in the components
+    if (!SurfaceCache)
+    {
+        SurfaceCache = MakeShared<FFrequenSeeSurfaceCache>();
+    }
+    SurfaceCache->Update(Geometry);
+
     if (TickVisualization)
     {
         if (VisualizeTimer <= 0.0f)
@@ -116,40 +390,211 @@ void UAudioRayTracingSubsystem::UpdateSources(float DeltaTime, bool bForceUpdate
             VisualizeTimer -= DeltaTime;
         }
     }
-    if (bForceUpdate)
+
+    const bool bOcclusionOnly = CVarOcclusionOnly.GetValueOnGameThread() != 0;
+    TArray<FActiveSource*, TInlineAllocator<32>> DueSources;
+    for (FActiveSource& Src : ActiveSources)
     {
-        for (FActiveSource& Src : ActiveSources)
+        const UFrequenSeeAudioComponent* Comp = Src.AudioComp.Get();
+        if (!Comp) continue;
+
+        Src.TimeUntilUpdate -= DeltaTime;
+        if (bForceUpdate || Src.TimeUntilUpdate <= 0.0f)
         {
-            UpdateSource(Src);
+            // Keeps the cadence when ticks don't divide the interval, without catching up on missed updates after a hitch
+            Src.TimeUntilUpdate = FMath::Max(Src.TimeUntilUpdate + Comp->RaycastInterval, 0.0f);
+            if (!bOcclusionOnly && !Comp->bOcclusionOnly)
+            {
+                UpdateSource(Src);
+            }
+            DueSources.Add(&Src);
+        }
+    }
+    UpdateOcclusion(DueSources);
+
+    for (FActiveSource& Src : ActiveSources)
+    {
+        if (UFrequenSeeAudioComponent* Comp = Src.AudioComp.Get())
+        {
+            Comp->PublishOcclusion();
         }
     }
 }
 
+void UAudioRayTracingSubsystem::UpdateOcclusion(TArrayView<FActiveSource* const> Sources)
+{
+    SCOPE_CYCLE_COUNTER(STAT_FrequenSee_Occlusion);
+
+    const APawn* Listener = PlayerPawn.Get();
+    const UWorld* World = GetWorld();
+    if (!Listener || !World || Sources.Num() == 0) return;
+
+    struct FOcclusionRay
+    {
+        FVector Start;
+        const AActor* SourceActor = nullptr;
+        bool bBlocked = false;
+        float Transmission[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+    };
+
+    FMemMark Mark(FMemStack::Get());
+    const int32 RaysPerSource = 1 + FMath::Max(CVarOcclusionJitterRays.GetValueOnGameThread(), 0);
+    const float JitterRadius = FMath::Max(CVarOcclusionJitterRadius.GetValueOnGameThread(), 0.0f);
+    const FVector ListenerLocation = Listener->GetActorLocation();
+    TArray<FOcclusionRay, TMemStackAllocator<>> Rays;
+    Rays.SetNum(Sources.Num() * RaysPerSource);
+    for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+    {
+        const UFrequenSeeAudioComponent* Comp = Sources[SourceIndex]->AudioComp.Get();
+        const FVector SourceLocation = Comp->GetComponentLocation();
+        // The same points every update, so the occlusion of a source at rest does not flicker
+        FrequenSeeCore::FRandom Random(Sources[SourceIndex]->SeedKey);
+        for (int32 Ray = 0; Ray < RaysPerSource; ++Ray)
+        {
+            FOcclusionRay& OcclusionRay = Rays[SourceIndex * RaysPerSource + Ray];
+            OcclusionRay.Start = Ray == 0 ? SourceLocation : SourceLocation + FFrequenSeeWorldScene::ToVector(Random.UnitVector()) * JitterRadius;
+            OcclusionRay.SourceActor = Comp->GetOwner();
+        }
+    }
+
+    FCollisionObjectQueryParams ObjectParams;
+    ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+    ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+    ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+    const FFrequenSeeSurfaceCache& Surfaces = *SurfaceCache;
+    FFrequenSeeAcousticSurface FallbackSurface;
+    FallbackSurface.SetMaterial(DefaultMaterial);
+
+    auto TraceRay = [&](FOcclusionRay& Ray)
+    {
+        FCollisionQueryParams QueryParams(TEXT("AudioOcclusion"), /*bTraceComplex*/ false);
+        QueryParams.AddIgnoredActor(Ray.SourceActor);
+        QueryParams.AddIgnoredActor(Listener);
+        TArray<FHitResult> Entries;
+        World->LineTraceMultiByObjectType(Entries, Ray.Start, ListenerLocation, ObjectParams, QueryParams);
+        if (Entries.Num() == 0)
+        {
+            return;
+        }
+        // Back from the listener the same blockers show their far sides
+        TArray<FHitResult> Exits;
+        World->LineTraceMultiByObjectType(Exits, ListenerLocation, Ray.Start, ObjectParams, QueryParams);
+        Ray.bBlocked = true;
+
+        const float Length = FVector::Distance(Ray.Start, ListenerLocation);
+        auto AddBlocker = [&Ray, &Surfaces, &FallbackSurface](const FHitResult& Hit, float CrossedCm)
+        {
+            const FFrequenSeeAcousticSurface* Surface = Surfaces.Find(Hit.GetActor());
+            const FFrequenSeeAcousticSurface& Blocker = Surface && Surface->bHasMaterial ? *Surface : FallbackSurface;
+            const float Layers = Blocker.ThicknessCm > 0.0f ? CrossedCm / Blocker.ThicknessCm : 1.0f;
+            for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+            {
+                Ray.Transmission[Band] *= FMath::Pow(Blocker.Transmission[Band], Layers);
+            }
+        };
+        // A blocker hit only going in encloses the listener, one hit only coming back encloses the start
+        for (const FHitResult& Entry : Entries)
+        {
+            const FHitResult* Exit = Exits.FindByPredicate([&Entry](const FHitResult& Hit) { return Hit.GetComponent() == Entry.GetComponent(); });
+            AddBlocker(Entry, FMath::Max((Exit ? Length - Exit->Distance : Length) - Entry.Distance, 0.0f));
+        }
+        for (const FHitResult& Exit : Exits)
+        {
+            if (!Entries.ContainsByPredicate([&Exit](const FHitResult& Hit) { return Hit.GetComponent() == Exit.GetComponent(); }))
+            {
+                AddBlocker(Exit, FMath::Max(Length - Exit.Distance, 0.0f));
+            }
+        }
+    };
+
+    // The game thread waits for the tasks, so nothing moves the world while they query it
+    if (CVarTraceParallel.GetValueOnGameThread() != 0 && Rays.Num() > 1)
+    {
+        ParallelFor(Rays.Num(), [&Rays, &TraceRay](int32 Index) { TraceRay(Rays[Index]); });
+    }
+    else
+    {
+        for (FOcclusionRay& Ray : Rays)
+        {
+            TraceRay(Ray);
+        }
+    }
+
+    int32 NumLineTraces = Rays.Num();
+    for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+    {
+        int32 NumBlocked = 0;
+        float BlockedTransmission[AcousticBandCount] = {};
+        for (int32 Ray = 0; Ray < RaysPerSource; ++Ray)
+        {
+            const FOcclusionRay& OcclusionRay = Rays[SourceIndex * RaysPerSource + Ray];
+            if (OcclusionRay.bBlocked)
+            {
+                ++NumBlocked;
+                for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+                {
+                    BlockedTransmission[Band] += OcclusionRay.Transmission[Band];
+                }
+            }
+        }
+        NumLineTraces += NumBlocked;
+
+        UFrequenSeeAudioComponent* Comp = Sources[SourceIndex]->AudioComp.Get();
+        Comp->OcclusionAttenuation = static_cast<float>(RaysPerSource - NumBlocked) / static_cast<float>(RaysPerSource);
+        for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+        {
+            Comp->OcclusionTransmission[Band] = NumBlocked > 0 ? BlockedTransmission[Band] / static_cast<float>(NumBlocked) : 0.0f;
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_FrequenSee_RaysTraced, NumLineTraces);
+}
+
 void UAudioRayTracingSubsystem::UpdateSource(FActiveSource& Src)
 {
+    SCOPE_CYCLE_COUNTER(STAT_FrequenSee_UpdateSource);
+
     // Visualize a few rays
-    Visualize(Src);
+    if (DEBUG_RAY_COUNT > 0)
+    {
+        Visualize(Src);
+    }
+
+    // Per-trace results live in the thread's frame arena and go away with the mark; the paths go to TraceScratch
+    FMemMark Mark(FMemStack::Get());
+
+    // With the early specular reflections exact, the tracer only has the scattered energy left and needs fewer rays
+    const int32 ImageSourceOrder = FMath::Clamp(CVarImageSourceOrder.GetValueOnGameThread(), 0, 3);
+    const bool bImageSources = ImageSourceOrder > 0 && UpdateImageSources(Src, ImageSourceOrder);
+    const int32 NumRays = bImageSources
+        ? FMath::Max(1, FMath::RoundToInt32(USED_RAY_COUNT * FMath::Clamp(CVarImageSourceRayScale.GetValueOnGameThread(), 0.0f, 1.0f)))
+        : USED_RAY_COUNT;
 
     // Cast a lot more to update impulse response
-    TArray<FSoundPath> ForwardPaths;
-    TArray<FSoundPath> BackwardPaths;
-    TArray<FSoundPath> ConnectedPaths;
+    TraceScratch.Reset();
+    GenerateFullPaths(Src, TraceScratch, NumRays);
+    ++Src.NumTraces;
 
-    GenerateFullPaths(Src, ForwardPaths, BackwardPaths, ConnectedPaths);
-        
-    for (FSoundPath& Path : ForwardPaths)
+    FrequenSeeCore::FTracerSettings TracerSettings = MakeTracerSettings();
+    TracerSettings.ImageSourceOrder = bImageSources ? ImageSourceOrder : 0;
+    TArray<FPathEnergyResult, TMemStackAllocator<>> EnergyResults;
     {
-        EvaluatePath(Path);
-    }
-            
-    for (FSoundPath& Path : BackwardPaths)
-    {
-        EvaluatePath(Path);
+        SCOPE_CYCLE_COUNTER(STAT_FrequenSee_EvaluatePaths);
+        EnergyResults.Reserve(static_cast<int32>(TraceScratch.ConnectedPaths.size()));
+        for (const FrequenSeeCore::FPathRange& Path : TraceScratch.ConnectedPaths)
+        {
+            EnergyResults.Add(ToEnergyResult(FrequenSeeCore::EvaluatePath(TracerSettings, TraceScratch.GetVertices(Path), Path.NumVertices, Path.NumForwardVertices)));
+        }
     }
-    TArray<FPathEnergyResult> EnergyResults;
-    for (FSoundPath& Path : ConnectedPaths)
+    // Normalize energy values based on total num rays
+    float NormalizationFactor = 1.0f / (float) NumRays;
+    if (bImageSources)
     {
-        EnergyResults.Add(EvaluatePath(Path));
+        // Exact arrivals rather than estimates, so weighted as if every ray had found them
+        for (const FrequenSeeCore::FPathEnergy& Path : Src.ImageSources->GetPaths())
+        {
+            FPathEnergyResult& Result = EnergyResults.Add_GetRef(ToEnergyResult(Path));
+            Result.Gain /= NormalizationFactor;
+        }
     }
 
     // Place energy of connected paths into bins in Src's energy buffer
@@ -159,18 +604,56 @@ void UAudioRayTracingSubsystem::UpdateSource(FActiveSource& Src)
         Src.AudioComp->FlushEnergyBuffer();
                     
     }
-    // Place energy values
-    // Normalize energy values based on total num rays
-    float NormalizationFactor = 1.0f / (float) USED_RAY_COUNT;
-    for (FPathEnergyResult& Result : EnergyResults)
+    // The strongest low-order early arrivals are rendered as sample-accurate taps and kept out of the histogram
+    TBitArray<TMemStackAllocator<>> IsReflectionTap;
+    TArray<FAudioOcclusionParams::FEarlyReflectionTap, TMemStackAllocator<>> ReflectionTaps;
+    ExtractReflectionTaps(EnergyResults, NormalizationFactor, ReflectionTaps, IsReflectionTap);
+    if (Src.AudioComp.IsValid())
     {
-        if (Src.AudioComp.IsValid())
+        Src.AudioComp->SetReflectionTaps(ReflectionTaps);
+    }
+
+    for (int32 ResultIndex = 0; ResultIndex < EnergyResults.Num(); ++ResultIndex)
+    {
+        const FPathEnergyResult& Result = EnergyResults[ResultIndex];
+        if (Src.AudioComp.IsValid() && !IsReflectionTap[ResultIndex])
         {
             float Energy = Result.Gain;
             Energy *= NormalizationFactor;
-            Src.AudioComp->AddEnergyAtDelay(Result.DelaySeconds, Energy);
+            Src.AudioComp->AddEnergyAtDelay(Result.DelaySeconds, Energy, Result.BandReflectance, Result.Direction);
         }
     }
+    if (Src.AudioComp.IsValid())
+    {
+        Src.AudioComp->BuildEnergyHistograms();
+    }
+    // Energy-weighted spectral tilt of the materials the paths bounced off; the reverb folds it into the IR spectrum
+    if (Src.AudioComp.IsValid())
+    {
+        float BandEnergy[AcousticBandCount] = {};
+        for (const FPathEnergyResult& Result : EnergyResults)
+        {
+            for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+            {
+                BandEnergy[Band] += Result.Gain * Result.BandReflectance[Band];
+            }
+        }
+        float MaxBandEnergy = 0.0f;
+        for (float Value : BandEnergy)
+        {
+            MaxBandEnergy = FMath::Max(MaxBandEnergy, Value);
+        }
+        if (MaxBandEnergy > 0.0f)
+        {
+            // Relative to the strongest band: the broadband level already comes from the energy histogram
+            for (float& Value : BandEnergy)
+            {
+                Value /= MaxBandEnergy;
+            }
+            Src.AudioComp->SetMaterialBandResponse(BandEnergy);
+        }
+    }
+
     // Log contents of Src.AudioComp's EnergyBuffer 
     if (Src.AudioComp.IsValid())
     {
@@ -188,8 +671,8 @@ void UAudioRayTracingSubsystem::UpdateSource(FActiveSource& Src)
     // Update impulse response of audio component
     if (Src.AudioComp.IsValid())
     {
-        Src.AudioComp->FlushEnergyBuffer();
         Src.AudioComp->ReconstructImpulseResponse();
+        Src.AudioComp->FitLateReverb();
     }
     
 }
@@ -198,8 +681,12 @@ void UAudioRayTracingSubsystem::UpdateSource(FActiveSource& Src)
 /** -------------------------- BIDIRECTIONAL PATH TRACING --------------------------- */
 
 
-void UAudioRayTracingSubsystem::GenerateFullPaths(const FActiveSource& Src, TArray<FSoundPath>& ForwardPathsOut, TArray<FSoundPath>& BackwardPathsOut, TArray<FSoundPath>& ConnectedPathsOut, int NumRays)
+void UAudioRayTracingSubsystem::GenerateFullPaths(const FActiveSource& Src, FrequenSeeCore::FPathBatch& OutPaths, int NumRays)
 {
+    // Rays per worker task; large enough that appending the chunks costs next to nothing next to tracing them
+    constexpr int32 RaysPerChunk = 128;
+
+    SCOPE_CYCLE_COUNTER(STAT_FrequenSee_TracePaths);
 
     APawn* Listener = PlayerPawn.Get();
     if (!Listener)
@@ -208,28 +695,130 @@ void UAudioRayTracingSubsystem::GenerateFullPaths(const FActiveSource& Src, TArr
         return;
     }
 
-    AActor* PlayerPtr = PlayerPawn.Get();
-    ForwardPathsOut.Reserve(NumRays);
-    BackwardPathsOut.Reserve(NumRays);
-    ConnectedPathsOut.Reserve(NumRays); 
-    for (int i = 0; i < NumRays; ++i)
+    const AActor* SourceActor = Src.AudioComp->GetOwner();
+    const FrequenSeeCore::FVec3 SourcePosition = FFrequenSeeWorldScene::ToCore(SourceActor->GetActorLocation());
+    const FrequenSeeCore::FVec3 ListenerPosition = FFrequenSeeWorldScene::ToCore(Listener->GetActorLocation());
+    FrequenSeeCore::FTracerSettings Settings = MakeTracerSettings();
+    Settings.NumRays = NumRays;
+    // Still a new trace every update, but the same one for the same seed, source and update
+    const uint64 SeedKey = static_cast<uint64>(static_cast<uint32>(CVarTraceSeed.GetValueOnGameThread())) << 32 | Src.SeedKey;
+    const uint64 Seed = static_cast<uint64>(FrequenSeeCore::HashSeed(SeedKey)) << 32 | Src.NumTraces;
+    const int32 AttemptsBefore = OutPaths.NumConnectionAttempts;
+    const int32 ConnectedBefore = static_cast<int32>(OutPaths.ConnectedPaths.size());
+
+    int32 NumLineTraces = 0;
+    const int32 NumChunks = FMath::DivideAndRoundUp(FMath::Max(NumRays, 0), RaysPerChunk);
+    if (CVarTraceParallel.GetValueOnGameThread() != 0 && NumChunks > 1)
     {
-        // Create and add forward path
-        FSoundPath ForwardPath;
-        GeneratePath(Src.AudioComp->GetOwner(), ForwardPath);
-        ForwardPathsOut.Add(ForwardPath);
+        // The game thread waits for the tasks, so nothing moves the world while they query it
+        TraceChunkScratch.SetNum(FMath::Max(TraceChunkScratch.Num(), NumChunks));
+        TArray<int32, TInlineAllocator<16>> ChunkLineTraces;
+        ChunkLineTraces.SetNumZeroed(NumChunks);
+        // Built here, where its ignore lists may look at the actors; each task traces through its own copy
+        const FFrequenSeeWorldScene ChunkScene(GetWorld(), SurfaceCache.Get(), SourceActor, Listener);
+        ParallelFor(NumChunks, [&](int32 Chunk)
+        {
+            const FFrequenSeeWorldScene Scene(ChunkScene);
+            const int32 FirstRay = Chunk * RaysPerChunk;
+            TraceChunkScratch[Chunk].Reset();
+            FrequenSeeCore::TraceRays(Scene, Settings, SourcePosition, ListenerPosition, Seed, FirstRay,
+                                      FMath::Min(RaysPerChunk, NumRays - FirstRay), TraceChunkScratch[Chunk]);
+            ChunkLineTraces[Chunk] = Scene.GetNumLineTraces();
+        });
+        for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+        {
+            FrequenSeeCore::AppendPaths(TraceChunkScratch[Chunk], OutPaths);
+            NumLineTraces += ChunkLineTraces[Chunk];
+        }
+    }
+    else
+    {
+        const FFrequenSeeWorldScene Scene(GetWorld(), SurfaceCache.Get(), SourceActor, Listener);
+        FrequenSeeCore::TracePaths(Scene, Settings, SourcePosition, ListenerPosition, Seed, OutPaths);
+        NumLineTraces = Scene.GetNumLineTraces();
+    }
 
-        // Create and add backward path
-        FSoundPath BackwardPath;
-        GeneratePath(PlayerPtr, BackwardPath);
-        BackwardPathsOut.Add(BackwardPath);
+    INC_DWORD_STAT_BY(STAT_FrequenSee_RaysTraced, NumLineTraces);
+    INC_DWORD_STAT_BY(STAT_FrequenSee_ConnectionsAttempted, OutPaths.NumConnectionAttempts - AttemptsBefore);
+    INC_DWORD_STAT_BY(STAT_FrequenSee_ConnectionsSucceeded, static_cast<int32>(OutPaths.ConnectedPaths.size()) - ConnectedBefore);
+}
+
+void UAudioRayTracingSubsystem::GatherReflectors(std::vector<FrequenSeeCore::FReflector>& OutReflectors) const
+{
+    // Corners of the bounds' faces, bit 0 of an index picking max X, bit 1 max Y and bit 2 max Z, wound so the
+    // normal points out
+    static constexpr int32 FaceCorners[6][4] = {
+        { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 2, 3, 1 }, { 4, 5, 7, 6 },
+    };
+
+    OutReflectors.clear();
+    for (const TWeakObjectPtr<UAcousticGeometryComponent>& Component : Geometry)
+    {
+        const AActor* Owner = Component.IsValid() ? Component->GetOwner() : nullptr;
+        const UStaticMeshComponent* Mesh = Owner ? Owner->FindComponentByClass<UStaticMeshComponent>() : nullptr;
+        if (!Mesh || !Mesh->GetStaticMesh())
+        {
+            continue;
+        }
+
+        const FBox Bounds = Mesh->GetStaticMesh()->GetBoundingBox();
+        const FTransform& Transform = Mesh->GetComponentTransform();
+        FrequenSeeCore::FVec3 Corners[8];
+        for (int32 Corner = 0; Corner < 8; ++Corner)
+        {
+            const FVector Local((Corner & 1) ? Bounds.Max.X : Bounds.Min.X, (Corner & 2) ? Bounds.Max.Y : Bounds.Min.Y, (Corner & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+            Corners[Corner] = FFrequenSeeWorldScene::ToCore(Transform.TransformPosition(Local));
+        }
+        for (const int32 (&Face)[4] : FaceCorners)
+        {
+            const FrequenSeeCore::FVec3 Normal = FrequenSeeCore::Cross(Corners[Face[1]] - Corners[Face[0]], Corners[Face[3]] - Corners[Face[0]]).GetSafeNormal();
+            if (Normal.IsNearlyZero())
+            {
+                continue;
+            }
+            FrequenSeeCore::FReflector& Reflector = OutReflectors.emplace_back();
+            // A negative determinant (mirrored scale) turns the winding inside out
+            Reflector.Normal = Transform.GetDeterminant() < 0.0f ? -Normal : Normal;
+            Reflector.Distance = FrequenSeeCore::Dot(Reflector.Normal, Corners[Face[0]]);
+            Reflector.bTwoSided = false;
+            Reflector.Vertices = { Corners[Face[0]], Corners[Face[1]], Corners[Face[2]], Corners[Face[3]] };
+        }
+    }
+}
+
+bool UAudioRayTracingSubsystem::UpdateImageSources(FActiveSource& Src, int32 MaxOrder)
+{
+    SCOPE_CYCLE_COUNTER(STAT_FrequenSee_ImageSources);
+
+    const APawn* Listener = PlayerPawn.Get();
+    const AActor* SourceActor = Src.AudioComp.IsValid() ? Src.AudioComp->GetOwner() : nullptr;
+    if (!Listener || !SourceActor)
+    {
+        return false;
+    }
 
-        // Attempt connection, add if valid
-        if (FSoundPath ConnectedPath; ConnectSubpaths(ForwardPath, BackwardPath, ConnectedPath))
-            ConnectedPathsOut.Add(ConnectedPath);
+    if (!Src.ImageSources)
+    {
+        Src.ImageSources = MakeShared<FrequenSeeCore::FImageSourceSolver>();
     }
-    // Print the number of connected paths
-    UE_LOG(LogTemp, Warning, TEXT("%d paths connected out of %d"), ConnectedPathsOut.Num(), USED_RAY_COUNT);
+    GatherReflectors(ReflectorScratch);
+    Src.ImageSources->SetReflectors(ReflectorScratch);
+
+    FrequenSeeCore::FImageSourceSettings Settings;
+    Settings.MaxOrder = MaxOrder;
+    const FFrequenSeeWorldScene Scene(GetWorld(), SurfaceCache.Get(), SourceActor, Listener);
+    Src.ImageSources->Update(Scene, FrequenSeeCore::FTracerSettings(), Settings, FFrequenSeeWorldScene::ToCore(SourceActor->GetActorLocation()),
+                             FFrequenSeeWorldScene::ToCore(Listener->GetActorLocation()));
+    INC_DWORD_STAT_BY(STAT_FrequenSee_RaysTraced, Scene.GetNumLineTraces());
+    return true;
+}
+
+bool UAudioRayTracingSubsystem::CanConnect(const FVector& ForwardEnd, const FVector& BackwardEnd) const
+{
+    // Stops just short of the backward end, which sits right off a surface
+    const FrequenSeeCore::FTracerSettings Settings;
+    const FVector ConnectionEnd = BackwardEnd - Settings.SurfaceOffset * (BackwardEnd - ForwardEnd).GetSafeNormal();
+    return FFrequenSeeWorldScene(GetWorld(), SurfaceCache.Get()).IsVisible(FFrequenSeeWorldScene::ToCore(ForwardEnd), FFrequenSeeWorldScene::ToCore(ConnectionEnd));
 }
 
 bool UAudioRayTracingSubsystem::ConnectSubpaths(FSoundPath& ForwardPath, FSoundPath& BackwardPath, FSoundPath& OutPath)
@@ -239,19 +828,7 @@ bool UAudioRayTracingSubsystem::ConnectSubpaths(FSoundPath& ForwardPath, FSoundP
     FSoundPathNode& BackwardLastNode = BackwardPath.Nodes.Last();
 
     // RAYCAST BETWEEN LAST NODES
-    // Collide with various channels
-    FCollisionObjectQueryParams ObjectParams;
-    ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-    ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic); // covers walls/floors
-    ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic); // covers dynamic props
-
-    // Store hit result
-    FHitResult H;
-
-    // Raycast in chosen direction -- CHECK IF IT **DOESN'T** HIT
-    if (not GetWorld()->LineTraceSingleByObjectType(
-        H, ForwardLastNode.Position, BackwardLastNode.Position - 0.1f * (BackwardLastNode.Position - ForwardLastNode.Position).GetSafeNormal(), ObjectParams
-        ))
+    if (CanConnect(ForwardLastNode.Position, BackwardLastNode.Position))
     {
         // Connect the paths
         
@@ -276,147 +853,58 @@ bool UAudioRayTracingSubsystem::ConnectSubpaths(FSoundPath& ForwardPath, FSoundP
     return false;
 }
 
-void UAudioRayTracingSubsystem::GeneratePath(const AActor* ActorToIgnore, FSoundPath& OutPath) const
+void UAudioRayTracingSubsystem::ExtractReflectionTaps(TArrayView<const FPathEnergyResult> EnergyResults, float NormalizationFactor,
+                                                      TArray<FAudioOcclusionParams::FEarlyReflectionTap, TMemStackAllocator<>>& OutTaps,
+                                                      TBitArray<TMemStackAllocator<>>& OutIsTap)
 {
-    // Chance for a path to NOT terminate
-    constexpr float RUSSIAN_ROULETTE_PROB = 0.9f;
-    // Maximum distance of a single raycast
-    constexpr float MAX_RAYCAST_DIST = 1000000.f;
+    TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::ExtractReflectionTaps);
+    OutIsTap.Init(false, EnergyResults.Num());
+    OutTaps.Reset();
 
-    // State variables
-    FVector CurrentPos = ActorToIgnore->GetActorLocation();
-    auto Mesh = ActorToIgnore->GetComponentByClass<UStaticMeshComponent>();
-    FVector CurrentNormal = FVector::ZeroVector;
-    auto CurrentMaterial = TWeakObjectPtr<UAcousticGeometryComponent>(nullptr);
-    float CurrentProbability = 1.0f;
-    
-    // REPEAT:  
-    while (true)
+    TArray<int32, TMemStackAllocator<>> Candidates;
+    for (int32 Index = 0; Index < EnergyResults.Num(); ++Index)
     {
-        // 0. Add current position as a node in the path
-        FSoundPathNode Node(CurrentPos, CurrentNormal, CurrentMaterial, CurrentProbability);
-        OutPath.Nodes.Add(Node);
-        
-        // 1. Check russian roulette probability -- if successful:
-        float RussianRoulette = FMath::FRand();
-        if (RussianRoulette < RUSSIAN_ROULETTE_PROB)
+        const FPathEnergyResult& Result = EnergyResults[Index];
+        if (Result.bDeterministic && Result.ReflectionOrder >= 1 && Result.ReflectionOrder <= FAudioOcclusionParams::MaxReflectionTapOrder &&
+            Result.DelaySeconds < FAudioOcclusionParams::MaxReflectionTapDelaySeconds && Result.Gain > 0.0f)
         {
-            // 2. Pick a random direction, calculate its probability FIXME assuming diffuse
-            FVector Dir;
-            if (CurrentNormal.IsNearlyZero())
-            {
-                Dir = FMath::VRand();
-                float PDF = 1.0f / (4.0f * PI);
-                CurrentProbability = PDF * RUSSIAN_ROULETTE_PROB;
-            } else
-            {
-                Dir = FMath::VRandCone(CurrentNormal, FMath::DegreesToRadians(90.f));
-                // Probability of an angle out of 2PI steradians (hemisphere)
-                float CosTheta = FVector::DotProduct(Dir, CurrentNormal); // assumed normalized
-                float PDF = CosTheta / PI;
-                CurrentProbability = PDF * RUSSIAN_ROULETTE_PROB;
-            }
-            // 3. Shoot a ray, call GeneratePath recursively at impact point
-
-            // Ignore self
-            FCollisionQueryParams QParams(TEXT("AudioRay"), /*bTraceComplex*/ false);
-            QParams.AddIgnoredActor(ActorToIgnore);
-            if (Mesh)
-            {
-                QParams.AddIgnoredComponent(Mesh);
-            }
-            
-
-            // Collide with various channels
-            FCollisionObjectQueryParams ObjectParams;
-            ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-            ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic); // covers walls/floors
-            ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic); // covers dynamic props
-
-            // Store hit result
-            FHitResult H;
-
-            // Raycast in chosen direction
-            if (GetWorld()->LineTraceSingleByObjectType(
-                H, CurrentPos, CurrentPos + Dir * MAX_RAYCAST_DIST, ObjectParams, QParams
-                ))
-            {
-                // 4. If hit, update current position and normal
-                CurrentPos = H.ImpactPoint + 0.1 * H.ImpactNormal;
-                CurrentNormal = H.ImpactNormal;
-                CurrentMaterial = H.GetActor()->FindComponentByClass<UAcousticGeometryComponent>();
-            }
-        } else
-        {
-            // UE_LOG(LogTemp, Warning, TEXT("Russian roulette failed!"));
-            break; // Failed russian roulette
+            Candidates.Add(Index);
         }
     }
-}
-
+    Candidates.Sort([&EnergyResults](int32 A, int32 B) { return EnergyResults[A].Gain > EnergyResults[B].Gain; });
+    Candidates.SetNum(FMath::Min(Candidates.Num(), FAudioOcclusionParams::MaxReflectionTaps));
 
+    for (int32 Index : Candidates)
+    {
+        // Same energy-to-amplitude mapping as ReconstructImpulseResponse uses for the binned tail
+        const FPathEnergyResult& Result = EnergyResults[Index];
+        FAudioOcclusionParams::FEarlyReflectionTap& Tap = OutTaps.AddDefaulted_GetRef();
+        Tap.DelaySeconds = Result.DelaySeconds;
+        Tap.Gain = FMath::Sqrt(Result.Gain * NormalizationFactor / (4.0f * PI));
+        OutIsTap[Index] = true;
+    }
+}
 
 // Also updates the FSoundPath's TotalLength field based on calculated distance. 
 FPathEnergyResult UAudioRayTracingSubsystem::EvaluatePath(FSoundPath& Path) const
 {
-    constexpr float SoundSpeed = 343.0f;
-    float Distance = 0.0f;
-    float ScaledDistance = 0.0f;
-    float Energy = 1.0f;
-    float Probability = 1.0f;
-    
-    for (int i = 0; i < Path.Nodes.Num() - 1; ++i)
+    TArray<FrequenSeeCore::FPathVertex, TInlineAllocator<32>> Vertices;
+    Vertices.Reserve(Path.Nodes.Num());
+    for (const FSoundPathNode& Node : Path.Nodes)
     {
-        FSoundPathNode& Node = Path.Nodes[i];
-        FSoundPathNode& NextNode = Path.Nodes[i + 1];
-        Distance += FVector::Dist(Node.Position, NextNode.Position);
-        float NodeDistance = FVector::Dist(Node.Position, NextNode.Position) / 1000.f;
-        ScaledDistance += NodeDistance;
-        if (NodeDistance < 1.0f)
-        {
-            continue; // Don't allow glitched collisions in-place to contribute
-        }
-        float NodeDistanceSqr = NodeDistance * NodeDistance;
-        
-        // diffuse = reflectivity / PI, where reflectivity is 0.0-1.0
-        float BSDFFactor = 1.0f;
-        if (Node.Material.IsValid() and Node.Material.Get()->Material)
-        {
-            BSDFFactor = Node.Material.Get()->Material->Absorption[2].Value / PI;
-        }
-        // Multiply cosines of angles , divide by squared distance
-        // float GeometryTerm = (float) FMath::Cos(Node.Normal.X) * FMath::Cos(Node.Normal.X) / FMath::Square(Distance);
-        // FVector Direction = NextNode.Position - Node.Position.GetSafeNormal();
-        
-        float GeometryTerm = 1.0f / (4 * PI * NodeDistanceSqr);
-        Energy *= BSDFFactor;
-        Energy *= GeometryTerm;
-        // Apply media term (equation 3)
-        constexpr float AIR_ABSORPTION_FACTOR = 0.05;
-        float MediaAbsorption = exp(-AIR_ABSORPTION_FACTOR * NodeDistance);
-        Energy *= MediaAbsorption;
-        Energy /= powf(Node.Probability, 0.1);
-        Probability *= Node.Probability;
-        
-        if (Energy > USED_RAY_COUNT)
-        {
-            int j = 1;
-        }
-        // Log Everything
-        
+        FrequenSeeCore::FPathVertex& Vertex = Vertices.AddDefaulted_GetRef();
+        Vertex.Position = FFrequenSeeWorldScene::ToCore(Node.Position);
+        Vertex.Normal = FFrequenSeeWorldScene::ToCore(Node.Normal);
+        Vertex.Surface = FFrequenSeeWorldScene::GetSurfaceResponse(Node.Material.Get());
+        Vertex.Probability = Node.Probability;
     }
 
-    // Clamp energy
-    Energy = FMath::Min(Energy, 1.0f);
-
-    // Un-normalize energy (FIXME)
-    Energy *= 10.f;
-    
-    // Update path values
-    Path.TotalLength = Distance;
-    Path.EnergyContribution = Energy;
-
-    return {ScaledDistance / SoundSpeed, Energy};
+    // The forward subpath ends at the connection; a path that was never connected has no split and carries nothing
+    const int32 NumForwardVertices = Path.Nodes.IndexOfByPredicate([&Path](const FSoundPathNode& Node) { return Node.Position == Path.ForwardConnectionPos; }) + 1;
+    const FrequenSeeCore::FPathEnergy Energy = FrequenSeeCore::EvaluatePath(MakeTracerSettings(), Vertices.GetData(), Vertices.Num(), NumForwardVertices);
+    Path.TotalLength = Energy.TotalLength;
+    Path.EnergyContribution = Energy.Gain;
+    return ToEnergyResult(Energy);
 }
 
 
@@ -424,7 +912,7 @@ FPathEnergyResult UAudioRayTracingSubsystem::EvaluatePath(FSoundPath& Path) cons
 
 
 /** -------------------------- ADDITIONS BY IS --------------------------- */
-void UAudioRayTracingSubsystem::Is_GeneratePath(const AActor* ActorToIgnore, FSoundPath& OutPath, int bounces, bool fwd)
+void UAudioRayTracingSubsystem::Is_GeneratePath(const AActor* ActorToIgnore, FrequenSeeCore::FPathSampler& Sampler, FSoundPath& OutPath, int bounces, bool fwd)
 {
 
     // Maximum distance of a single raycast
@@ -444,16 +932,16 @@ void UAudioRayTracingSubsystem::Is_GeneratePath(const AActor* ActorToIgnore, FSo
         FSoundPathNode Node(CurrentPos, CurrentNormal, CurrentMaterial, CurrentProbability);
         OutPath.Nodes.Add(Node);
         
-            // 1. Pick a random direction, calculate its probability FIXME assuming diffuse
+            // 1. Pick a random direction, calculate its probability (diffuse, so cosine-weighted off surfaces)
             FVector Dir;
             if (CurrentNormal.IsNearlyZero())
             {
-                Dir = FMath::VRand();
+                Dir = FFrequenSeeWorldScene::ToVector(Sampler.UnitVector());
                 float PDF = 1.0f / (4.0f * PI);
                 CurrentProbability = PDF;
             } else
             {
-                Dir = FMath::VRandCone(CurrentNormal, FMath::DegreesToRadians(90.f));
+                Dir = FFrequenSeeWorldScene::ToVector(Sampler.CosineHemisphereVector(FFrequenSeeWorldScene::ToCore(CurrentNormal)));
                 // Probability of an angle out of 2PI steradians (hemisphere)
                 float CosTheta = FVector::DotProduct(Dir, CurrentNormal); // assumed normalized
                 float PDF = CosTheta / PI;
@@ -698,7 +1186,6 @@ float UAudioRayTracingSubsystem::DrawSegmentedLine(FVector& Start, FVector& End,
         // Draw ray segment with delay equal to total time passed 
         FTimerHandle TimerHandle;
         float Delay = TimePassed;
-        UE_LOG(LogTemp, Warning, TEXT("Delay: %f"), Delay);
         World->GetTimerManager().SetTimer(
         	TimerHandle,
         	FTimerDelegate::CreateLambda([=, this]()
@@ -859,23 +1346,25 @@ void UAudioRayTracingSubsystem::VisualizeBDPT(const TArray<FSoundPath>& ForwardP
 // Visualizes the given number of forward/backward ray pairs
 void UAudioRayTracingSubsystem::Visualize(FActiveSource& Src, int RayCount, float Duration)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::Visualize);
+    FrequenSeeCore::FPathBatch Paths;
+    GenerateFullPaths(Src, Paths, RayCount);
+
+    // The drawing runs on timers after the batch is gone, so the paths are copied out to the heap
+    auto CopyOut = [&Paths](const std::vector<FrequenSeeCore::FPathRange>& Ranges, TArray<FSoundPath>& OutPaths)
+    {
+        OutPaths.Reserve(static_cast<int32>(Ranges.size()));
+        for (const FrequenSeeCore::FPathRange& Range : Ranges)
+        {
+            OutPaths.Add(ToSoundPath(Paths, Range));
+        }
+    };
     TArray<FSoundPath> ForwardPaths;
     TArray<FSoundPath> BackwardPaths;
     TArray<FSoundPath> ConnectedPaths;
-    GenerateFullPaths(Src, ForwardPaths, BackwardPaths, ConnectedPaths, RayCount);
-    
-    for (FSoundPath& Path : ForwardPaths)
-    {
-        EvaluatePath(Path);
-    }
-    for (FSoundPath& Path : BackwardPaths)
-    {
-        EvaluatePath(Path);
-    }
-    for (FSoundPath& Path : ConnectedPaths)
-    {
-        EvaluatePath(Path);
-    }
+    CopyOut(Paths.ForwardPaths, ForwardPaths);
+    CopyOut(Paths.BackwardPaths, BackwardPaths);
+    CopyOut(Paths.ConnectedPaths, ConnectedPaths);
     VisualizeBDPT(ForwardPaths, BackwardPaths, ConnectedPaths, Duration);
 }
 
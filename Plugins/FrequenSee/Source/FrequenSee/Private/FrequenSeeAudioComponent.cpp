@@ -7,7 +7,15 @@
 #include "Components/AudioComponent.h"
 #include "EngineUtils.h"
 #include "FrequenSeeAudioOcclusionSettings.h"
+#include "FrequenSeeSourceRegistry.h"
+#include "FrequenSeeAudioReverbPlugin.h"
+#include "FrequenSeeDecay.h"
+#include "FrequenSeeImpulseSynthesis.h"
+#include "FrequenSeeStats.h"
 #include "FrequenSeeAudioReverbSettings.h"
+#include "AudioDevice.h"
+#include "UObject/UObjectIterator.h"
+#include "HAL/IConsoleManager.h"
 #include "GameFramework/DefaultPawn.h"
 #include "TimerManager.h"
 #include "Components/SphereComponent.h"
@@ -15,23 +23,19 @@
 
 UFrequenSeeAudioComponent::UFrequenSeeAudioComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	bAutoActivate = true; // Make sure it activates and starts ticking
+	// The subsystem traces and publishes every source from its own tick
+	PrimaryComponentTick.bCanEverTick = false;
+	bAutoActivate = true;
 	this->FadeOut(5.0f, /*FadeVolumeLevel=*/0.0f);
 
 	bOverrideAttenuation = true;
 	AttenuationOverrides.bEnableOcclusion = true;
-	ImpulseBuffer.SetNum(NumChannels);
-	for (int Channel = 0; Channel < NumChannels; ++Channel)
-	{
-		ImpulseBuffer[Channel].Init(0.0f, NumSamples);
-	}
+	// the impulse response is not allocated here: this also runs for the CDO and editor instances, and sources that
+	// are never traced should not pay for it
 
 	// under content
 	FString ContentDir = FPaths::ProjectContentDir();
 	FString ImpulsePath = ContentDir + TEXT("extracted_audio.txt");
-	ImpulseBuffer[0].Init(0.0f, NumSamples);
-	ImpulseBuffer[1].Init(0.0f, NumSamples);
 	AudioBufferNum++;
 }
 
@@ -60,6 +64,8 @@ void UFrequenSeeAudioComponent::OnUnregister()
 			SubSys->UnRegisterSource(this);
 		}
 	}
+	FFrequenSeeSourceRegistry::Get().Retire(GetAudioComponentID());
+	ReleaseImpulseResponse();
 	Super::OnUnregister();
 }
 
@@ -100,282 +106,310 @@ void UFrequenSeeAudioComponent::BeginPlay()
 	}
 }
 
-void UFrequenSeeAudioComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UFrequenSeeAudioComponent::PublishOcclusion()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const float Openness = FMath::Clamp(OcclusionAttenuation, 0.0f, 1.0f);
+	FAudioOcclusionParams Params;
+	for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+	{
+		const float Floor = FMath::Square(OccludedGain) / (1.0f + FMath::Square(AcousticBandCentersHz[Band] / OccludedLowpassCutoff));
+		Params.Transmission[Band] = Openness + (1.0f - Openness) * FMath::Max(OcclusionTransmission[Band], Floor);
+	}
 
-	FrameCount++;
-	UpdateSound();
-}
+	// The filter is a gain and a one-pole lowpass: the gain matches the lowest band, the cutoff the top band's drop
+	const float Low = Params.Transmission[0];
+	const float High = Params.Transmission[AcousticBandCount - 1];
+	Params.OcclusionGain = FMath::Sqrt(Low);
+	Params.LowpassCutoff = High >= 0.99f * Low
+		? 20000.0f
+		: (High > 0.0f ? FMath::Clamp(AcousticBandCentersHz[AcousticBandCount - 1] / FMath::Sqrt(Low / High - 1.0f), 20.0f, 20000.0f) : 20.0f);
+	Params.HighpassCutoff = 20.0f;
+	Params.ReflectionTaps = ReflectionTaps;
+	PublishSourceParameters(Params);
 
-void DrawDebugLineWrapper(const UWorld* InWorld, 
-	FVector const& LineStart, 
-	FVector const& LineEnd, 
-	FColor const& Color, 
-	bool bPersistentLines = false, 
-	float LifeTime = -1, 
-	uint8 DepthPriority = 0, 
-	float Thickness = 0)
-{
+	if (bGenerateReverb && ImpulseBuffer.Num() > 0)
+	{
+		SaveArrayToFile(TArray<float>(ImpulseBuffer[0]), TEXT("saved_ir.txt"));
+		RunScript(TEXT("Scripts/test.sh"));
+		bGenerateReverb = false;
+	}
 }
 
-void UFrequenSeeAudioComponent::DebuggingDrawRay(FVector Start, FVector End, const UWorld* World, FHitResult Hit, bool bHit, int BouncesLeft, float Energy, bool HitPlayer)
+void UFrequenSeeAudioComponent::PublishSourceParameters(const FAudioOcclusionParams& Params) const
 {
-	return;
+	FFrequenSeeSourceParameters Parameters;
+	Parameters.OcclusionGain = Params.OcclusionGain;
+	Parameters.LowpassCutoff = Params.LowpassCutoff;
+	Parameters.HighpassCutoff = Params.HighpassCutoff;
+	if (bApplyMaterialFiltering)
+	{
+		FMemory::Memcpy(Parameters.MaterialBandResponse, MaterialBandResponse, sizeof(MaterialBandResponse));
+		Parameters.MaterialResponseVersion = MaterialResponseVersion;
+	}
+	Parameters.bApplyReverb = bApplyReverb;
+	Parameters.NumReflectionTaps = FMath::Min(Params.ReflectionTaps.Num(), FAudioOcclusionParams::MaxReflectionTaps);
+	FMemory::Memcpy(Parameters.ReflectionTaps, Params.ReflectionTaps.GetData(), sizeof(FAudioOcclusionParams::FEarlyReflectionTap) * Parameters.NumReflectionTaps);
+	Parameters.ReflectionTapsVersion = ReflectionTapsVersion;
+	FMemory::Memcpy(Parameters.LateReverbT60, LateReverbT60, sizeof(LateReverbT60));
+	Parameters.LateReverbEnergy = LateReverbEnergy;
+	Parameters.bUseConvolution = bUseConvolutionReverb;
+	Parameters.ReverbCluster = ReverbCluster;
+	Parameters.ReverbClusterGain = ReverbClusterGain;
+	FFrequenSeeSourceRegistry::Get().PublishParameters(GetAudioComponentID(), Parameters);
 }
 
-
-
-/*
- * Returns the energy of an audio ray from this source from the player's perspective.
- */
-float UFrequenSeeAudioComponent::CastAudioRay(FVector Dir, FVector StartPos, float MaxDistance, int Bounces, float Energy)
+void UFrequenSeeAudioComponent::PublishImpulseResponse() const
 {
-	if (Bounces == 0 || Energy <= 0.0f)
-	{
-		return 0.0f;
-	}
-
-	// Raycast recursively 
-	const FVector Start = StartPos;
-	FVector RayDir = Dir.GetSafeNormal();
-	bool HitPlayer = false;
-
-	UWorld* World = GetWorld();
-	FHitResult Hit;
-	FVector End = Start + RayDir * MaxDistance; // Adjust distance as needed
-	if (World)
-	{
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(GetOwner()); // Ignore the actor performing the trace
-
-		FCollisionObjectQueryParams ObjectParams;
-		ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-		ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic); // covers walls/floors
-		ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic); // covers dynamic props
-
-		bool bHit = World->LineTraceSingleByObjectType(
-			Hit,
-			Start,
-			End,
-			ObjectParams,
-			QueryParams
-		);
-		
-		
-		if (bHit) {
-			float DistanceLeft = MaxDistance - Hit.Distance;
-			FVector DirToPlayer = Player->GetActorLocation() - Hit.ImpactPoint;
-			float DistanceToPlayer = DirToPlayer.Size();
-			// reducing scale by 100x
-			float TravelTime = (RaycastDistance - DistanceLeft + DistanceToPlayer) * 0.01f / 343.0f;
-			if (TravelTime > SimulatedDuration)
-			{
-				return 0.0f;
-			}
-		
-			if (Hit.GetActor()->IsA<ADefaultPawn>())
-			{
-				DebuggingDrawRay(Start, Hit.ImpactPoint, World, Hit, bHit, Bounces, Energy, true);
-				return Energy;
-			} else
+	TSharedRef<FFrequenSeeImpulseResponse, ESPMode::ThreadSafe> ImpulseResponse = MakeShared<FFrequenSeeImpulseResponse, ESPMode::ThreadSafe>();
+	ImpulseResponse->Version = ImpulseResponseVersion;
+	if (SampleRate == DeviceSampleRate)
+	{
+		ImpulseResponse->Channels = ImpulseBuffer;
+	}
+	else
+	{
+		// Linear interpolation keeps the per-sample envelope level, which is what the reconstruction defines
+		const int32 DeviceSamples = FMath::CeilToInt(SimulatedDuration * DeviceSampleRate);
+		const float Step = float(SampleRate) / float(DeviceSampleRate);
+		ImpulseResponse->Channels.SetNum(ImpulseBuffer.Num());
+		for (int32 Channel = 0; Channel < ImpulseBuffer.Num(); ++Channel)
+		{
+			const FFrequenSeeAlignedFloats& In = ImpulseBuffer[Channel];
+			FFrequenSeeAlignedFloats& Out = ImpulseResponse->Channels[Channel];
+			Out.SetNumZeroed(DeviceSamples);
+			for (int32 Sample = 0; Sample < DeviceSamples && In.Num() > 0; ++Sample)
 			{
-				auto OldEnergy = Energy;
-				DirToPlayer.Normalize();
-				float DirectEnergy = CastDirectAudioRay(DirToPlayer, Hit.ImpactPoint, DistanceLeft, 1, Energy);
-				FVector NewDir = FMath::GetReflectionVector(RayDir, Hit.ImpactNormal);
-				FVector NewStart = Hit.ImpactPoint + Hit.ImpactNormal * 0.5f;
-				
-				DebuggingDrawRay(Start, NewStart, World, Hit, bHit, Bounces, OldEnergy);
-				return CastAudioRay(NewDir, NewStart, DistanceLeft, Bounces - 1, Energy);
+				const float Position = Sample * Step;
+				const int32 Index = FMath::Min(FMath::FloorToInt32(Position), In.Num() - 1);
+				const int32 Next = FMath::Min(Index + 1, In.Num() - 1);
+				Out[Sample] = FMath::Lerp(In[Index], In[Next], Position - Index);
 			}
-		} else {
-			// Return zero energy
-			DebuggingDrawRay(Start, End, World, Hit, bHit, Bounces, Energy);
-			return 0.0f;
 		}
-		
 	}
 
-	if (HitPlayer)
-	{
-		return Energy;		
-	} else
+	// The FFTs happen here so the render thread only swaps pointers; the channels are copies of the mono trace, so
+	// one set of partitions serves them all
+	if (ImpulseResponse->Channels.Num() > 0)
 	{
-		return 0.0f;
+		const int32 BlockSize = FFrequenSeeAudioReverbPlugin::ConvolutionBlockSize;
+		const FFrequenSeeAlignedFloats& MonoResponse = ImpulseResponse->Channels[0];
+		const int32 Latency = FMath::Min(BlockSize, MonoResponse.Num());
+		ImpulseResponse->Prepared.Add(FFrequenSeePartitionedConvolver::PrepareImpulseResponse(
+			BlockSize, MonoResponse.GetData() + Latency, MonoResponse.Num() - Latency));
 	}
+	FFrequenSeeSourceRegistry::Get().PublishImpulseResponse(GetAudioComponentID(), ImpulseResponse);
 }
 
-float UFrequenSeeAudioComponent::CastDirectAudioRay(FVector Dir, FVector StartPos, float MaxDistance, int Bounces,
-	float Energy, AActor* DirectHitActor)
+void UFrequenSeeAudioComponent::ConfigureImpulseResponse()
 {
-	if (Bounces == 0 || Energy <= 0.0f)
+	if (const FAudioDevice* AudioDevice = GetAudioDevice())
 	{
-		return 0.0f;
+		DeviceSampleRate = FMath::RoundToInt32(AudioDevice->GetSampleRate());
 	}
+	if (DeviceSampleRate <= 0)
+	{
+		DeviceSampleRate = 48000;
+	}
+
+	const UFrequenSeeAudioReverbSettings* Settings = ReverbSettings.IsValid() ? ReverbSettings.Get() : GetDefault<UFrequenSeeAudioReverbSettings>();
+	SimulatedDuration = FMath::Clamp(Settings->ImpulseResponseDuration, 0.1f, 4.0f);
+	SampleRate = Settings->ImpulseResponseSampleRate > 0 ? FMath::Clamp(Settings->ImpulseResponseSampleRate, 8000, 96000) : DeviceSampleRate;
+	BinDuration = FMath::Clamp(Settings->EnergyBinMs, 0.25f, 10.0f) * 0.001f;
+	NumBins = FMath::CeilToInt(SimulatedDuration / BinDuration);
+	NumSamples = FMath::CeilToInt(SimulatedDuration * SampleRate);
+}
 
-	UWorld* World = GetWorld();
-	if (!World)
+void UFrequenSeeAudioComponent::ReleaseImpulseResponse()
+{
+	ImpulseBuffer.Empty();
+	EnergyBuffer.Empty();
+	for (TArray<float>& BandBuffer : BandEnergyBuffers)
 	{
-		return 0.0f;
+		BandBuffer.Empty();
 	}
-	
-	FHitResult Hit;
-	FCollisionQueryParams QueryParams;
-	// hack
-	QueryParams.AddIgnoredActor(DirectHitActor);
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic); // covers walls/floors
-	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic); // covers dynamic props
-
-	FVector DirectStart = StartPos + Dir * 0.1f;
-	FVector DirectEnd = DirectStart + Dir * MaxDistance;
-		
-	bool bDirectHit = World->LineTraceSingleByObjectType(
-		Hit,
-		DirectStart,
-		DirectEnd,
-		ObjectParams,
-		QueryParams
-	);
-	DebuggingDrawRay(DirectStart, Hit.ImpactPoint, World, Hit, bDirectHit, Bounces, Energy);
+	Arrivals.Empty();
+}
 
-	// NOTE: energy adjustments due to air should be accumulated (the distance rather) and calculated later based on the distance
-	if (bDirectHit)
+SIZE_T UFrequenSeeAudioComponent::GetImpulseResponseMemory() const
+{
+	SIZE_T Bytes = ImpulseBuffer.GetAllocatedSize() + EnergyBuffer.GetAllocatedSize() + Arrivals.GetAllocatedSize();
+	for (const TArray<float>& Channel : ImpulseBuffer)
 	{
-		// moved inside the wall -> currently doesn't work
-		if (Hit.GetActor() == DirectHitActor) 
-		{
-			// Energy *= (1.f - AbsorbtionFactor * fmax(Hit.Distance, 1.0f));
-			return CastDirectAudioRay(Dir, Hit.ImpactPoint, MaxDistance - Hit.Distance, Bounces, Energy, Hit.GetActor());
-		}
-		// hit the player
-		if (Hit.GetActor()->IsA<ADefaultPawn>())
+		Bytes += Channel.GetAllocatedSize();
+	}
+	for (const TArray<float>& BandBuffer : BandEnergyBuffers)
+	{
+		Bytes += BandBuffer.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+namespace
+{
+	/**
+	 * FrequenSee.Memory.ImpulseResponses
+	 * Lists the impulse response memory of every FrequenSee source: the IR, histograms and arrivals the component
+	 * holds, plus the device-rate copy last handed to the reverb plugin.
+	 */
+	void ReportImpulseResponseMemory()
+	{
+		int32 NumSources = 0;
+		int32 NumAllocated = 0;
+		SIZE_T TotalBytes = 0;
+		SIZE_T TotalPublishedBytes = 0;
+		for (TObjectIterator<UFrequenSeeAudioComponent> It; It; ++It)
 		{
-			float TravelDistance = RaycastDistance - MaxDistance + Hit.Distance;
-			// reducing scale by 10x
-			TravelDistance *= 0.01f;
-			float TravelTime = TravelDistance / 343.0f;
-			if (TravelTime > SimulatedDuration)
+			const UFrequenSeeAudioComponent* Component = *It;
+			if (Component->IsTemplate())
 			{
-				return 0.0f;
+				continue;
 			}
-			Energy *= expf(-0.0017f * TravelDistance);
-			// not sure about channels
-			Accumulate(TravelTime, Energy, 0);
-			Accumulate(TravelTime, Energy, 1);
-			
-			return Energy;
-		}
-		// hit a different obstacle, continue through it if there's distance or bounces
-		else 
-		{
-			return CastDirectAudioRay(Dir, Hit.ImpactPoint, MaxDistance - Hit.Distance, Bounces - 1, Energy, Hit.GetActor());
+			++NumSources;
+			const SIZE_T Bytes = Component->GetImpulseResponseMemory();
+			const SIZE_T PublishedBytes = Component->ImpulseResponseVersion > 0
+				? SIZE_T(sizeof(float)) * Component->ImpulseBuffer.Num() * FMath::CeilToInt(Component->SimulatedDuration * Component->DeviceSampleRate)
+				: 0;
+			if (Bytes == 0 && PublishedBytes == 0)
+			{
+				continue;
+			}
+			++NumAllocated;
+			TotalBytes += Bytes;
+			TotalPublishedBytes += PublishedBytes;
+			UE_LOG(LogTemp, Display, TEXT("  %s: %.2f s at %d Hz, %.2f ms bins, %d arrivals: %.1f KB (+%.1f KB published)"),
+			       *Component->GetPathName(), Component->SimulatedDuration, Component->SampleRate, Component->BinDuration * 1000.0f,
+			       Component->Arrivals.Num(), Bytes / 1024.0, PublishedBytes / 1024.0);
 		}
+		UE_LOG(LogTemp, Display, TEXT("Impulse responses: %d of %d sources allocated, %.2f MB on components, %.2f MB published"),
+		       NumAllocated, NumSources, TotalBytes / (1024.0 * 1024.0), TotalPublishedBytes / (1024.0 * 1024.0));
 	}
-	
-	// no hit
-	return 0.0f;
-}
 
+	FAutoConsoleCommand ImpulseResponseMemoryCommand(
+		TEXT("FrequenSee.Memory.ImpulseResponses"),
+		TEXT("Logs the impulse response memory of every FrequenSee source and the total."),
+		FConsoleCommandDelegate::CreateStatic(&ReportImpulseResponseMemory));
+}
 
-void UFrequenSeeAudioComponent::UpdateSound()
+void UFrequenSeeAudioComponent::BuildEnergyHistograms()
 {
-	// not sure
-	ClearEnergyBuffer();
-	
-	float TotalEnergy = 0.0f;
-	for (int i = 0; i < RaycastsPerTick; i++)
+	TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::BuildEnergyHistograms);
+	if (NumBins == 0)
 	{
-		auto RandDir = FMath::VRandCone(FVector(0.0f, -1.0f, 0.0f), PI, PI); // help
-		float Energy = CastAudioRay(RandDir, GetComponentLocation(), RaycastDistance, RaycastBounces);
-		TotalEnergy += Energy;
+		ConfigureImpulseResponse();
 	}
-	TotalEnergy /= RaycastsPerTick;
-
-	FVector DirToPlayer = Player->GetActorLocation() - GetComponentLocation();
-	DirToPlayer.Normalize();
-	OcclusionAttenuation = CastDirectAudioRay(DirToPlayer, GetComponentLocation(), RaycastDistance, 10, 1.0f, GetOwner());
-	if (bGenerateReverb)
+	Arrivals.Finalize();
+	EnergyBuffer.SetNumUninitialized(NumBins);
+	float* BandData[AcousticBandCount];
+	for (int32 Band = 0; Band < AcousticBandCount; ++Band)
 	{
-		SaveArrayToFile(ImpulseBuffer[0], TEXT("saved_ir.txt"));
-		RunScript(TEXT("Scripts/test.sh"));
-		bGenerateReverb = false;
+		BandEnergyBuffers[Band].SetNumUninitialized(NumBins);
+		BandData[Band] = BandEnergyBuffers[Band].GetData();
 	}
+	Arrivals.ToHistograms(BinDuration, NumBins, EnergyBuffer.GetData(), BandData);
 }
 
-void UFrequenSeeAudioComponent::ClearEnergyBuffer()
+void UFrequenSeeAudioComponent::ReconstructImpulseResponse()
 {
-	for (auto& ChannelBuffer : EnergyBuffer)
+	SCOPE_CYCLE_COUNTER(STAT_FrequenSee_ReconstructIR);
+
+	// Allocated on the first trace, and resized if the reverb settings changed since the last one
+	if (NumBins == 0)
+	{
+		ConfigureImpulseResponse();
+	}
+	ImpulseBuffer.SetNum(NumChannels);
+	for (FFrequenSeeAlignedFloats& ImpulseResponse : ImpulseBuffer)
 	{
+		if (ImpulseResponse.Num() != NumSamples)
+		{
+			ImpulseResponse.SetNumZeroed(NumSamples);
+		}
 	}
+
+	// The early window is rendered from the arrivals up to where the reflection taps stop
+	FrequenSeeCore::FImpulseResponseLayout Layout;
+	Layout.SampleRate = static_cast<float>(SampleRate);
+	Layout.BinSeconds = BinDuration;
+	Layout.NumBins = NumBins;
+	Layout.NumSamples = NumSamples;
+	Layout.EarlySeconds = FAudioOcclusionParams::MaxReflectionTapDelaySeconds;
+
+	// The tracer is mono, so one channel is built and copied to the others
+	FFrequenSeeAlignedFloats& ImpulseResponse = ImpulseBuffer[0];
+	FrequenSeeCore::SynthesizeImpulseResponse(Arrivals, EnergyBuffer.GetData(), Layout, ImpulseResponse.GetData());
+
+	for (int32 Channel = 1; Channel < ImpulseBuffer.Num(); ++Channel)
+	{
+		FMemory::Memcpy(ImpulseBuffer[Channel].GetData(), ImpulseResponse.GetData(), sizeof(float) * NumSamples);
+	}
+	++ImpulseResponseVersion;
+	PublishImpulseResponse();
 }
 
-void UFrequenSeeAudioComponent::Accumulate(float TimeSeconds, float Value, int32 Channel)
+void UFrequenSeeAudioComponent::SetMaterialBandResponse(const float* BandResponse)
 {
-	if (Channel >= NumChannels || Channel < 0) return;
+	constexpr float kResponseTolerance = 1e-3f;
+	bool bChanged = false;
+	for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+	{
+		bChanged |= !FMath::IsNearlyEqual(MaterialBandResponse[Band], BandResponse[Band], kResponseTolerance);
+	}
+	if (bChanged)
+	{
+		FMemory::Memcpy(MaterialBandResponse, BandResponse, sizeof(MaterialBandResponse));
+		++MaterialResponseVersion;
+	}
 }
 
-void UFrequenSeeAudioComponent::ReconstructImpulseResponse()
+void UFrequenSeeAudioComponent::FitLateReverb()
 {
-	constexpr float kEnergyThreshold = 1e-6f;
-	const float Pi4 = FMath::Sqrt(4.0f * PI);
-	const int32 NumSamplesPerBin = FMath::CeilToInt(BinDuration * SampleRate);
-	const TArray<float>& EnergyNorms = EnergyBuffer;
-	
-	for (int32 Channel = 0; Channel < NumChannels; ++Channel) 
+	TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::FitLateReverb);
+	const float BroadbandT60 = FrequenSeeDecay::EstimateT60(EnergyBuffer.GetData(), EnergyBuffer.Num(), BinDuration);
+	for (int32 Band = 0; Band < AcousticBandCount; ++Band)
 	{
-		const TArray<float>& EnergyResponse = EnergyBuffer;
-		TArray<float>& ImpulseResponse = ImpulseBuffer[Channel];
-		if (ImpulseBuffer[Channel].Num() == 0)
+		const TArray<float>& BandBuffer = BandEnergyBuffers[Band];
+		const float BandT60 = FrequenSeeDecay::EstimateT60(BandBuffer.GetData(), BandBuffer.Num(), BinDuration);
+
+		// Too few arrivals to fit a band: fall back to the broadband fit, then keep the previous value
+		if (BandT60 > 0.0f)
 		{
-			ImpulseBuffer[Channel].SetNumZeroed(NumSamples);
+			LateReverbT60[Band] = BandT60;
 		}
-		FMemory::Memset(ImpulseResponse.GetData(), 0, sizeof(float) * ImpulseResponse.Num());
-	 	
-		for (int32 Bin = 0; Bin < NumBins; ++Bin) 
+		else if (BroadbandT60 > 0.0f)
 		{
-			const float EnergyNorm = EnergyNorms[Bin];
-			const float NumBinSamples = std::min(NumSamplesPerBin, NumSamples - Bin * NumSamplesPerBin);
-			float Normalization = 1.0f;
-			float Energy = 0.0f;
-			if (fabsf(EnergyResponse[Bin]) >= kEnergyThreshold && fabsf(EnergyNorm) >= kEnergyThreshold)
-			{
-				Energy = EnergyResponse[Bin] / sqrtf(EnergyNorm * Pi4);
-			}
-			float PrevEnergy = 0.0f;
-			if (Bin == 0)
-			{
-				PrevEnergy = Energy;
-			}
-			else if (fabsf(EnergyResponse[Bin - 1]) >= kEnergyThreshold && fabsf(EnergyNorms[Bin - 1]) >= kEnergyThreshold)
-			{
-				PrevEnergy = EnergyResponse[Bin - 1] / sqrtf(EnergyNorms[Bin - 1] * Pi4);
-			}
-	
-			for (int32 BinSample = 0, Sample = Bin * NumSamplesPerBin; BinSample < NumBinSamples; ++BinSample, ++Sample)
-			{
-				const float Weight = static_cast<float>(BinSample) / static_cast<float>(NumSamplesPerBin);
-				const float SampleEnergy = (1.0f - Weight) * PrevEnergy + Weight * Energy;
-	
-				ImpulseResponse[Sample] = SampleEnergy;
-			}
+			LateReverbT60[Band] = BroadbandT60;
 		}
-	
-		const float FilterCoefficient = 0.25f; // Tune between (0, 1)
-		TArray<float> Filtered;
-		Filtered.SetNumUninitialized(ImpulseResponse.Num());
-	
-		// First sample is unchanged (or initialize as needed)
-		Filtered[0] = ImpulseResponse[0];
-		for (int32 i = 1; i < ImpulseResponse.Num(); ++i)
+	}
+
+	float Energy = 0.0f;
+	if (ImpulseBuffer.Num() > 0)
+	{
+		for (float Sample : ImpulseBuffer[0])
 		{
-			Filtered[i] = FilterCoefficient * ImpulseResponse[i] + (1.0f - FilterCoefficient) * Filtered[i - 1];
+			Energy += Sample * Sample;
 		}
+	}
+	// The FDN stands in for the device-rate copy the plugin convolves, which has this many samples per IR sample
+	LateReverbEnergy = SampleRate > 0 ? Energy * DeviceSampleRate / SampleRate : Energy;
 
-		NormalizeImpulseResponse(ImpulseResponse);
-		ImpulseResponse = MoveTemp(Filtered);
+	FrequenSeeDecay::DecayProfile(EnergyBuffer.GetData(), EnergyBuffer.Num(), ReverbProfile, ReverbProfilePoints);
+}
+
+void UFrequenSeeAudioComponent::SetReflectionTaps(TArrayView<const FAudioOcclusionParams::FEarlyReflectionTap> Taps)
+{
+	constexpr float kDelayTolerance = 1e-5f;
+	constexpr float kGainTolerance = 1e-4f;
+	bool bChanged = Taps.Num() != ReflectionTaps.Num();
+	for (int32 Index = 0; !bChanged && Index < Taps.Num(); ++Index)
+	{
+		bChanged = !FMath::IsNearlyEqual(Taps[Index].DelaySeconds, ReflectionTaps[Index].DelaySeconds, kDelayTolerance) ||
+		           !FMath::IsNearlyEqual(Taps[Index].Gain, ReflectionTaps[Index].Gain, kGainTolerance);
+	}
+	if (bChanged)
+	{
+		ReflectionTaps.Reset();
+		ReflectionTaps.Append(Taps.GetData(), Taps.Num());
+		++ReflectionTapsVersion;
 	}
 }
 
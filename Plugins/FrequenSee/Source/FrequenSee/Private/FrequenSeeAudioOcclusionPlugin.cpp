@@ -1,8 +1,8 @@
 #include "FrequenSeeAudioOcclusionPlugin.h"
 
 #include "FrequenSeeAudioOcclusionSettings.h"
-#include "Components/AudioComponent.h"
-#include "GameFramework/Actor.h"
+#include "FrequenSeeCallbackMonitor.h"
+#include "FrequenSeeStats.h"
 #include "HAL/UnrealMemory.h"
 
 
@@ -15,38 +15,61 @@ void FFrequenSeeAudioOcclusionPlugin::Initialize(const FAudioPluginInitializatio
     // log
     UE_LOG(LogTemp, Warning, TEXT("Initializing occlusion plugin"));
 
-    // Sources.AddDefaulted(InitializationParams.NumSources);
+    Sources.Reset();
+    Sources.SetNum(InitializationParams.NumSources);
 }
 
 void FFrequenSeeAudioOcclusionPlugin::OnInitSource(const uint32 SourceId, const FName& AudioComponentUserId, const uint32 NumChannels, UOcclusionPluginSourceSettingsBase* InSettings)
 {
-    // log
-    UE_LOG(LogTemp, Warning, TEXT("Initializing source %d"), SourceId);
-
+    FFrequenSeeOcclusionSource& Source = Sources[SourceId];
+    Source.Filter.Init(SamplingRate, NumChannels);
+    Source.RenderState.Reset();
+    Source.bFilterPrimed = false;
 }
 
 void FFrequenSeeAudioOcclusionPlugin::OnReleaseSource(const uint32 SourceId)
 {
-    
+    FFrequenSeeOcclusionSource& Source = Sources[SourceId];
+    Source.RenderState.Reset();
+    Source.bFilterPrimed = false;
 }
 
 void FFrequenSeeAudioOcclusionPlugin::ProcessAudio(const FAudioPluginSourceInputData& InputData, FAudioPluginSourceOutputData& OutputData)
 {
-    // UFrequenSeeAudioComponent& Source = Sources[InputData.SourceId];
-    // UE_LOG(LogTemp, Warning, TEXT("OCCLUSION PLUGIN PROCESSING"));
-    const UAudioComponent* AudioComponent = UAudioComponent::GetAudioComponentFromID(InputData.AudioComponentId);
-    const UFrequenSeeAudioComponent* FrequenSeeSourceComponent = AudioComponent->GetOwner()->FindComponentByClass<UFrequenSeeAudioComponent>();
+    SCOPE_CYCLE_COUNTER(STAT_FrequenSee_OcclusionCallback);
+    const FFrequenSeeCallbackScope CallbackScope;
 
+    FFrequenSeeOcclusionSource& Source = Sources[InputData.SourceId];
     const float* InBufferData = InputData.AudioBuffer->GetData();
     float* OutBufferData = OutputData.AudioBuffer.GetData();
+    const int32 NumSamples = InputData.AudioBuffer->Num();
 
-    const float OcclusionAttenuation = FrequenSeeSourceComponent->GetOcclusionAttenuation();
-    // UE_LOG(LogTemp, Warning, TEXT("OCCLUSION ATTENUATION: %f"), OcclusionAttenuation);
+    if (!Source.Filter.IsInitialized() || Source.Filter.GetNumChannels() != InputData.NumChannels)
+    {
+        FMemory::Memcpy(OutBufferData, InBufferData, sizeof(float) * NumSamples);
+        return;
+    }
 
-    for (int SampleIndex = 0; SampleIndex < InputData.AudioBuffer->Num(); ++SampleIndex)
+    const uint64 PreviousComponentId = Source.RenderState.AudioComponentId;
+    FFrequenSeeSourceRegistry::Get().SyncParameters(Source.RenderState, InputData.AudioComponentId);
+    if (Source.RenderState.AudioComponentId != PreviousComponentId)
     {
-        // OutBufferData[SampleIndex] = InBufferData[SampleIndex] * OcclusionAttenuation;
+        Source.bFilterPrimed = false;
     }
+
+    if (Source.RenderState.bHasParameters)
+    {
+        const FFrequenSeeSourceParameters& Parameters = Source.RenderState.Parameters;
+        Source.Filter.SetTargets(Parameters.OcclusionGain, Parameters.LowpassCutoff, Parameters.HighpassCutoff);
+        if (!Source.bFilterPrimed)
+        {
+            // The first parameters of a component apply at once instead of gliding from the defaults
+            Source.Filter.SnapToTargets();
+            Source.bFilterPrimed = true;
+        }
+    }
+
+    Source.Filter.Process(InBufferData, OutBufferData, NumSamples / InputData.NumChannels);
 }
 
 
@@ -1,5 +1,17 @@
 #pragma once
 #include "FrequenSeeAudioComponent.h"
+#include "FrequenSeeOcclusionFilter.h"
+#include "FrequenSeeSourceRegistry.h"
+
+/** Render-thread state of one source voice. */
+struct FFrequenSeeOcclusionSource
+{
+	FFrequenSeeOcclusionFilter Filter;
+	FFrequenSeeSourceRenderState RenderState;
+
+	/** Whether the filter has been snapped to the first parameters of the current component. */
+	bool bFilterPrimed = false;
+};
 
 class FREQUENSEE_API FFrequenSeeAudioOcclusionPlugin : public IAudioOcclusion
 {
@@ -20,8 +32,8 @@ private:
 	int SamplingRate = 0;
 	int FrameSize = 0;
 
-	/** Lazy-initialized state for as many sources as we can render simultaneously. */
-	// TArray<UFrequenSeeAudioComponent> Sources;
+	/** State for as many sources as we can render simultaneously, indexed by SourceId. */
+	TArray<FFrequenSeeOcclusionSource> Sources;
 };
 
 class FFrequenSeeAudioOcclusionPluginFactory : public IAudioOcclusionFactory
@@ -1,15 +1,26 @@
 #include "FrequenSeeAudioReverbPlugin.h"
 #include "Sound/SoundSubmix.h"
 #include "FrequenSeeAudioModule.h"
-#include "ConvolutionReverb.h"
 #include "HAL/UnrealMemory.h"
-#include "Components/AudioComponent.h"
-#include "SubmixEffects/SubmixEffectConvolutionReverb.h"
-#include "DSP/ConvolutionAlgorithm.h"
+#include "FrequenSeeSpectrum.h"
+#include "FrequenSeeCallbackMonitor.h"
+#include "FrequenSeeStats.h"
 
 FFrequenSeeAudioReverbSource::FFrequenSeeAudioReverbSource()
 	: bApplyReflections(true),
-	  PrevDuration(0.0f)
+	  PrevDuration(0.0f),
+	  ImpulseResponseVersion(0),
+	  ImpulseResponseFrames(0),
+	  MaterialResponseVersion(0),
+	  ReflectionTapsVersion(0),
+	  HeadResponseVersion(0),
+	  FdnT60{ 0.0f, 0.0f, 0.0f },
+	  FdnEnergy(-1.0f),
+	  LateReverbPath(EFrequenSeeLateReverbPath::Convolution),
+	  ReverbCluster(INDEX_NONE),
+	  ClusterSendGain(1.0f),
+	  ClusterSendFrames(0),
+	  ClusterSendBlock(0)
 {
 }
 
@@ -23,6 +34,35 @@ void FFrequenSeeAudioReverbSource::ClearBuffers()
 	{
 		IndirectBuffer.AudioBuffer.Empty();
 	}
+	for (FFrequenSeePartitionedConvolver &Convolver : Convolvers)
+	{
+		if (Convolver.IsInitialized())
+		{
+			Convolver.SetImpulseResponse(FFrequenSeePreparedImpulseResponsePtr());
+			Convolver.SetSpectralGains(nullptr, 0);
+			Convolver.Reset();
+		}
+	}
+	for (FFrequenSeeSparseTapFilter &TapFilter : TapFilters)
+	{
+		if (TapFilter.IsInitialized())
+		{
+			TapFilter.Reset();
+		}
+	}
+	if (Fdn.IsInitialized())
+	{
+		Fdn.Reset();
+	}
+	ImpulseResponseVersion = 0;
+	MaterialResponseVersion = 0;
+	ReflectionTapsVersion = 0;
+	HeadResponseVersion = 0;
+	FdnEnergy = -1.0f;
+	LateReverbPath = EFrequenSeeLateReverbPath::Convolution;
+	ReverbCluster = INDEX_NONE;
+	ClusterSendBlock = 0;
+	RenderState.Reset();
 }
 
 FFrequenSeeAudioReverbPlugin::FFrequenSeeAudioReverbPlugin()
@@ -38,23 +78,21 @@ FFrequenSeeAudioReverbPlugin::FFrequenSeeAudioReverbPlugin(FVTableHelper &Helper
 
 FFrequenSeeAudioReverbPlugin::~FFrequenSeeAudioReverbPlugin()
 {
-	kiss_fftr_free(ForwardCfg);
-	kiss_fftr_free(InverseCfg);
 }
 
 FSoundEffectSubmixPtr FFrequenSeeAudioReverbPlugin::GetEffectSubmix()
 {
 	// UE_LOG(LogTemp, Display, TEXT("Getting reverb submix effect"));
 	USoundSubmix *Submix = GetSubmix();
-	USubmixEffectConvolutionReverbPreset *Preset = NewObject<USubmixEffectConvolutionReverbPreset>(Submix, TEXT("FrequenSee Audio Reverb Preset"));
-	FSubmixEffectConvolutionReverbSettings InputSettings;
+	// the submix effect convolves the shared reverb clusters on top of the per-source reverb flowing through it
+	UFrequenSeeAudioReverbSubmixPluginPreset *Preset = NewObject<UFrequenSeeAudioReverbSubmixPluginPreset>(Submix, TEXT("FrequenSee Audio Reverb Preset"));
 	FSoundEffectSubmixInitData InitData;
 	InitData.SampleRate = SamplingRate;
 	ReverbSubmixEffect = USoundEffectSubmixPreset::CreateInstance<FSoundEffectSubmixInitData, FSoundEffectSubmix>(InitData, *Preset);
 
 	if (ReverbSubmixEffect)
 	{
-		// StaticCastSharedPtr<FFrequenSeeAudioReverbSubmixPlugin, FSoundEffectSubmix>(ReverbSubmixEffect)->SetReverbPlugin(this);
+		StaticCastSharedPtr<FFrequenSeeAudioReverbSubmixPlugin, FSoundEffectSubmix>(ReverbSubmixEffect)->SetReverbPlugin(this);
 		ReverbSubmixEffect->SetEnabled(true);
 	}
 
@@ -76,27 +114,15 @@ void FFrequenSeeAudioReverbPlugin::Initialize(const FAudioPluginInitializationPa
 	SamplingRate = InitializationParams.SampleRate;
 	FrameSize = InitializationParams.BufferLength;
 	Sources.AddDefaulted(InitializationParams.NumSources);
-	int IRSize = SamplingRate * SimulatedDuration;
-	AudioTailBufferLeft.SetSize(IRSize - 1);
-	AudioTailBufferRight.SetSize(IRSize - 1);
-	int CurrTailSize = IRSize - 1 + FrameSize;
-	CurrAudioTailLeft.SetNumZeroed(CurrTailSize);
-	CurrAudioTailRight.SetNumZeroed(CurrTailSize);
-	// ConvOutputLeft.SetNumZeroed(CurrTailSize + IRSize - 1);
-	// ConvOutputRight.SetNumZeroed(CurrTailSize + IRSize - 1);
-	ConvOutputLeft.SetNumZeroed(CurrTailSize);
-	ConvOutputRight.SetNumZeroed(CurrTailSize);
-
-	FFTSize = FMath::RoundUpToPowerOfTwo(CurrTailSize); // Next power of 2 ≥ 97022
-	const int32 NumFreqBins = FFTSize / 2 + 1;
-	ForwardCfg = kiss_fftr_alloc(FFTSize, 0, nullptr, nullptr);
-	InverseCfg = kiss_fftr_alloc(FFTSize, 1, nullptr, nullptr);
-	OutputFreq.SetNumZeroed(NumFreqBins);
-	InputFreq.SetNumZeroed(NumFreqBins);
-	IRFreq.SetNumZeroed(NumFreqBins);
-	TimeDomainOutput.SetNumZeroed(FFTSize);
-	IRPadded.SetNumZeroed(FFTSize);
-	InputPadded.SetNumZeroed(FFTSize);
+
+	Clusters.SetNum(FFrequenSeeReverbClusters::MaxClusters);
+	for (FFrequenSeeAudioReverbCluster &Cluster : Clusters)
+	{
+		InitConvolvers(Cluster.Convolvers, Cluster.SpectralGains, SimulatedDuration);
+		Cluster.Input.SetNumZeroed(2 * FrameSize);
+	}
+	ClusterChannelInput.SetNumZeroed(FrameSize);
+	ClusterChannelOutput.SetNumZeroed(FrameSize);
 
 	UE_LOG(LogTemp, Warning, TEXT("Initializing reverb plugin"));
 }
@@ -104,9 +130,39 @@ void FFrequenSeeAudioReverbPlugin::Initialize(const FAudioPluginInitializationPa
 void FFrequenSeeAudioReverbPlugin::OnInitSource(const uint32 SourceId, const FName &AudioComponentUserId,
 												const uint32 NumChannels, UReverbPluginSourceSettingsBase *InSettings)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Initializing reverb source %d"), SourceId);
-
 	FFrequenSeeAudioReverbSource &Source = Sources[SourceId];
+	// the convolvers follow the source's IR length; a voice slot reused by a source with another length is resized
+	const UFrequenSeeAudioReverbSettings *Settings = Cast<UFrequenSeeAudioReverbSettings>(InSettings);
+	const float Duration = Settings ? FMath::Clamp(Settings->ImpulseResponseDuration, 0.1f, 4.0f) : SimulatedDuration;
+	if (Source.Convolvers[0].IsInitialized() && Source.Convolvers[0].GetMaxPartitions() != NumConvolutionPartitions(Duration))
+	{
+		InitConvolvers(Source.Convolvers, Source.SpectralGains, Duration);
+	}
+	if (!Source.Convolvers[0].IsInitialized())
+	{
+		InitConvolvers(Source.Convolvers, Source.SpectralGains, Duration);
+		const int32 MaxTapDelayFrames = FMath::CeilToInt32(FAudioOcclusionParams::MaxReflectionTapDelaySeconds * SamplingRate) + 1;
+		for (FFrequenSeeSparseTapFilter &TapFilter : Source.TapFilters)
+		{
+			TapFilter.Init(MaxTapDelayFrames, FrameSize);
+		}
+		Source.Taps.SetNumZeroed(FAudioOcclusionParams::MaxReflectionTaps);
+		Source.ChannelInput.SetNumZeroed(FrameSize);
+		Source.ChannelOutput.SetNumZeroed(FrameSize);
+		Source.TapOutput.SetNumZeroed(FrameSize);
+		Source.Fdn.Init(SamplingRate);
+		Source.FdnOutput.SetNumZeroed(2 * FrameSize);
+		Source.ClusterSend.SetNumZeroed(2 * FrameSize);
+	}
+	Source.ImpulseResponseVersion = 0;
+	Source.MaterialResponseVersion = 0;
+	Source.ReflectionTapsVersion = 0;
+	Source.HeadResponseVersion = 0;
+	Source.FdnEnergy = -1.0f;
+	Source.LateReverbPath = EFrequenSeeLateReverbPath::Convolution;
+	Source.ReverbCluster = INDEX_NONE;
+	Source.ClusterSendBlock = 0;
+	Source.RenderState.Reset();
 }
 
 void FFrequenSeeAudioReverbPlugin::OnReleaseSource(const uint32 SourceId)
@@ -115,101 +171,392 @@ void FFrequenSeeAudioReverbPlugin::OnReleaseSource(const uint32 SourceId)
 	Source.ClearBuffers();
 }
 
+int32 FFrequenSeeAudioReverbPlugin::NumConvolutionPartitions(float DurationSeconds) const
+{
+	return FMath::DivideAndRoundUp(GetConvolutionIRSize(DurationSeconds), ConvolutionBlockSize);
+}
+
+void FFrequenSeeAudioReverbPlugin::InitConvolvers(FFrequenSeePartitionedConvolver (&Convolvers)[2], TArray<float> &SpectralGains, float DurationSeconds) const
+{
+	const int32 IRSize = GetConvolutionIRSize(DurationSeconds);
+	for (FFrequenSeePartitionedConvolver &Convolver : Convolvers)
+	{
+		// spectral shaping lets material band responses be folded into the partitions without extra FFTs
+		Convolver.Init(ConvolutionBlockSize, IRSize, 1, true);
+	}
+	SpectralGains.SetNumZeroed(Convolvers[0].GetNumBins());
+}
+
+void FFrequenSeeAudioReverbPlugin::UpdateConvolvers(const FFrequenSeeSourceRenderState &RenderState, FFrequenSeePartitionedConvolver (&Convolvers)[2],
+													uint32 &ImpulseResponseVersion, int32 &ImpulseResponseFrames, uint32 &MaterialResponseVersion,
+													TArray<float> &SpectralGains) const
+{
+	// switch to the impulse response only when the simulation produced a new one or the governor changed its length;
+	// the convolvers crossfade to it
+	const FFrequenSeeImpulseResponse *ImpulseResponse = RenderState.ImpulseResponse.Get();
+	if (ImpulseResponse && ImpulseResponse->Prepared.Num() > 0)
+	{
+		const int32 NumFrames = FFrequenSeeCallbackMonitor::Get().LimitImpulseResponseFrames(ImpulseResponse->Channels[0].Num());
+		if (ImpulseResponseVersion != ImpulseResponse->Version || ImpulseResponseFrames != NumFrames)
+		{
+			// partitioned on the game thread without the first block, which the tap filters render; a governor step only
+			// changes how many partitions are used, so nothing here costs an FFT
+			const int32 NumIRPartitions = FMath::DivideAndRoundUp(FMath::Max(NumFrames - ConvolutionBlockSize, 0), ConvolutionBlockSize);
+			for (int32 Channel = 0; Channel < 2; ++Channel)
+			{
+				const int32 Source = FMath::Min(Channel, ImpulseResponse->Prepared.Num() - 1);
+				Convolvers[Channel].SetImpulseResponse(ImpulseResponse->Prepared[Source], NumIRPartitions);
+			}
+			ImpulseResponseVersion = ImpulseResponse->Version;
+			ImpulseResponseFrames = NumFrames;
+		}
+	}
+
+	// material band changes only rescale the stored partitions, one multiply per bin and partition
+	const FFrequenSeeSourceParameters &Parameters = RenderState.Parameters;
+	if (MaterialResponseVersion != Parameters.MaterialResponseVersion)
+	{
+		const float *Gains = nullptr;
+		if (Parameters.MaterialResponseVersion != 0)
+		{
+			const float BinWidthHz = float(SamplingRate) / (2 * ConvolutionBlockSize);
+			FrequenSeeSpectrum::InterpolateBandGains(Parameters.MaterialBandResponse, AcousticBandCentersHz, AcousticBandCount,
+													 BinWidthHz, SpectralGains.GetData(), SpectralGains.Num());
+			Gains = SpectralGains.GetData();
+		}
+		for (FFrequenSeePartitionedConvolver &Convolver : Convolvers)
+		{
+			Convolver.SetSpectralGains(Gains, SpectralGains.Num());
+		}
+		MaterialResponseVersion = Parameters.MaterialResponseVersion;
+	}
+}
+
 void FFrequenSeeAudioReverbPlugin::ProcessSourceAudio(const FAudioPluginSourceInputData &InputData,
 													  FAudioPluginSourceOutputData &OutputData)
 {
-	const UAudioComponent *AudioComponent = UAudioComponent::GetAudioComponentFromID(InputData.AudioComponentId);
-	UFrequenSeeAudioComponent *FrequenSeeSourceComponent = AudioComponent->GetOwner()->FindComponentByClass<UFrequenSeeAudioComponent>();
-	if (!FrequenSeeSourceComponent)
+	SCOPE_CYCLE_COUNTER(STAT_FrequenSee_ReverbCallback);
+	const FFrequenSeeCallbackScope CallbackScope;
+
+	FFrequenSeeAudioReverbSource &Source = Sources[InputData.SourceId];
+	FFrequenSeeSourceRegistry::Get().Sync(Source.RenderState, InputData.AudioComponentId);
+	const FFrequenSeeSourceParameters &Parameters = Source.RenderState.Parameters;
+	const int32 NumInputChannels = InputData.NumChannels;
+	if (NumInputChannels <= 0 || (Parameters.bApplyReverb && !Source.Convolvers[0].IsInitialized()))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("FrequenSeeAudioComponent not found"));
+		FMemory::Memzero(OutputData.AudioBuffer.GetData(), sizeof(float) * OutputData.AudioBuffer.Num());
 		return;
 	}
-	bool bApplyReverb = FrequenSeeSourceComponent->bApplyReverb;
-	if (!bApplyReverb)
+
+	// the convolvers stage internally, so callbacks of any length are handled in FrameSize chunks of scratch
+	const int32 NumFrames = FMath::Min(InputData.AudioBuffer->Num() / NumInputChannels, OutputData.AudioBuffer.Num() / 2);
+
+	if (!Parameters.bApplyReverb)
 	{
-		FMemory::Memcpy(OutputData.AudioBuffer.GetData(), InputData.AudioBuffer->GetData(), sizeof(float) * FrameSize * 2);
+		// the dry signal passes through, up-mixed to stereo like the reverb input: mono sources feed both channels
+		const float *InBufferData = InputData.AudioBuffer->GetData();
+		float *OutBufferData = OutputData.AudioBuffer.GetData();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Channel = 0; Channel < 2; ++Channel)
+			{
+				OutBufferData[Frame * 2 + Channel] = InBufferData[Frame * NumInputChannels + FMath::Min(Channel, NumInputChannels - 1)];
+			}
+		}
+		FMemory::Memzero(OutBufferData + NumFrames * 2, sizeof(float) * (OutputData.AudioBuffer.Num() - NumFrames * 2));
 		return;
 	}
 
-	// get the impulse response
-	TArray<TArray<float>> &ImpulseResponse = FrequenSeeSourceComponent->GetImpulseResponse();
+	// the LOD policy picks the late reverb path. A clustered source sends to the submix only once the submix runs and
+	// the callback fits the send buffer, otherwise it convolves on its own. A switch crossfades over this callback and
+	// restarts the incoming path from silence, since it was not fed while inactive. Under the governor's bypass level
+	// only the early taps are left
+	EFrequenSeeLateReverbPath Path = EFrequenSeeLateReverbPath::Fdn;
+	if (FFrequenSeeCallbackMonitor::Get().GetQualityLevel() == EFrequenSeeQualityLevel::Bypass)
+	{
+		Path = EFrequenSeeLateReverbPath::None;
+	}
+	else if (Parameters.bUseConvolution)
+	{
+		const bool bCanSend = Clusters.IsValidIndex(Parameters.ReverbCluster) && ClusterBusBlock != 0 && NumFrames <= FrameSize;
+		Path = bCanSend ? EFrequenSeeLateReverbPath::Cluster : EFrequenSeeLateReverbPath::Convolution;
+	}
+	const EFrequenSeeLateReverbPath PreviousPath = Source.LateReverbPath;
+	const bool bSwitching = Path != PreviousPath;
+	if (bSwitching)
+	{
+		if (Path == EFrequenSeeLateReverbPath::Convolution)
+		{
+			for (FFrequenSeePartitionedConvolver &Convolver : Source.Convolvers)
+			{
+				Convolver.Reset();
+			}
+		}
+		else if (Path == EFrequenSeeLateReverbPath::Fdn)
+		{
+			Source.Fdn.Reset();
+		}
+		Source.LateReverbPath = Path;
+	}
+	const bool bRunConvolution = Path == EFrequenSeeLateReverbPath::Convolution || PreviousPath == EFrequenSeeLateReverbPath::Convolution;
+	const bool bRunSend = (Path == EFrequenSeeLateReverbPath::Cluster || PreviousPath == EFrequenSeeLateReverbPath::Cluster) && NumFrames <= FrameSize;
+	const bool bRunFdn = Path == EFrequenSeeLateReverbPath::Fdn || PreviousPath == EFrequenSeeLateReverbPath::Fdn;
+	const float FadeStep = bSwitching ? 1.0f / NumFrames : 0.0f;
+	auto PathGain = [Path, bSwitching, FadeStep](EFrequenSeeLateReverbPath RenderedPath, int32 Frame)
+	{
+		const float FadeIn = bSwitching ? (Frame + 1) * FadeStep : 1.0f;
+		return RenderedPath == Path ? FadeIn : 1.0f - FadeIn;
+	};
 
-	const int TailSize = AudioTailBufferLeft.GetSize();
+	if (bRunConvolution)
+	{
+		UpdateConvolvers(Source.RenderState, Source.Convolvers, Source.ImpulseResponseVersion, Source.ImpulseResponseFrames,
+						 Source.MaterialResponseVersion, Source.SpectralGains);
+	}
+
+	// a send fading out keeps its cluster and gain; a fresh one starts at its target gain
+	float SendGainStart = Source.ClusterSendGain;
+	float SendGainEnd = Source.ClusterSendGain;
+	if (Path == EFrequenSeeLateReverbPath::Cluster)
+	{
+		SendGainStart = PreviousPath == EFrequenSeeLateReverbPath::Cluster ? Source.ClusterSendGain : Parameters.ReverbClusterGain;
+		SendGainEnd = Parameters.ReverbClusterGain;
+		Source.ReverbCluster = Parameters.ReverbCluster;
+		Source.ClusterSendGain = SendGainEnd;
+	}
+	if (bRunSend)
+	{
+		Source.ClusterSendFrames = NumFrames;
+		Source.ClusterSendBlock = ClusterBusBlock;
+	}
 
-	// get the 47999 prev audio samples
-	AudioTailBufferLeft.GetLastSamples(CurrAudioTailLeft, TailSize);
-	AudioTailBufferRight.GetLastSamples(CurrAudioTailRight, TailSize);
-	// update the audio tail buffer with current audio samples
-	AudioTailBufferLeft.AddSamples(InputData.AudioBuffer->GetData(), FrameSize, 0, 2);
-	AudioTailBufferRight.AddSamples(InputData.AudioBuffer->GetData(), FrameSize, 1, 2);
-	// add the current audio samples to the current audio tail
-	FMemory::Memcpy(CurrAudioTailLeft.GetData() + TailSize, InputData.AudioBuffer->GetData(), sizeof(float) * FrameSize);
-	FMemory::Memcpy(CurrAudioTailRight.GetData() + TailSize, InputData.AudioBuffer->GetData(), sizeof(float) * FrameSize);
+	// early reflections are a handful of exact taps, identical for both channels since the tracer is mono
+	if (Source.ReflectionTapsVersion != Parameters.ReflectionTapsVersion)
+	{
+		const int32 NumTaps = FMath::Min(Parameters.NumReflectionTaps, Source.Taps.Num());
+		for (int32 Tap = 0; Tap < NumTaps; ++Tap)
+		{
+			Source.Taps[Tap].DelayFrames = Parameters.ReflectionTaps[Tap].DelaySeconds * SamplingRate;
+			Source.Taps[Tap].Gain = Parameters.ReflectionTaps[Tap].Gain;
+		}
+		for (FFrequenSeeSparseTapFilter &TapFilter : Source.TapFilters)
+		{
+			TapFilter.SetTaps(Source.Taps.GetData(), NumTaps);
+		}
+		Source.ReflectionTapsVersion = Parameters.ReflectionTapsVersion;
+	}
 
-	// LEFT
-	ConvolveFFT(ImpulseResponse[0], CurrAudioTailLeft, ConvOutputLeft);
+	// the impulse response head the convolvers skip is a short direct FIR, run whichever late path renders the tail
+	const FFrequenSeeImpulseResponse *ImpulseResponse = Source.RenderState.ImpulseResponse.Get();
+	const uint32 HeadResponseVersion = ImpulseResponse && ImpulseResponse->Channels.Num() > 0 ? ImpulseResponse->Version : 0;
+	if (Source.HeadResponseVersion != HeadResponseVersion)
+	{
+		for (int32 Channel = 0; Channel < 2; ++Channel)
+		{
+			if (HeadResponseVersion == 0)
+			{
+				Source.TapFilters[Channel].SetHead(nullptr, 0);
+				continue;
+			}
+			const FFrequenSeeAlignedFloats &ChannelResponse = ImpulseResponse->Channels[FMath::Min(Channel, ImpulseResponse->Channels.Num() - 1)];
+			Source.TapFilters[Channel].SetHead(ChannelResponse.GetData(), FMath::Min(ChannelResponse.Num(), Source.Convolvers[Channel].GetLatency()));
+		}
+		Source.HeadResponseVersion = HeadResponseVersion;
+	}
 
-	// RIGHT
-	ConvolveFFT(ImpulseResponse[1], CurrAudioTailRight, ConvOutputRight);
+	if (bRunFdn && (Source.FdnEnergy != Parameters.LateReverbEnergy ||
+					FMemory::Memcmp(Source.FdnT60, Parameters.LateReverbT60, sizeof(Source.FdnT60)) != 0))
+	{
+		Source.Fdn.SetDecay(Parameters.LateReverbT60[0], Parameters.LateReverbT60[1], Parameters.LateReverbT60[2], AcousticBandCentersHz[1]);
+		Source.Fdn.SetLevel(Parameters.LateReverbEnergy);
+		FMemory::Memcpy(Source.FdnT60, Parameters.LateReverbT60, sizeof(Source.FdnT60));
+		Source.FdnEnergy = Parameters.LateReverbEnergy;
+	}
 
-	// interleave into output
-	int CurrSampleStartIndex = TailSize;
-	float *OutBufferData = OutputData.AudioBuffer.GetData();
 	const float *InBufferData = InputData.AudioBuffer->GetData();
-	const float *LeftBufferData = ConvOutputLeft.GetData();
-	const float *RightBufferData = ConvOutputRight.GetData();
-	const float MixAlpha = 1.0f;
-	for (int SampleIndex = 0; SampleIndex < FrameSize; ++SampleIndex)
-	{
-		OutBufferData[SampleIndex * 2] = FMath::Clamp(LeftBufferData[CurrSampleStartIndex + SampleIndex], -1.0f, 1.0f) * MixAlpha +
-										 InBufferData[SampleIndex * 2] * (1.0f - MixAlpha);
-		OutBufferData[SampleIndex * 2 + 1] = FMath::Clamp(RightBufferData[CurrSampleStartIndex + SampleIndex], -1.0f, 1.0f) * MixAlpha +
-											 InBufferData[SampleIndex * 2 + 1] * (1.0f - MixAlpha);
+	float *OutBufferData = OutputData.AudioBuffer.GetData();
+	float *ChannelInput = Source.ChannelInput.GetData();
+	float *ChannelOutput = Source.ChannelOutput.GetData();
+	float *TapOutput = Source.TapOutput.GetData();
+	float *FdnOutput = Source.FdnOutput.GetData();
+	float *ClusterSend = Source.ClusterSend.GetData();
+	for (int32 ChunkStart = 0; ChunkStart < NumFrames; ChunkStart += FrameSize)
+	{
+		const int32 ChunkFrames = FMath::Min(FrameSize, NumFrames - ChunkStart);
+		for (int32 Channel = 0; Channel < 2; ++Channel)
+		{
+			// mono sources feed both convolvers
+			const int32 InputChannel = FMath::Min(Channel, NumInputChannels - 1);
+			for (int32 SampleIndex = 0; SampleIndex < ChunkFrames; ++SampleIndex)
+			{
+				ChannelInput[SampleIndex] = InBufferData[(ChunkStart + SampleIndex) * NumInputChannels + InputChannel];
+			}
+
+			Source.TapFilters[Channel].Process(ChannelInput, TapOutput, ChunkFrames);
+			if (bRunConvolution)
+			{
+				SCOPE_CYCLE_COUNTER(STAT_FrequenSee_Convolution);
+				Source.Convolvers[Channel].Process(ChannelInput, ChannelOutput, ChunkFrames);
+			}
+
+			// sends only run when the callback fits one chunk, so chunk and callback offsets coincide
+			if (bRunSend)
+			{
+				for (int32 SampleIndex = 0; SampleIndex < ChunkFrames; ++SampleIndex)
+				{
+					const float SendGain = FMath::Lerp(SendGainStart, SendGainEnd, float(SampleIndex + 1) / ChunkFrames);
+					ClusterSend[SampleIndex * 2 + Channel] = SendGain * PathGain(EFrequenSeeLateReverbPath::Cluster, SampleIndex) * ChannelInput[SampleIndex];
+				}
+			}
+
+			for (int32 SampleIndex = 0; SampleIndex < ChunkFrames; ++SampleIndex)
+			{
+				float Sample = TapOutput[SampleIndex];
+				if (bRunConvolution)
+				{
+					Sample += PathGain(EFrequenSeeLateReverbPath::Convolution, ChunkStart + SampleIndex) * ChannelOutput[SampleIndex];
+				}
+				OutBufferData[(ChunkStart + SampleIndex) * 2 + Channel] = Sample;
+			}
+		}
+
+		if (bRunFdn)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(FrequenSee::LateReverbFdn);
+			// the FDN is mono in, stereo out
+			const float DownmixScale = 1.0f / NumInputChannels;
+			for (int32 SampleIndex = 0; SampleIndex < ChunkFrames; ++SampleIndex)
+			{
+				float Sum = 0.0f;
+				for (int32 InputChannel = 0; InputChannel < NumInputChannels; ++InputChannel)
+				{
+					Sum += InBufferData[(ChunkStart + SampleIndex) * NumInputChannels + InputChannel];
+				}
+				ChannelInput[SampleIndex] = Sum * DownmixScale;
+			}
+			FMemory::Memzero(FdnOutput, sizeof(float) * 2 * ChunkFrames);
+			Source.Fdn.Process(ChannelInput, FdnOutput, ChunkFrames);
+
+			for (int32 SampleIndex = 0; SampleIndex < ChunkFrames; ++SampleIndex)
+			{
+				const float Gain = PathGain(EFrequenSeeLateReverbPath::Fdn, ChunkStart + SampleIndex);
+				OutBufferData[(ChunkStart + SampleIndex) * 2] += Gain * FdnOutput[SampleIndex * 2];
+				OutBufferData[(ChunkStart + SampleIndex) * 2 + 1] += Gain * FdnOutput[SampleIndex * 2 + 1];
+			}
+		}
+
+		for (int32 SampleIndex = 0; SampleIndex < 2 * ChunkFrames; ++SampleIndex)
+		{
+			float &Sample = OutBufferData[ChunkStart * 2 + SampleIndex];
+			Sample = FMath::Clamp(Sample, -1.0f, 1.0f);
+		}
 	}
 }
 
-void FFrequenSeeAudioReverbPlugin::ConvolveFFT(const TArray<float> &IR, const TArray<float> &Input, TArray<float> &Output)
+void FFrequenSeeAudioReverbPlugin::ProcessReverbClusters(float *OutBuffer, int32 NumFrames, int32 NumChannels)
 {
-	const int32 IRSize = IR.Num();		 // 48000
-	const int32 InputSize = Input.Num(); // 49023
-										 // const int32 ConvSize = InputSize + IRSize - 1; // 97022
-	const int32 ConvSize = Output.Num(); // 97022
+	SCOPE_CYCLE_COUNTER(STAT_FrequenSee_ClusterCallback);
+	const FFrequenSeeCallbackScope CallbackScope;
 
-	const int32 NumFreqBins = FFTSize / 2 + 1;
+	if (Clusters.Num() == 0 || NumChannels <= 0)
+	{
+		return;
+	}
 
-	// Prepare zero-padded input and IR
-	FMemory::Memcpy(InputPadded.GetData(), Input.GetData(), sizeof(float) * InputSize);
+	// a table caught mid-publish just keeps the previous one
+	FFrequenSeeSourceRegistry::Get().ReadReverbClusters(ClusterTable);
+	NumFrames = FMath::Min(NumFrames, FrameSize);
 
-	FMemory::Memcpy(IRPadded.GetData(), IR.GetData(), sizeof(float) * IRSize);
+	for (int32 Index = 0; Index < Clusters.Num(); ++Index)
+	{
+		FFrequenSeeAudioReverbCluster &Cluster = Clusters[Index];
+		const uint64 RepresentativeId = ClusterTable.RepresentativeIds[Index];
+		if (Cluster.RepresentativeId != RepresentativeId)
+		{
+			// a freed slot rings out with its last IR; a new representative's IR and materials are loaded below
+			Cluster.TailFrames = RepresentativeId == 0 && Cluster.bRendering ? FMath::CeilToInt32(SamplingRate * SimulatedDuration) : 0;
+			Cluster.RepresentativeId = RepresentativeId;
+			Cluster.ImpulseResponseVersion = 0;
+			Cluster.MaterialResponseVersion = MAX_uint32;
+		}
+		if (RepresentativeId != 0)
+		{
+			FFrequenSeeSourceRegistry::Get().Sync(Cluster.RenderState, RepresentativeId);
+			UpdateConvolvers(Cluster.RenderState, Cluster.Convolvers, Cluster.ImpulseResponseVersion, Cluster.ImpulseResponseFrames,
+							 Cluster.MaterialResponseVersion, Cluster.SpectralGains);
+		}
 
-	// Perform FFTs
-	kiss_fftr(ForwardCfg, InputPadded.GetData(), InputFreq.GetData());
-	kiss_fftr(ForwardCfg, IRPadded.GetData(), IRFreq.GetData());
+		Cluster.bRendering = RepresentativeId != 0 || Cluster.TailFrames > 0;
+		if (Cluster.bRendering)
+		{
+			FMemory::Memzero(Cluster.Input.GetData(), sizeof(float) * 2 * NumFrames);
+		}
+		else if (Cluster.TailFrames == 0 && Cluster.RenderState.AudioComponentId != 0)
+		{
+			for (FFrequenSeePartitionedConvolver &Convolver : Cluster.Convolvers)
+			{
+				Convolver.Reset();
+			}
+			Cluster.RenderState.Reset();
+		}
+	}
 
-	// Multiply frequency components
-	for (int32 i = 0; i < NumFreqBins; ++i)
+	// sum the sends the sources wrote for this block
+	for (const FFrequenSeeAudioReverbSource &Source : Sources)
 	{
-		const kiss_fft_cpx &A = InputFreq[i];
-		const kiss_fft_cpx &B = IRFreq[i];
-
-		// (a + bi)(c + di) = (ac - bd) + (ad + bc)i
-		OutputFreq[i].r = A.r * B.r - A.i * B.i;
-		OutputFreq[i].i = A.r * B.i + A.i * B.r;
+		if (ClusterBusBlock == 0 || Source.ClusterSendBlock != ClusterBusBlock || !Clusters.IsValidIndex(Source.ReverbCluster))
+		{
+			continue;
+		}
+		FFrequenSeeAudioReverbCluster &Cluster = Clusters[Source.ReverbCluster];
+		if (Cluster.bRendering)
+		{
+			const int32 SendSamples = 2 * FMath::Min(NumFrames, Source.ClusterSendFrames);
+			for (int32 SampleIndex = 0; SampleIndex < SendSamples; ++SampleIndex)
+			{
+				Cluster.Input[SampleIndex] += Source.ClusterSend[SampleIndex];
+			}
+		}
 	}
 
-	// IFFT
-	kiss_fftri(InverseCfg, OutputFreq.GetData(), TimeDomainOutput.GetData());
+	float *ChannelInput = ClusterChannelInput.GetData();
+	float *ChannelOutput = ClusterChannelOutput.GetData();
+	for (FFrequenSeeAudioReverbCluster &Cluster : Clusters)
+	{
+		if (!Cluster.bRendering)
+		{
+			continue;
+		}
+		for (int32 Channel = 0; Channel < 2; ++Channel)
+		{
+			for (int32 SampleIndex = 0; SampleIndex < NumFrames; ++SampleIndex)
+			{
+				ChannelInput[SampleIndex] = Cluster.Input[SampleIndex * 2 + Channel];
+			}
+			{
+				SCOPE_CYCLE_COUNTER(STAT_FrequenSee_Convolution);
+				Cluster.Convolvers[Channel].Process(ChannelInput, ChannelOutput, NumFrames);
+			}
+
+			const int32 OutputChannel = FMath::Min(Channel, NumChannels - 1);
+			for (int32 SampleIndex = 0; SampleIndex < NumFrames; ++SampleIndex)
+			{
+				OutBuffer[SampleIndex * NumChannels + OutputChannel] += ChannelOutput[SampleIndex];
+			}
+		}
+		if (Cluster.RepresentativeId == 0)
+		{
+			Cluster.TailFrames = FMath::Max(Cluster.TailFrames - NumFrames, 0);
+		}
+	}
 
-	// Normalize only the used output samples
-	const float Scale = 1.0f / FFTSize;
-	for (int32 i = IRSize - 1; i < ConvSize; ++i)
+	for (int32 SampleIndex = 0; SampleIndex < NumFrames * NumChannels; ++SampleIndex)
 	{
-		TimeDomainOutput[i] *= Scale;
+		OutBuffer[SampleIndex] = FMath::Clamp(OutBuffer[SampleIndex], -1.0f, 1.0f);
 	}
 
-	// Resize and copy the valid convolution output
-	FMemory::Memcpy(Output.GetData() + (IRSize - 1), TimeDomainOutput.GetData() + (IRSize - 1), FrameSize * sizeof(float));
+	// sources processed from now on belong to the next block; 0 stays reserved for "the submix never ran"
+	ClusterBusBlock = ClusterBusBlock == MAX_uint32 ? 1 : ClusterBusBlock + 1;
 }
 
 void NormalizeImpulseResponse(TArray<float> &IR)
@@ -252,7 +599,12 @@ UClass *FFrequenSeeAudioReverbPluginFactory::GetCustomReverbSettingsClass() cons
 	return UFrequenSeeAudioReverbSettings::StaticClass();
 }
 
-FFrequenSeeAudioReverbSubmixPlugin::FFrequenSeeAudioReverbSubmixPlugin() {}
+FFrequenSeeAudioReverbSubmixPlugin::FFrequenSeeAudioReverbSubmixPlugin()
+	: ReverbPlugin(nullptr),
+	  bApplyReverb(true),
+	  SampleRate(0.0f)
+{
+}
 
 FFrequenSeeAudioReverbSubmixPlugin::~FFrequenSeeAudioReverbSubmixPlugin() {}
 
@@ -262,11 +614,31 @@ uint32 FFrequenSeeAudioReverbSubmixPlugin::GetDesiredInputChannelCountOverride()
 	return 2;
 }
 
+void FFrequenSeeAudioReverbSubmixPlugin::Init(const FSoundEffectSubmixInitData &InitData)
+{
+	SampleRate = InitData.SampleRate;
+}
+
 /** Processes the audio flowing through the submix. */
 void FFrequenSeeAudioReverbSubmixPlugin::OnProcessAudio(const FSoundEffectSubmixInputData &InData, FSoundEffectSubmixOutputData &OutData)
 {
+	// the per-source reverb arrives already rendered and passes through; the shared clusters are added on top
+	const int32 NumSamples = FMath::Min(InData.AudioBuffer->Num(), OutData.AudioBuffer->Num());
+	FMemory::Memcpy(OutData.AudioBuffer->GetData(), InData.AudioBuffer->GetData(), sizeof(float) * NumSamples);
+
+	if (ReverbPlugin && bApplyReverb)
+	{
+		ReverbPlugin->ProcessReverbClusters(OutData.AudioBuffer->GetData(), NumSamples / OutData.NumChannels, OutData.NumChannels);
+	}
 
-	// UE_LOG(LogTemp, Warning, TEXT("SUBMIX PLUGIN PROCESSING"));
+	// every FrequenSee callback of this block has run by now
+	FFrequenSeeCallbackMonitor::Get().EndBuffer(NumSamples / FMath::Max(OutData.NumChannels, 1), SampleRate);
+}
+
+void FFrequenSeeAudioReverbSubmixPlugin::OnPresetChanged()
+{
+	GET_EFFECT_SETTINGS(FrequenSeeAudioReverbSubmixPlugin);
+	bApplyReverb = Settings.bApplyReverb;
 }
 
 /** Called to specify the singleton reverb plugin instance. */
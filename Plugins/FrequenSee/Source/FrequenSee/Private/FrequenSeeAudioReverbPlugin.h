@@ -3,10 +3,25 @@
 #include "FrequenSeeAudioComponent.h"
 #include "Sound/SoundEffectSubmix.h"
 #include "FrequenSeeAudioReverbSettings.h"
-#include "CircularBuffer.h"
-#include "FrequenSeeFFTConvolver/KissFFT/kiss_fftr.h"
+#include "FrequenSeePartitionedConvolver.h"
+#include "FrequenSeeSparseTapFilter.h"
+#include "FrequenSeeFDNReverb.h"
+#include "FrequenSeeSourceRegistry.h"
 #include "FrequenSeeAudioReverbPlugin.generated.h"
 
+/** Where a source's late reverb is rendered. */
+enum class EFrequenSeeLateReverbPath : uint8
+{
+	/** The source's own convolvers. */
+	Convolution,
+	/** A shared cluster convolver on the reverb submix, fed through the source's send. */
+	Cluster,
+	/** The parametric FDN fallback. */
+	Fdn,
+	/** No late reverb, only the early reflection taps; what the callback governor falls back to last. */
+	None,
+};
+
 struct FFrequenSeeAudioReverbSource
 {
 	FFrequenSeeAudioReverbSource();
@@ -20,9 +35,86 @@ struct FFrequenSeeAudioReverbSource
 
 	float PrevDuration;
 
+	/** Parameters and impulse response published by the component this source voice renders. */
+	FFrequenSeeSourceRenderState RenderState;
+
+	/** One convolver per output channel, sized on first use and reused by later sources in this slot. */
+	FFrequenSeePartitionedConvolver Convolvers[2];
+
+	/** Version of the RenderState impulse response currently loaded into Convolvers; 0 if none. */
+	uint32 ImpulseResponseVersion;
+
+	/** How many frames of that impulse response the callback governor let through. */
+	int32 ImpulseResponseFrames;
+
+	/** MaterialResponseVersion folded into the convolvers' IR spectra; 0 means flat. */
+	uint32 MaterialResponseVersion;
+
+	/** Per-bin material gains handed to the convolvers, one per convolver bin. */
+	TArray<float> SpectralGains;
+
+	/** Discrete early reflections and the impulse response head per output channel, rendered ahead of the late tail. */
+	FFrequenSeeSparseTapFilter TapFilters[2];
+
+	/** ReflectionTapsVersion currently loaded into TapFilters; 0 means none. */
+	uint32 ReflectionTapsVersion;
+
+	/** Version of the RenderState impulse response whose head, the convolvers' latency, is loaded into TapFilters. */
+	uint32 HeadResponseVersion;
+
+	/** Render-side tap scratch, converted from seconds to frames. */
+	TArray<FFrequenSeeSparseTap> Taps;
+
+	/** Parametric late reverb used instead of Convolvers when the LOD policy demotes this source. */
+	FFrequenSeeFDNReverb Fdn;
+
+	/** Late reverb parameters currently loaded into Fdn. */
+	float FdnT60[AcousticBandCount];
+	float FdnEnergy;
+
+	/** Which late reverb path rendered the previous callback; a change crossfades over one callback. */
+	EFrequenSeeLateReverbPath LateReverbPath;
+
+	/** Cluster the send goes to, kept while a switch away from it fades out, and the send gain reached. */
+	int32 ReverbCluster;
+	float ClusterSendGain;
+
+	/** Interleaved stereo dry send for the cluster bus, FrameSize frames, and the bus block it was written for. */
+	TArray<float> ClusterSend;
+	int32 ClusterSendFrames;
+	uint32 ClusterSendBlock;
+
+	/** De-interleaved input and output of one channel, FrameSize samples each. */
+	TArray<float> ChannelInput;
+	TArray<float> ChannelOutput;
+	TArray<float> TapOutput;
+	/** Interleaved stereo FDN output, FrameSize frames. */
+	TArray<float> FdnOutput;
+
 	void ClearBuffers();
 };
 
+/** One shared late reverb on the reverb submix: its members' summed sends convolved with its representative's IR. */
+struct FFrequenSeeAudioReverbCluster
+{
+	/** Component whose IR the cluster uses; 0 once the slot is freed. */
+	uint64 RepresentativeId = 0;
+	FFrequenSeeSourceRenderState RenderState;
+
+	FFrequenSeePartitionedConvolver Convolvers[2];
+	uint32 ImpulseResponseVersion = 0;
+	int32 ImpulseResponseFrames = 0;
+	uint32 MaterialResponseVersion = 0;
+	TArray<float> SpectralGains;
+
+	/** Interleaved stereo sum of the members' sends, FrameSize frames. */
+	TArray<float> Input;
+
+	/** Frames a freed slot keeps convolving silence so its tail rings out instead of cutting off. */
+	int32 TailFrames = 0;
+	bool bRendering = false;
+};
+
 class FFrequenSeeAudioReverbPlugin : public IAudioReverb
 {
 public:
@@ -46,8 +138,45 @@ public:
 	virtual void ProcessSourceAudio(const FAudioPluginSourceInputData &InputData,
 									FAudioPluginSourceOutputData &OutputData) override;
 
+	/**
+	 * Convolves every shared reverb cluster's summed sends from this block and adds the result to OutBuffer.
+	 * Called by the reverb submix once per block, after all sources were processed.
+	 */
+	void ProcessReverbClusters(float *OutBuffer, int32 NumFrames, int32 NumChannels);
+
+	/**
+	 * Convolver partition size, independent of the device callback size; adds this many frames of latency. Published
+	 * impulse responses are partitioned with it on the game thread.
+	 */
+	static constexpr int32 ConvolutionBlockSize = 256;
+
 private:
+
+	/**
+	 * Convolver length for an IR of DurationSeconds at the device rate. The convolver latency is compensated by
+	 * dropping the IR's first block, which the early taps cover.
+	 */
+	int32 GetConvolutionIRSize(float DurationSeconds) const
+	{
+		return FMath::Max(FMath::CeilToInt32(SamplingRate * DurationSeconds) - ConvolutionBlockSize, ConvolutionBlockSize);
+	}
+	int32 NumConvolutionPartitions(float DurationSeconds) const;
+
+	/** Sizes the convolvers for impulse responses of DurationSeconds at the device rate. */
+	void InitConvolvers(FFrequenSeePartitionedConvolver (&Convolvers)[2], TArray<float> &SpectralGains, float DurationSeconds) const;
+
+	/**
+	 * Points the convolvers at a newly published IR's prepared partitions and loads the material band response from
+	 * RenderState, and shortens or restores the IR by partition count when the callback governor changes how much of it
+	 * may be convolved.
+	 */
+	void UpdateConvolvers(const FFrequenSeeSourceRenderState &RenderState, FFrequenSeePartitionedConvolver (&Convolvers)[2],
+						  uint32 &ImpulseResponseVersion, int32 &ImpulseResponseFrames, uint32 &MaterialResponseVersion,
+						  TArray<float> &SpectralGains) const;
+
+	/** The audio device's rate, which published impulse responses are resampled to. */
 	int SamplingRate = 0;
+	/** IR length of sources without FrequenSee reverb settings and of the shared clusters; longer IRs are truncated there. */
 	float SimulatedDuration = 1.0f;
 	int FrameSize = 0;
 	// each render frame
@@ -57,29 +186,23 @@ private:
 	// audio buffer num
 	int AudioBufferNum = 0;
 
-	FCircularAudioBuffer AudioTailBufferLeft;
-	FCircularAudioBuffer AudioTailBufferRight;
-	TArray<float> CurrAudioTailLeft;
-	TArray<float> CurrAudioTailRight;
-	TArray<float> ConvOutputLeft;
-	TArray<float> ConvOutputRight;
-	kiss_fftr_cfg ForwardCfg;
-	kiss_fftr_cfg InverseCfg;
-	TArray<kiss_fft_cpx> OutputFreq;
-	TArray<kiss_fft_cpx> InputFreq;
-	TArray<kiss_fft_cpx> IRFreq;
-	TArray<float> TimeDomainOutput;
-	TArray<float> IRPadded;
-	TArray<float> InputPadded;
-	int32 FFTSize;
-
 	TArray<FFrequenSeeAudioReverbSource> Sources;
 
+	/** Shared reverb slots, one per FFrequenSeeReverbClusters entry, and the last cluster table read. */
+	TArray<FFrequenSeeAudioReverbCluster> Clusters;
+	FFrequenSeeReverbClusters ClusterTable;
+	TArray<float> ClusterChannelInput;
+	TArray<float> ClusterChannelOutput;
+
+	/**
+	 * Counts reverb submix blocks. Sources stamp their sends with it and the submix only sums sends stamped with the
+	 * current block. 0 until the submix first runs, in which case clustered sources convolve on their own.
+	 */
+	uint32 ClusterBusBlock = 0;
+
 	TWeakObjectPtr<USoundSubmix> ReverbSubmix;
 
 	FSoundEffectSubmixPtr ReverbSubmixEffect;
-
-	void ConvolveFFT(const TArray<float> &IR, const TArray<float> &Input, TArray<float> &Output);
 };
 
 class FFrequenSeeAudioReverbPluginFactory : public IAudioReverbFactory
@@ -112,14 +235,24 @@ public:
 	/** Returns the number of channels to use for input and output. */
 	virtual uint32 GetDesiredInputChannelCountOverride() const override;
 
+	virtual void Init(const FSoundEffectSubmixInitData &InitData) override;
+
 	/** Processes the audio flowing through the submix. */
 	virtual void OnProcessAudio(const FSoundEffectSubmixInputData &InData, FSoundEffectSubmixOutputData &OutData) override;
 
+	/** Reads bApplyReverb from the preset. */
+	virtual void OnPresetChanged() override;
+
 	/** Called to specify the singleton reverb plugin instance. */
 	void SetReverbPlugin(FFrequenSeeAudioReverbPlugin *Plugin);
 
 private:
 	FFrequenSeeAudioReverbPlugin *ReverbPlugin;
+
+	bool bApplyReverb;
+
+	/** Rate the submix runs at, for the callback monitor's per-buffer budget. */
+	float SampleRate;
 };
 
 USTRUCT(BlueprintType)
@@ -0,0 +1,247 @@
+#include "CircularBuffer.h"
+#include "FrequenSeeBenchmark.h"
+#include "FrequenSeeFDNReverb.h"
+#include "FrequenSeePartitionedConvolver.h"
+#include "FrequenSeeRealFFT.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	constexpr int32 CallbackFrames = 1024;
+	constexpr int32 NumChannels = 2;
+	/** Timed callbacks per run; every timing is the median over NumRuns runs. */
+	constexpr int32 NumCallbacks = 48;
+	constexpr int32 NumRuns = 5;
+
+	using FMetrics = std::vector<FrequenSeeCore::FBenchmarkMetric>;
+
+	void AddMetric(FMetrics& Metrics, const FString& Name, double Value, const TCHAR* Unit)
+	{
+		Metrics.push_back({ std::string(TCHAR_TO_UTF8(*Name)), Value, std::string(TCHAR_TO_UTF8(Unit)) });
+	}
+
+	/** Median over NumRuns of the seconds one call of Body takes. */
+	template <typename FunctionType>
+	double MedianSeconds(FunctionType&& Body)
+	{
+		TArray<double, TInlineAllocator<NumRuns>> Seconds;
+		for (int32 Run = 0; Run < NumRuns; ++Run)
+		{
+			const double Start = FPlatformTime::Seconds();
+			Body();
+			Seconds.Add(FPlatformTime::Seconds() - Start);
+		}
+		Seconds.Sort();
+		return Seconds[NumRuns / 2];
+	}
+
+	/** White noise, fading out by 60 dB over its length if bDecaying, like an impulse response. */
+	TArray<float> MakeNoise(FRandomStream& Random, int32 Num, bool bDecaying)
+	{
+		TArray<float> Samples;
+		Samples.SetNumUninitialized(Num);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Samples[i] = Random.FRandRange(-1.0f, 1.0f) * (bDecaying ? FMath::Exp(-6.9f * i / Num) : 1.0f);
+		}
+		return Samples;
+	}
+
+	void BenchmarkPartitionedConvolver(FMetrics& Metrics, FRandomStream& Random)
+	{
+		TArray<float> Buffer = MakeNoise(Random, CallbackFrames * NumChannels, false);
+		for (const int32 IRLength : { 24000, 48000, 96000 })
+		{
+			const TArray<float> IR = MakeNoise(Random, IRLength, true);
+			for (const int32 BlockSize : { 128, 256, 512 })
+			{
+				FFrequenSeePartitionedConvolver Convolver;
+				Convolver.Init(BlockSize, IRLength, NumChannels);
+				Convolver.SetImpulseResponse(IR.GetData(), IRLength);
+				// Fill the delay line so every partition contributes
+				for (int32 Frame = 0; Frame < IRLength; Frame += CallbackFrames)
+				{
+					Convolver.Process(Buffer.GetData(), Buffer.GetData(), CallbackFrames);
+				}
+
+				const double Seconds = MedianSeconds([&]()
+				{
+					for (int32 Callback = 0; Callback < NumCallbacks; ++Callback)
+					{
+						Convolver.Process(Buffer.GetData(), Buffer.GetData(), CallbackFrames);
+					}
+				});
+				AddMetric(Metrics, FString::Printf(TEXT("convolver.partitioned.block%d.ir%d.ms_per_callback"), BlockSize, IRLength),
+				          Seconds * 1000.0 / NumCallbacks, TEXT("ms"));
+			}
+		}
+	}
+
+	/**
+	 * The convolution the reverb plugin ran before the partitioned convolver (ConvolveFFT): per callback and channel,
+	 * the last IRLength - 1 input samples from an FCircularAudioBuffer plus the new frames, convolved with the whole IR
+	 * in one FFT that also re-transforms the IR. Kept here as the baseline the convolver is tracked against.
+	 */
+	void BenchmarkWholeIRConvolution(FMetrics& Metrics, FRandomStream& Random)
+	{
+		const TArray<float> Input = MakeNoise(Random, CallbackFrames * NumChannels, false);
+		for (const int32 IRLength : { 24000, 48000 })
+		{
+			const int32 TailSize = IRLength - 1;
+			const int32 InputSize = TailSize + CallbackFrames;
+			const int32 FFTSize = FMath::RoundUpToPowerOfTwo(InputSize + IRLength - 1);
+
+			FFrequenSeeRealFFT FFT(FFTSize);
+			FSplitComplexSpectrum InputSpectrum, IRSpectrum, OutputSpectrum;
+			InputSpectrum.Init(FFT.GetNumBins());
+			IRSpectrum.Init(FFT.GetNumBins());
+			OutputSpectrum.Init(FFT.GetNumBins());
+
+			TArray<float> IRPadded = MakeNoise(Random, IRLength, true);
+			IRPadded.SetNumZeroed(FFTSize);
+			TArray<float> InputPadded, TimeDomainOutput, Tail;
+			InputPadded.SetNumZeroed(FFTSize);
+			TimeDomainOutput.SetNumUninitialized(FFTSize);
+			Tail.SetNumUninitialized(InputSize);
+			FCircularAudioBuffer TailBuffers[NumChannels] = { FCircularAudioBuffer(IRLength), FCircularAudioBuffer(IRLength) };
+
+			const double Seconds = MedianSeconds([&]()
+			{
+				for (int32 Callback = 0; Callback < NumCallbacks; ++Callback)
+				{
+					for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+					{
+						TailBuffers[Channel].GetLastSamples(Tail, TailSize);
+						TailBuffers[Channel].AddSamples(Input.GetData(), CallbackFrames, Channel, NumChannels);
+						for (int32 Frame = 0; Frame < CallbackFrames; ++Frame)
+						{
+							Tail[TailSize + Frame] = Input[Frame * NumChannels + Channel];
+						}
+
+						FMemory::Memcpy(InputPadded.GetData(), Tail.GetData(), sizeof(float) * InputSize);
+						FFT.Forward(InputPadded.GetData(), InputSpectrum);
+						FFT.Forward(IRPadded.GetData(), IRSpectrum);
+						FrequenSeeSpectrum::Multiply(InputSpectrum, IRSpectrum, OutputSpectrum);
+						FFT.Inverse(OutputSpectrum, TimeDomainOutput.GetData());
+					}
+				}
+			});
+			AddMetric(Metrics, FString::Printf(TEXT("convolver.whole_ir_fft.ir%d.ms_per_callback"), IRLength),
+			          Seconds * 1000.0 / NumCallbacks, TEXT("ms"));
+		}
+	}
+
+	void BenchmarkFDN(FMetrics& Metrics, FRandomStream& Random)
+	{
+		const TArray<float> Input = MakeNoise(Random, CallbackFrames, false);
+		TArray<float> Output;
+		Output.SetNumUninitialized(CallbackFrames * FFrequenSeeFDNReverb::NumOutputs);
+
+		FFrequenSeeFDNReverb Fdn;
+		Fdn.Init(48000.0f);
+		Fdn.SetDecay(1.0f, 1.0f, 1.0f, 1000.0f);
+		Fdn.SetLevel(1.0f);
+
+		const double Seconds = MedianSeconds([&]()
+		{
+			for (int32 Callback = 0; Callback < NumCallbacks; ++Callback)
+			{
+				Fdn.Process(Input.GetData(), Output.GetData(), CallbackFrames);
+			}
+		});
+		AddMetric(Metrics, TEXT("late_reverb.fdn.ms_per_callback"), Seconds * 1000.0 / NumCallbacks, TEXT("ms"));
+	}
+
+	void BenchmarkCircularBuffer(FMetrics& Metrics, FRandomStream& Random)
+	{
+		constexpr int32 BufferSize = 48000;
+		const TArray<float> Input = MakeNoise(Random, CallbackFrames * NumChannels, false);
+		TArray<float> Tail;
+		Tail.SetNumUninitialized(BufferSize);
+		FCircularAudioBuffer Buffer(BufferSize);
+
+		// One channel of interleaved input per call, as the reverb plugin fed it
+		const double AddSeconds = MedianSeconds([&]()
+		{
+			for (int32 Callback = 0; Callback < NumCallbacks; ++Callback)
+			{
+				Buffer.AddSamples(Input.GetData(), CallbackFrames, Callback % NumChannels, NumChannels);
+			}
+		});
+		const double GetSeconds = MedianSeconds([&]()
+		{
+			for (int32 Callback = 0; Callback < NumCallbacks; ++Callback)
+			{
+				Buffer.GetLastSamples(Tail, BufferSize - 1);
+			}
+		});
+		AddMetric(Metrics, TEXT("circular_buffer.add_samples_per_second"), double(NumCallbacks) * CallbackFrames / AddSeconds, TEXT("1/s"));
+		AddMetric(Metrics, TEXT("circular_buffer.get_last_samples_per_second"), double(NumCallbacks) * (BufferSize - 1) / GetSeconds, TEXT("1/s"));
+	}
+
+	/**
+	 * FrequenSee.Bench.Json [OutputPath] [CommitId]
+	 * Runs the simulation core's tracer benchmarks on the canned scenes (the same FrequenSeeBench runs headless) and
+	 * times the audio-thread DSP per stereo 1024-frame callback: the partitioned convolver across IR lengths and block
+	 * sizes, the whole-IR FFT convolution it replaced, the FDN and FCircularAudioBuffer. Writes one JSON document,
+	 * by default to Saved/FrequenSee/.
+	 */
+	void RunJsonBenchmarks(const TArray<FString>& Args)
+	{
+		const FString OutputPath = Args.Num() > 0
+			? Args[0]
+			: FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FrequenSee"), FString::Printf(TEXT("Bench-%s.json"), *FDateTime::Now().ToString()));
+
+		FMetrics Metrics;
+		const FrequenSeeCore::FTracerBenchmarkSettings TracerSettings;
+		for (int32 Scene = 0; Scene < FrequenSeeCore::NumCannedScenes; ++Scene)
+		{
+			FrequenSeeCore::RunTracerBenchmark(static_cast<FrequenSeeCore::ECannedScene>(Scene), TracerSettings, Metrics);
+			FrequenSeeCore::RunImageSourceBenchmark(static_cast<FrequenSeeCore::ECannedScene>(Scene), TracerSettings,
+			                                        FrequenSeeCore::FImageSourceSettings(), Metrics);
+		}
+		for (const FrequenSeeCore::EPathEstimator Estimator : { FrequenSeeCore::EPathEstimator::Bidirectional, FrequenSeeCore::EPathEstimator::DiffuseRain })
+		{
+			if (!FrequenSeeCore::RunShoeboxValidation(TracerSettings, Estimator, Metrics))
+			{
+				UE_LOG(LogTemp, Error, TEXT("FrequenSee.Bench.Json: the %s estimator failed the shoebox validation"),
+				       Estimator == FrequenSeeCore::EPathEstimator::DiffuseRain ? TEXT("diffuse rain") : TEXT("bidirectional"));
+			}
+		}
+
+		FRandomStream Random(1234);
+		BenchmarkPartitionedConvolver(Metrics, Random);
+		BenchmarkWholeIRConvolution(Metrics, Random);
+		BenchmarkFDN(Metrics, Random);
+		BenchmarkCircularBuffer(Metrics, Random);
+
+		std::vector<std::pair<std::string, std::string>> Context;
+		Context.emplace_back("suite", "FrequenSee.Bench.Json");
+		if (Args.Num() > 1)
+		{
+			Context.emplace_back("commit", TCHAR_TO_UTF8(*Args[1]));
+		}
+		Context.emplace_back("build", TCHAR_TO_UTF8(LexToString(FApp::GetBuildConfiguration())));
+		Context.emplace_back("platform", TCHAR_TO_UTF8(ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName())));
+		Context.emplace_back("spectrum_kernel", TCHAR_TO_UTF8(FrequenSeeSpectrum::GetKernelName()));
+		Context.emplace_back("time", TCHAR_TO_UTF8(*FDateTime::UtcNow().ToIso8601()));
+		const std::string Json = FrequenSeeCore::FormatBenchmarkJson(Context, Metrics);
+
+		if (!FFileHelper::SaveStringToFile(FString(UTF8_TO_TCHAR(Json.c_str())), *OutputPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FrequenSee.Bench.Json: cannot write %s"), *OutputPath);
+			return;
+		}
+		UE_LOG(LogTemp, Display, TEXT("FrequenSee.Bench.Json: %d metrics written to %s"),
+		       static_cast<int32>(Metrics.size()), *FPaths::ConvertRelativePathToFull(OutputPath));
+	}
+
+	FAutoConsoleCommand JsonBenchmarkCommand(
+		TEXT("FrequenSee.Bench.Json"),
+		TEXT("Runs the tracer, IR synthesis, convolver, FDN and circular buffer benchmarks and writes the results as JSON. Args: [OutputPath] [CommitId]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunJsonBenchmarks));
+}
@@ -0,0 +1,132 @@
+#include "FrequenSeeCallbackMonitor.h"
+
+#include "FrequenSeeStats.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarGovernorEnable(
+	TEXT("FrequenSee.Governor.Enable"), 1,
+	TEXT("1 to step reverb quality down (shorter IRs, fewer convolutions, FDN only, bypass) while the audio callbacks run close to their deadline."));
+
+static TAutoConsoleVariable<float> CVarGovernorStepDownLoad(
+	TEXT("FrequenSee.Governor.StepDownLoad"), 0.8f,
+	TEXT("99th percentile of FrequenSee's callback time per mixer buffer, as a fraction of the buffer's duration, at which quality steps down."));
+
+static TAutoConsoleVariable<float> CVarGovernorStepUpLoad(
+	TEXT("FrequenSee.Governor.StepUpLoad"), 0.4f,
+	TEXT("99th percentile of FrequenSee's callback time per mixer buffer, as a fraction of the buffer's duration, below which quality steps back up."));
+
+FFrequenSeeCallbackMonitor& FFrequenSeeCallbackMonitor::Get()
+{
+	static FFrequenSeeCallbackMonitor Monitor;
+	return Monitor;
+}
+
+void FFrequenSeeCallbackMonitor::EndBuffer(int32 NumFrames, float SampleRate)
+{
+	const uint64 Cycles = PendingCycles.exchange(0, std::memory_order_relaxed);
+	if (NumFrames <= 0 || SampleRate <= 0.0f)
+	{
+		return;
+	}
+
+	const double BudgetSeconds = NumFrames / double(SampleRate);
+	const double Load = FPlatformTime::ToSeconds64(Cycles) / BudgetSeconds;
+	if (Load > 1.0)
+	{
+		INC_DWORD_STAT(STAT_FrequenSee_DeadlineMisses);
+	}
+	++Histograms[CurrentWindow][FMath::Min(static_cast<int32>(Load * BinsPerBudget), NumBins - 1)];
+
+	const int32 BuffersPerWindow = FMath::Max(1, FMath::RoundToInt32(WindowSeconds / BudgetSeconds));
+	if (++BuffersInWindow < BuffersPerWindow)
+	{
+		return;
+	}
+
+	// The next window replaces the oldest one
+	BuffersInWindow = 0;
+	CurrentWindow = (CurrentWindow + 1) % NumWindows;
+	FMemory::Memzero(Histograms[CurrentWindow], sizeof(Histograms[CurrentWindow]));
+	NumCompletedWindows = FMath::Min(NumCompletedWindows + 1, NumWindows - 1);
+
+	const float P99 = GetLoadPercentile(0.99f);
+	SET_FLOAT_STAT(STAT_FrequenSee_CallbackLoadP99, P99 * 100.0f);
+
+	// Every step is judged on a full history measured at the new level
+	const uint8 Level = QualityLevel.load(std::memory_order_relaxed);
+	uint8 NewLevel = Level;
+	if (CVarGovernorEnable.GetValueOnAnyThread() == 0)
+	{
+		NewLevel = static_cast<uint8>(EFrequenSeeQualityLevel::Full);
+	}
+	else if (NumCompletedWindows == NumWindows - 1)
+	{
+		if (P99 >= CVarGovernorStepDownLoad.GetValueOnAnyThread() && Level < static_cast<uint8>(EFrequenSeeQualityLevel::Bypass))
+		{
+			++NewLevel;
+		}
+		else if (P99 <= CVarGovernorStepUpLoad.GetValueOnAnyThread() && Level > static_cast<uint8>(EFrequenSeeQualityLevel::Full))
+		{
+			--NewLevel;
+		}
+	}
+	if (NewLevel != Level)
+	{
+		QualityLevel.store(NewLevel, std::memory_order_relaxed);
+		ResetHistogram();
+	}
+	SET_DWORD_STAT(STAT_FrequenSee_QualityLevel, NewLevel);
+}
+
+int32 FFrequenSeeCallbackMonitor::LimitConvolutionSources(int32 MaxSources) const
+{
+	switch (GetQualityLevel())
+	{
+	case EFrequenSeeQualityLevel::Full:
+	case EFrequenSeeQualityLevel::ShortImpulseResponse:
+		return MaxSources;
+	case EFrequenSeeQualityLevel::HalfConvolution:
+		return (MaxSources + 1) / 2;
+	default:
+		return 0;
+	}
+}
+
+int32 FFrequenSeeCallbackMonitor::LimitImpulseResponseFrames(int32 NumFrames) const
+{
+	return GetQualityLevel() >= EFrequenSeeQualityLevel::ShortImpulseResponse ? NumFrames / 2 : NumFrames;
+}
+
+float FFrequenSeeCallbackMonitor::GetLoadPercentile(float Percentile) const
+{
+	uint64 Counts[NumBins] = {};
+	uint64 Total = 0;
+	for (const uint32 (&Histogram)[NumBins] : Histograms)
+	{
+		for (int32 Bin = 0; Bin < NumBins; ++Bin)
+		{
+			Counts[Bin] += Histogram[Bin];
+			Total += Histogram[Bin];
+		}
+	}
+
+	const uint64 Rank = static_cast<uint64>(FMath::CeilToDouble(Percentile * Total));
+	uint64 Cumulative = 0;
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		Cumulative += Counts[Bin];
+		if (Cumulative >= Rank && Cumulative > 0)
+		{
+			// The bin's upper edge, so a percentile only reads as in budget if it really is
+			return float(Bin + 1) / BinsPerBudget;
+		}
+	}
+	return 0.0f;
+}
+
+void FFrequenSeeCallbackMonitor::ResetHistogram()
+{
+	FMemory::Memzero(Histograms, sizeof(Histograms));
+	BuffersInWindow = 0;
+	NumCompletedWindows = 0;
+}
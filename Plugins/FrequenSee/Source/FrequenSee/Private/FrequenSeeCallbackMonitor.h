@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** How far the governor has stepped the reverb down to keep the audio callbacks in budget, cheapest last. */
+enum class EFrequenSeeQualityLevel : uint8
+{
+	Full,
+	/** Convolution impulse responses are cut to half their length. */
+	ShortImpulseResponse,
+	/** Only half of FrequenSee.Reverb.MaxConvolutionSources (rounded up) convolve; the rest render the FDN. */
+	HalfConvolution,
+	/** Every source renders the FDN. */
+	FdnOnly,
+	/** No late reverb at all, only the early reflection taps. */
+	Bypass,
+};
+
+/**
+ * Times FrequenSee's audio callbacks per mixer buffer and degrades quality when they get close to the buffer's
+ * deadline.
+ *
+ * Every reverb and occlusion callback adds its cycles through FFrequenSeeCallbackScope; the reverb submix, which runs
+ * once per buffer after the sources, closes the buffer with EndBuffer(). The summed time as a fraction of the buffer's
+ * duration goes into a histogram rolling over the last couple of seconds, and whenever its 99th percentile crosses
+ * FrequenSee.Governor.StepDownLoad the quality level drops one step, or rises one once it is back under StepUpLoad.
+ * The level is read lock-free by the reverb plugin (IR length, bypass) and the game thread's reverb LOD (how many
+ * sources convolve).
+ */
+class FFrequenSeeCallbackMonitor
+{
+public:
+	static FFrequenSeeCallbackMonitor& Get();
+
+	/** Any render thread. */
+	void AddCallbackCycles(uint64 Cycles) { PendingCycles.fetch_add(Cycles, std::memory_order_relaxed); }
+
+	/** Audio render thread, once per mixer buffer of NumFrames, after the source callbacks. */
+	void EndBuffer(int32 NumFrames, float SampleRate);
+
+	/** Any thread. */
+	EFrequenSeeQualityLevel GetQualityLevel() const { return static_cast<EFrequenSeeQualityLevel>(QualityLevel.load(std::memory_order_relaxed)); }
+
+	/** How many of MaxSources may convolve at the current level. */
+	int32 LimitConvolutionSources(int32 MaxSources) const;
+
+	/** Longest convolution IR, in frames, allowed for an IR of NumFrames at the current level. */
+	int32 LimitImpulseResponseFrames(int32 NumFrames) const;
+
+private:
+	/** Load (callback time over buffer duration) that Percentile of the buffers in the history stay under. */
+	float GetLoadPercentile(float Percentile) const;
+	void ResetHistogram();
+
+	/** Load histogram resolution: bins per buffer duration, and bins up to the last one, which takes everything above. */
+	static constexpr int32 BinsPerBudget = 64;
+	static constexpr int32 NumBins = 2 * BinsPerBudget;
+	/** The histogram rolls over NumWindows windows of WindowSeconds, the oldest replaced as a new one starts. */
+	static constexpr int32 NumWindows = 4;
+	static constexpr float WindowSeconds = 0.5f;
+
+	std::atomic<uint64> PendingCycles{ 0 };
+	std::atomic<uint8> QualityLevel{ 0 };
+
+	/** Audio render thread only. */
+	uint32 Histograms[NumWindows][NumBins] = {};
+	int32 CurrentWindow = 0;
+	int32 BuffersInWindow = 0;
+	/** Windows completed since the last reset; the governor waits for a full history after every step. */
+	int32 NumCompletedWindows = 0;
+};
+
+/** Adds the cycles of the audio callback it is scoped to to the current mixer buffer. */
+class FFrequenSeeCallbackScope
+{
+public:
+	FFrequenSeeCallbackScope() : StartCycles(FPlatformTime::Cycles64()) {}
+	~FFrequenSeeCallbackScope() { FFrequenSeeCallbackMonitor::Get().AddCallbackCycles(FPlatformTime::Cycles64() - StartCycles); }
+
+private:
+	uint64 StartCycles;
+};
@@ -0,0 +1,206 @@
+#include "FrequenSeeSourceRegistry.h"
+
+FFrequenSeeSourceRegistry& FFrequenSeeSourceRegistry::Get()
+{
+	static FFrequenSeeSourceRegistry Registry;
+	return Registry;
+}
+
+int32 FFrequenSeeSourceRegistry::FindEntry(uint64 AudioComponentId) const
+{
+	for (int32 Index = 0; Index < MaxEntries; ++Index)
+	{
+		if (Entries[Index].AudioComponentId.load(std::memory_order_acquire) == AudioComponentId)
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FFrequenSeeSourceRegistry::FindOrClaimEntry(uint64 AudioComponentId, const FFrequenSeeSourceParameters* InitialParameters)
+{
+	check(IsInGameThread());
+	if (AudioComponentId == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 FreeEntry = INDEX_NONE;
+	for (int32 Index = 0; Index < MaxEntries; ++Index)
+	{
+		const uint64 Owner = Entries[Index].AudioComponentId.load(std::memory_order_relaxed);
+		if (Owner == AudioComponentId)
+		{
+			if (InitialParameters)
+			{
+				Entries[Index].Parameters.Publish(*InitialParameters);
+			}
+			return Index;
+		}
+		if (Owner == 0 && FreeEntry == INDEX_NONE)
+		{
+			FreeEntry = Index;
+		}
+	}
+
+	if (FreeEntry == INDEX_NONE)
+	{
+		// Every publish of every unregistered source ends up here, so only the first one is reported
+		if (!bReportedFull)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FrequenSee: all %d source registry entries in use, source %llu and later ones are rendered with defaults"),
+			       MaxEntries, AudioComponentId);
+			bReportedFull = true;
+		}
+		return INDEX_NONE;
+	}
+
+	// Publish before the ID becomes visible so a reader that finds the entry always sees a value
+	if (InitialParameters)
+	{
+		Entries[FreeEntry].Parameters.Publish(*InitialParameters);
+	}
+	Entries[FreeEntry].AudioComponentId.store(AudioComponentId, std::memory_order_release);
+	return FreeEntry;
+}
+
+void FFrequenSeeSourceRegistry::PublishParameters(uint64 AudioComponentId, const FFrequenSeeSourceParameters& Parameters)
+{
+	FindOrClaimEntry(AudioComponentId, &Parameters);
+}
+
+void FFrequenSeeSourceRegistry::PublishImpulseResponse(uint64 AudioComponentId, FFrequenSeeImpulseResponsePtr ImpulseResponse)
+{
+	const int32 Index = FindOrClaimEntry(AudioComponentId, nullptr);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries[Index];
+	const uint32 Version = ImpulseResponse.IsValid() ? ImpulseResponse->Version : 0;
+	{
+		FScopeLock Lock(&Entry.ImpulseResponseLock);
+		Swap(Entry.ImpulseResponse, ImpulseResponse);
+	}
+	Entry.ImpulseResponseVersion.store(Version, std::memory_order_release);
+	if (ImpulseResponse.IsValid())
+	{
+		RetiredImpulseResponses.Add(MoveTemp(ImpulseResponse));
+	}
+}
+
+void FFrequenSeeSourceRegistry::Retire(uint64 AudioComponentId)
+{
+	check(IsInGameThread());
+	if (AudioComponentId == 0)
+	{
+		return;
+	}
+
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.AudioComponentId.load(std::memory_order_relaxed) == AudioComponentId)
+		{
+			Entry.AudioComponentId.store(0, std::memory_order_release);
+			Entry.Parameters.Clear();
+			bReportedFull = false;
+			FFrequenSeeImpulseResponsePtr ImpulseResponse;
+			{
+				FScopeLock Lock(&Entry.ImpulseResponseLock);
+				Swap(Entry.ImpulseResponse, ImpulseResponse);
+			}
+			Entry.ImpulseResponseVersion.store(0, std::memory_order_release);
+			if (ImpulseResponse.IsValid())
+			{
+				RetiredImpulseResponses.Add(MoveTemp(ImpulseResponse));
+			}
+			return;
+		}
+	}
+}
+
+void FFrequenSeeSourceRegistry::CollectRetiredImpulseResponses()
+{
+	check(IsInGameThread());
+
+	// A retired response is out of its entry, so once nothing else holds it no render thread can pick it up again;
+	// the same goes for its partitions once it is the only one holding them
+	for (int32 Index = RetiredImpulseResponses.Num() - 1; Index >= 0; --Index)
+	{
+		const FFrequenSeeImpulseResponsePtr& ImpulseResponse = RetiredImpulseResponses[Index];
+		bool bUnused = ImpulseResponse.GetSharedReferenceCount() == 1;
+		for (int32 Channel = 0; bUnused && Channel < ImpulseResponse->Prepared.Num(); ++Channel)
+		{
+			bUnused = ImpulseResponse->Prepared[Channel].GetSharedReferenceCount() <= 1;
+		}
+		if (bUnused)
+		{
+			// Pairs with the release of the render thread's last reference before its memory is reused
+			std::atomic_thread_fence(std::memory_order_acquire);
+			RetiredImpulseResponses.RemoveAtSwap(Index);
+		}
+	}
+}
+
+const FFrequenSeeSourceRegistry::FEntry* FFrequenSeeSourceRegistry::SyncEntry(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const
+{
+	if (State.AudioComponentId != AudioComponentId)
+	{
+		State.Reset();
+		State.AudioComponentId = AudioComponentId;
+	}
+	if (State.Entry == INDEX_NONE)
+	{
+		State.Entry = FindEntry(AudioComponentId);
+		if (State.Entry == INDEX_NONE)
+		{
+			return nullptr;
+		}
+	}
+
+	// IDs are never reused, so re-checking the owner after each read rejects anything written for a later owner
+	const FEntry& Entry = Entries[State.Entry];
+	if (Entry.AudioComponentId.load(std::memory_order_acquire) != AudioComponentId)
+	{
+		State.Entry = INDEX_NONE;
+		return nullptr;
+	}
+
+	FFrequenSeeSourceParameters Parameters;
+	if (Entry.Parameters.Read(Parameters) && Entry.AudioComponentId.load(std::memory_order_acquire) == AudioComponentId)
+	{
+		State.Parameters = Parameters;
+		State.bHasParameters = true;
+	}
+	return &Entry;
+}
+
+void FFrequenSeeSourceRegistry::SyncParameters(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const
+{
+	SyncEntry(State, AudioComponentId);
+}
+
+void FFrequenSeeSourceRegistry::Sync(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const
+{
+	const FEntry* Entry = SyncEntry(State, AudioComponentId);
+	if (!Entry)
+	{
+		return;
+	}
+
+	// The response replaced here was retired on the game thread, which frees it after its last user is gone
+	const uint32 LoadedVersion = State.ImpulseResponse.IsValid() ? State.ImpulseResponse->Version : 0;
+	if (Entry->ImpulseResponseVersion.load(std::memory_order_acquire) != LoadedVersion && Entry->ImpulseResponseLock.TryLock())
+	{
+		FFrequenSeeImpulseResponsePtr ImpulseResponse = Entry->ImpulseResponse;
+		Entry->ImpulseResponseLock.Unlock();
+
+		// A busy lock or a response that is gone just means trying again next callback
+		if (ImpulseResponse.IsValid() && Entry->AudioComponentId.load(std::memory_order_acquire) == AudioComponentId)
+		{
+			State.ImpulseResponse = MoveTemp(ImpulseResponse);
+		}
+	}
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AudioRayTracingSubsystem.h"
+#include "FrequenSeePartitionedConvolver.h"
+#include "FrequenSeeSlabPool.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Single-writer sequence lock around a small trivially copyable value.
+ * Publish() never waits; Read() never waits either and simply fails if it overlapped a Publish(), in which case the
+ * reader keeps the copy it already has and tries again next callback.
+ */
+template <typename T>
+class TFrequenSeeSnapshot
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Snapshots are copied word by word");
+
+public:
+	void Publish(const T& Value)
+	{
+		uint32 Buffer[NumWords] = {};
+		FMemory::Memcpy(Buffer, &Value, sizeof(T));
+
+		const uint32 Sequence = SequenceNumber.load(std::memory_order_relaxed);
+		SequenceNumber.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (int32 Word = 0; Word < NumWords; ++Word)
+		{
+			Words[Word].store(Buffer[Word], std::memory_order_relaxed);
+		}
+		SequenceNumber.store(Sequence + 2, std::memory_order_release);
+	}
+
+	/** False if nothing was published yet or a Publish() was in flight. */
+	bool Read(T& OutValue) const
+	{
+		const uint32 Before = SequenceNumber.load(std::memory_order_acquire);
+		if (Before == 0 || (Before & 1) != 0)
+		{
+			return false;
+		}
+
+		uint32 Buffer[NumWords];
+		for (int32 Word = 0; Word < NumWords; ++Word)
+		{
+			Buffer[Word] = Words[Word].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (SequenceNumber.load(std::memory_order_relaxed) != Before)
+		{
+			return false;
+		}
+
+		FMemory::Memcpy(&OutValue, Buffer, sizeof(T));
+		return true;
+	}
+
+	/** Forgets the value so the next Read() fails until a new Publish(). Writer thread only. */
+	void Clear()
+	{
+		SequenceNumber.store(0, std::memory_order_release);
+	}
+
+private:
+	static constexpr int32 NumWords = (sizeof(T) + sizeof(uint32) - 1) / sizeof(uint32);
+
+	std::atomic<uint32> SequenceNumber{ 0 };
+	std::atomic<uint32> Words[NumWords] = {};
+};
+
+/** Everything the renderers need from a UFrequenSeeAudioComponent except the impulse response. */
+struct FFrequenSeeSourceParameters
+{
+	/** The part of FAudioOcclusionParams the occlusion DSP consumes. */
+	float OcclusionGain = 1.0f;
+	float LowpassCutoff = 20000.0f;
+	float HighpassCutoff = 20.0f;
+
+	/** Relative reflectance per AcousticBandCentersHz band and its version; version 0 means flat. */
+	float MaterialBandResponse[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+	uint32 MaterialResponseVersion = 0;
+
+	/** Early reflections rendered as a sparse FIR ahead of the convolved tail, and their version. */
+	int32 NumReflectionTaps = 0;
+	FAudioOcclusionParams::FEarlyReflectionTap ReflectionTaps[FAudioOcclusionParams::MaxReflectionTaps];
+	uint32 ReflectionTapsVersion = 0;
+
+	/** Per-band reverberation times and IR energy the FDN fallback renders with, and which path to use. */
+	float LateReverbT60[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+	float LateReverbEnergy = 0.0f;
+	bool bUseConvolution = true;
+
+	/** Shared reverb cluster the dry signal is sent to instead of the source's own convolvers, and its send gain. */
+	int32 ReverbCluster = INDEX_NONE;
+	float ReverbClusterGain = 1.0f;
+
+	bool bApplyReverb = true;
+};
+
+/** The audio component whose impulse response each shared reverb cluster is convolved with; 0 for a free slot. */
+struct FFrequenSeeReverbClusters
+{
+	static constexpr int32 MaxClusters = 8;
+
+	uint64 RepresentativeIds[MaxClusters] = {};
+};
+
+/**
+ * Immutable copy of a component's impulse response, shared with the render thread by reference. The channels come
+ * from the slab pool, so the copy published every trace recycles the ones collected on earlier ticks.
+ */
+struct FFrequenSeeImpulseResponse
+{
+	uint32 Version = 0;
+	TArray<FFrequenSeeAlignedFloats> Channels;
+	/**
+	 * Convolver partitions of the response past its first block, which the tap filters render directly. Built on the
+	 * game thread; the channels are copies of one mono trace, so a single entry is shared by every convolver.
+	 */
+	TArray<FFrequenSeePreparedImpulseResponsePtr> Prepared;
+};
+
+using FFrequenSeeImpulseResponsePtr = TSharedPtr<const FFrequenSeeImpulseResponse, ESPMode::ThreadSafe>;
+
+/** Render-side copy of one source's state. Owned by a plugin per SourceId and refreshed with Sync(). */
+struct FFrequenSeeSourceRenderState
+{
+	/** Audio component the cached registry entry was resolved for. */
+	uint64 AudioComponentId = 0;
+	int32 Entry = INDEX_NONE;
+
+	/** False until the first parameters for AudioComponentId arrive; Parameters hold defaults until then. */
+	bool bHasParameters = false;
+	FFrequenSeeSourceParameters Parameters;
+
+	/** Null until the component publishes its first impulse response. */
+	FFrequenSeeImpulseResponsePtr ImpulseResponse;
+
+	void Reset() { *this = FFrequenSeeSourceRenderState(); }
+};
+
+/**
+ * Hands per-source state from the game thread to the audio render thread, so neither plugin touches a UObject while
+ * rendering.
+ *
+ * The game thread publishes by UAudioComponent ID, which is also what the render thread receives in
+ * FAudioPluginSourceInputData::AudioComponentId. Each plugin keeps a FFrequenSeeSourceRenderState per SourceId, resets
+ * it in OnInitSource/OnReleaseSource, and calls Sync() once per callback: that resolves the entry the first time and
+ * afterwards only does a lock-free read of the parameters and, when its version changed, picks up the new impulse
+ * response by reference. Plugins that only need the parameters call SyncParameters() and never hold a response.
+ *
+ * Responses leaving an entry are kept on the game thread until no render-side state or convolver references them,
+ * so the render thread never drops the last reference and never frees into the slab pool.
+ */
+class FFrequenSeeSourceRegistry
+{
+public:
+	static FFrequenSeeSourceRegistry& Get();
+
+	/** Game thread. Claims an entry for AudioComponentId on first use. */
+	void PublishParameters(uint64 AudioComponentId, const FFrequenSeeSourceParameters& Parameters);
+
+	/** Game thread. ImpulseResponse must not be modified afterwards; render threads may hold it for a while. */
+	void PublishImpulseResponse(uint64 AudioComponentId, FFrequenSeeImpulseResponsePtr ImpulseResponse);
+
+	/** Game thread. Frees the entry; render-side states keep their last values until re-initialized. */
+	void Retire(uint64 AudioComponentId);
+
+	/** Render thread. Refreshes State from whatever was published for AudioComponentId. Never blocks. */
+	void Sync(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const;
+
+	/** Render thread. Like Sync(), but leaves State.ImpulseResponse empty. */
+	void SyncParameters(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const;
+
+	/** Game thread, once per tick. Frees the retired impulse responses nothing on the render thread uses any more. */
+	void CollectRetiredImpulseResponses();
+
+	/** Game thread. Replaces the shared reverb cluster table. */
+	void PublishReverbClusters(const FFrequenSeeReverbClusters& Clusters) { ReverbClusters.Publish(Clusters); }
+
+	/** Render thread. False if nothing was published yet or a publish was in flight; keep the previous table then. */
+	bool ReadReverbClusters(FFrequenSeeReverbClusters& OutClusters) const { return ReverbClusters.Read(OutClusters); }
+
+	static constexpr int32 MaxEntries = 256;
+
+private:
+	struct FEntry
+	{
+		std::atomic<uint64> AudioComponentId{ 0 };
+		TFrequenSeeSnapshot<FFrequenSeeSourceParameters> Parameters;
+
+		/** Guards ImpulseResponse; the render thread only ever try-locks it. */
+		mutable FCriticalSection ImpulseResponseLock;
+		FFrequenSeeImpulseResponsePtr ImpulseResponse;
+		std::atomic<uint32> ImpulseResponseVersion{ 0 };
+	};
+
+	int32 FindEntry(uint64 AudioComponentId) const;
+	/** Resolves State's entry and reads its parameters; nullptr if AudioComponentId has no entry. */
+	const FEntry* SyncEntry(FFrequenSeeSourceRenderState& State, uint64 AudioComponentId) const;
+	/** Game thread. InitialParameters, if any, are published before the entry becomes visible to readers. */
+	int32 FindOrClaimEntry(uint64 AudioComponentId, const FFrequenSeeSourceParameters* InitialParameters);
+
+	FEntry Entries[MaxEntries];
+
+	/** Game thread. Set once a full registry was reported, cleared when an entry frees up. */
+	bool bReportedFull = false;
+
+	/** Game thread. Responses that left their entry, each freed once this is its only reference. */
+	TArray<FFrequenSeeImpulseResponsePtr> RetiredImpulseResponses;
+
+	TFrequenSeeSnapshot<FFrequenSeeReverbClusters> ReverbClusters;
+};
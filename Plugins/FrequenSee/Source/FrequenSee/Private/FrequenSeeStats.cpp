@@ -0,0 +1,19 @@
+﻿#include "FrequenSeeStats.h"
+
+DEFINE_STAT(STAT_FrequenSee_UpdateSource);
+DEFINE_STAT(STAT_FrequenSee_TracePaths);
+DEFINE_STAT(STAT_FrequenSee_EvaluatePaths);
+DEFINE_STAT(STAT_FrequenSee_ImageSources);
+DEFINE_STAT(STAT_FrequenSee_ReconstructIR);
+DEFINE_STAT(STAT_FrequenSee_Occlusion);
+DEFINE_STAT(STAT_FrequenSee_RaysTraced);
+DEFINE_STAT(STAT_FrequenSee_ConnectionsAttempted);
+DEFINE_STAT(STAT_FrequenSee_ConnectionsSucceeded);
+
+DEFINE_STAT(STAT_FrequenSee_ReverbCallback);
+DEFINE_STAT(STAT_FrequenSee_ClusterCallback);
+DEFINE_STAT(STAT_FrequenSee_Convolution);
+DEFINE_STAT(STAT_FrequenSee_OcclusionCallback);
+DEFINE_STAT(STAT_FrequenSee_DeadlineMisses);
+DEFINE_STAT(STAT_FrequenSee_CallbackLoadP99);
+DEFINE_STAT(STAT_FrequenSee_QualityLevel);
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/**
+ * "stat FrequenSee" in the console. Cycle counters also show up as CPU events in Unreal Insights; finer steps that are
+ * not worth a stat get TRACE_CPUPROFILER_EVENT_SCOPE instead. The simulation core has no engine dependency, so its
+ * work is measured around the calls into it.
+ */
+DECLARE_STATS_GROUP(TEXT("FrequenSee"), STATGROUP_FrequenSee, STATCAT_Advanced);
+
+// Game thread: the simulation
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Source"), STAT_FrequenSee_UpdateSource, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trace Paths"), STAT_FrequenSee_TracePaths, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate Paths"), STAT_FrequenSee_EvaluatePaths, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Image Sources"), STAT_FrequenSee_ImageSources, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reconstruct IR"), STAT_FrequenSee_ReconstructIR, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Occlusion"), STAT_FrequenSee_Occlusion, STATGROUP_FrequenSee, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rays Traced"), STAT_FrequenSee_RaysTraced, STATGROUP_FrequenSee, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Connections Attempted"), STAT_FrequenSee_ConnectionsAttempted, STATGROUP_FrequenSee, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Connections Succeeded"), STAT_FrequenSee_ConnectionsSucceeded, STATGROUP_FrequenSee, );
+
+// Audio render thread: the plugins' callbacks
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reverb Source Callback"), STAT_FrequenSee_ReverbCallback, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reverb Cluster Callback"), STAT_FrequenSee_ClusterCallback, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Convolution"), STAT_FrequenSee_Convolution, STATGROUP_FrequenSee, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Occlusion Callback"), STAT_FrequenSee_OcclusionCallback, STATGROUP_FrequenSee, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Audio Deadline Misses"), STAT_FrequenSee_DeadlineMisses, STATGROUP_FrequenSee, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Callback Load P99 (% of buffer)"), STAT_FrequenSee_CallbackLoadP99, STATGROUP_FrequenSee, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Governor Quality Level"), STAT_FrequenSee_QualityLevel, STATGROUP_FrequenSee, );
@@ -0,0 +1,154 @@
+#include "FrequenSeeWorldScene.h"
+
+#include "AcousticGeometryComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "FrequenSeeImageSources.h"
+
+static_assert(AcousticBandCount == FrequenSeeCore::BandCount, "Materials and the simulation core must agree on the bands");
+
+namespace
+{
+	/** Ignores Actor and its static mesh. */
+	FCollisionQueryParams MakeIgnoreParams(const AActor* Actor)
+	{
+		FCollisionQueryParams Params(TEXT("AudioRay"), /*bTraceComplex*/ false);
+		if (Actor)
+		{
+			Params.AddIgnoredActor(Actor);
+			if (const UStaticMeshComponent* Mesh = Actor->FindComponentByClass<UStaticMeshComponent>())
+			{
+				Params.AddIgnoredComponent(Mesh);
+			}
+		}
+		return Params;
+	}
+}
+
+void FFrequenSeeAcousticSurface::SetMaterial(const UAcousticMaterial* Material)
+{
+	bHasMaterial = Material != nullptr;
+	ThicknessCm = Material ? Material->ThicknessCm : 0.0f;
+	for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+	{
+		Transmission[Band] = Material ? Material->GetBandTransmission(Band) : 0.0f;
+	}
+}
+
+void FFrequenSeeSurfaceCache::Update(TConstArrayView<TWeakObjectPtr<UAcousticGeometryComponent>> Components)
+{
+	check(IsInGameThread());
+	Surfaces.Reset();
+	for (const TWeakObjectPtr<UAcousticGeometryComponent>& Component : Components)
+	{
+		const UAcousticGeometryComponent* Geometry = Component.Get();
+		const AActor* Owner = Geometry ? Geometry->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			continue;
+		}
+
+		FFrequenSeeAcousticSurface& Surface = Surfaces.FindOrAdd(Owner);
+		Surface.Response = FFrequenSeeWorldScene::GetSurfaceResponse(Geometry);
+		Surface.SetMaterial(Geometry->Material);
+		// The same box GatherReflectors() takes its faces from
+		const UStaticMeshComponent* Mesh = Owner->FindComponentByClass<UStaticMeshComponent>();
+		if (Mesh && Mesh->GetStaticMesh())
+		{
+			Surface.ReflectorBounds = Mesh->GetStaticMesh()->GetBoundingBox();
+			Surface.ReflectorTransform = Mesh->GetComponentTransform();
+		}
+	}
+}
+
+FFrequenSeeWorldScene::FFrequenSeeWorldScene(const UWorld* InWorld, const FFrequenSeeSurfaceCache* InSurfaces, const AActor* SourceActor,
+                                             const AActor* ListenerActor)
+	: World(InWorld)
+	, Surfaces(InSurfaces)
+	, SourceParams(MakeIgnoreParams(SourceActor))
+	, ListenerParams(MakeIgnoreParams(ListenerActor))
+{
+	// Collide with various channels
+	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic); // covers walls/floors
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic); // covers dynamic props
+}
+
+bool FFrequenSeeWorldScene::Trace(const FrequenSeeCore::FVec3& Origin, const FrequenSeeCore::FVec3& Direction, float MaxDistance,
+                                  FrequenSeeCore::EPathOrigin PathOrigin, FrequenSeeCore::FSurfaceHit& OutHit) const
+{
+	const FVector Start = ToVector(Origin);
+	const FCollisionQueryParams& Params = PathOrigin == FrequenSeeCore::EPathOrigin::Source ? SourceParams : ListenerParams;
+	++NumLineTraces;
+
+	FHitResult Hit;
+	if (!World->LineTraceSingleByObjectType(Hit, Start, Start + ToVector(Direction) * MaxDistance, ObjectParams, Params))
+	{
+		return false;
+	}
+
+	OutHit.Position = ToCore(Hit.ImpactPoint);
+	OutHit.Normal = ToCore(Hit.ImpactNormal);
+	const FFrequenSeeAcousticSurface* Surface = Surfaces ? Surfaces->Find(Hit.GetActor()) : nullptr;
+	OutHit.Surface = Surface ? Surface->Response : FrequenSeeCore::FSurfaceResponse();
+	OutHit.bImageSourceReflector = Surface && IsOnReflector(*Surface, Hit.ImpactPoint);
+	return true;
+}
+
+bool FFrequenSeeWorldScene::IsVisible(const FrequenSeeCore::FVec3& From, const FrequenSeeCore::FVec3& To) const
+{
+	++NumLineTraces;
+	FHitResult Hit;
+	return !World->LineTraceSingleByObjectType(Hit, ToVector(From), ToVector(To), ObjectParams);
+}
+
+bool FFrequenSeeWorldScene::IsOnReflector(const FFrequenSeeAcousticSurface& Surface, const FVector& Point)
+{
+	if (!Surface.ReflectorBounds.IsValid)
+	{
+		return false;
+	}
+
+	const FBox& Bounds = Surface.ReflectorBounds;
+	const FTransform& Transform = Surface.ReflectorTransform;
+	const FVector Local = Transform.InverseTransformPosition(Point);
+	const FVector Scale = Transform.GetScale3D().GetAbs();
+	const float Tolerance = FrequenSeeCore::FImageSourceSettings().PlaneTolerance;
+	bool bOnFace = false;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		// Inside the box and on one of its faces, to within the tolerance the image sources validate their paths with
+		const double AxisTolerance = Tolerance / FMath::Max(Scale[Axis], UE_KINDA_SMALL_NUMBER);
+		if (Local[Axis] < Bounds.Min[Axis] - AxisTolerance || Local[Axis] > Bounds.Max[Axis] + AxisTolerance)
+		{
+			return false;
+		}
+		bOnFace |= FMath::Abs(Local[Axis] - Bounds.Min[Axis]) <= AxisTolerance || FMath::Abs(Local[Axis] - Bounds.Max[Axis]) <= AxisTolerance;
+	}
+	return bOnFace;
+}
+
+FrequenSeeCore::FSurfaceResponse FFrequenSeeWorldScene::GetSurfaceResponse(const UAcousticGeometryComponent* Geometry)
+{
+	if (!Geometry || !Geometry->Material)
+	{
+		return FrequenSeeCore::FSurfaceResponse();
+	}
+
+	const TArray<FAcousticBand>& Absorption = Geometry->Material->Absorption;
+	float Values[AcousticBandCount];
+	const int32 NumBands = FMath::Min(Absorption.Num(), AcousticBandCount);
+	for (int32 Band = 0; Band < NumBands; ++Band)
+	{
+		Values[Band] = Absorption[Band].Value;
+	}
+	// The core takes one scattering coefficient for all bands
+	const TArray<FAcousticBand>& ScatteringCurve = Geometry->Material->Scattering;
+	float Scattering = 0.0f;
+	for (const FAcousticBand& Band : ScatteringCurve)
+	{
+		Scattering += Band.Value / ScatteringCurve.Num();
+	}
+	return FrequenSeeCore::MakeSurfaceResponse(Values, NumBands, Scattering);
+}
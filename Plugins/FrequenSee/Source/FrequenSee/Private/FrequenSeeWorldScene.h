@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AcousticMaterial.h"
+#include "CollisionQueryParams.h"
+#include "FrequenSeeAcousticScene.h"
+
+class UAcousticGeometryComponent;
+
+/** What traces need of one actor's UAcousticGeometryComponent, copied out of its UObjects on the game thread. */
+struct FFrequenSeeAcousticSurface
+{
+	FrequenSeeCore::FSurfaceResponse Response;
+	bool bHasMaterial = false;
+	/** Energy share per band through ThicknessCm of the material; nothing gets through without a material. */
+	float Transmission[AcousticBandCount] = {};
+	float ThicknessCm = 0.0f;
+	/** Local bounds and transform of the static mesh box image sources are mirrored in; empty bounds without one. */
+	FBox ReflectorBounds = FBox(ForceInit);
+	FTransform ReflectorTransform;
+
+	/** Fills the material part from Material, which may be null. */
+	void SetMaterial(const UAcousticMaterial* Material);
+};
+
+/**
+ * The acoustic surfaces of every registered UAcousticGeometryComponent by owning actor. Rebuilt on the game thread
+ * before each batch of traces, so traces running on worker threads only read plain data.
+ */
+class FFrequenSeeSurfaceCache
+{
+public:
+	/** Game thread. */
+	void Update(TConstArrayView<TWeakObjectPtr<UAcousticGeometryComponent>> Components);
+
+	/** Any thread, while no Update() runs. Null for actors without acoustic geometry. */
+	const FFrequenSeeAcousticSurface* Find(const AActor* Actor) const { return Actor ? Surfaces.Find(Actor) : nullptr; }
+
+private:
+	TMap<const AActor*, FFrequenSeeAcousticSurface> Surfaces;
+};
+
+/**
+ * The world's collision geometry as the simulation core sees it: line traces against pawns and static and dynamic
+ * world objects, with materials from the surface cache entry of the actor hit. Subpaths starting at the source or
+ * listener skip that actor (and its static mesh) so they do not hit their own body. Construct on the game thread;
+ * copies are cheap to hand to worker threads and touch no UObject while tracing.
+ */
+class FFrequenSeeWorldScene : public FrequenSeeCore::IAcousticScene
+{
+public:
+	/** Without InSurfaces every hit is a surface without material. */
+	FFrequenSeeWorldScene(const UWorld* InWorld, const FFrequenSeeSurfaceCache* InSurfaces, const AActor* SourceActor = nullptr,
+	                      const AActor* ListenerActor = nullptr);
+
+	virtual bool Trace(const FrequenSeeCore::FVec3& Origin, const FrequenSeeCore::FVec3& Direction, float MaxDistance,
+	                   FrequenSeeCore::EPathOrigin PathOrigin, FrequenSeeCore::FSurfaceHit& OutHit) const override;
+	virtual bool IsVisible(const FrequenSeeCore::FVec3& From, const FrequenSeeCore::FVec3& To) const override;
+
+	/** Response of Geometry's material; no material if either is missing. */
+	static FrequenSeeCore::FSurfaceResponse GetSurfaceResponse(const UAcousticGeometryComponent* Geometry);
+
+	/** Whether Point lies on one of the bounding box faces UAudioRayTracingSubsystem mirrors image sources in for Surface. */
+	static bool IsOnReflector(const FFrequenSeeAcousticSurface& Surface, const FVector& Point);
+
+	static FrequenSeeCore::FVec3 ToCore(const FVector& Vector)
+	{
+		return FrequenSeeCore::FVec3(static_cast<float>(Vector.X), static_cast<float>(Vector.Y), static_cast<float>(Vector.Z));
+	}
+	static FVector ToVector(const FrequenSeeCore::FVec3& Vector) { return FVector(Vector.X, Vector.Y, Vector.Z); }
+
+	/** Line traces run through this scene so far, Trace() and IsVisible() alike. */
+	int32 GetNumLineTraces() const { return NumLineTraces; }
+
+private:
+	const UWorld* World;
+	const FFrequenSeeSurfaceCache* Surfaces;
+	FCollisionObjectQueryParams ObjectParams;
+	FCollisionQueryParams SourceParams;
+	FCollisionQueryParams ListenerParams;
+	mutable int32 NumLineTraces = 0;
+};
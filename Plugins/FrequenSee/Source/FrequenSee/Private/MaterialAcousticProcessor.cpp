@@ -2,97 +2,173 @@
 
 #include "MaterialAcousticProcessor.h"
 #include "Engine/Engine.h" // for UE_LOG
-#include "FrequenSeeFFTConvolver/KissFFT/kiss_fft.h"
-#include "FrequenSeeFFTConvolver/KissFFT/kiss_fftr.h"
+
+namespace
+{
+    /// Smallest even power of two >= Length (real FFTs need an even size)
+    int32 GetFFTSizeForBlock(int32 Length)
+    {
+        int32 N = 2;
+        while (N < Length) N <<= 1;
+        return N;
+    }
+
+    /**
+     * Turns α(f), τ(f), σ(f) into specular, diffuse and transmitted gains, four bins per step.
+     * Reflected energy 1-α splits into specular (1-σ) and diffuse (σ); transmission is capped at α so the three
+     * never add up to more than one. Scale is folded into all three. Bins past NumBins are zeroed up to PaddedBins.
+     */
+    void ComputeMaterialGains(const FMaterialAcousticFD& Props, int32 NumBins, int32 PaddedBins, float Scale,
+                              float* RESTRICT Spec, float* RESTRICT Diff, float* RESTRICT Trans)
+    {
+        const float* Absorption   = Props.Absorption.Responses.GetData();
+        const float* Transmission = Props.Transmission.Responses.GetData();
+        const float* Scattering   = Props.Scattering.Responses.GetData();
+
+        const VectorRegister4Float One      = VectorSetFloat1(1.0f);
+        const VectorRegister4Float ScaleVec = VectorSetFloat1(Scale);
+
+        int32 b = 0;
+        for (; b + 4 <= NumBins; b += 4)
+        {
+            const VectorRegister4Float Alpha = VectorLoad(Absorption + b);
+            const VectorRegister4Float Tau   = VectorMin(VectorLoad(Transmission + b), Alpha);
+            const VectorRegister4Float Sigma = VectorLoad(Scattering + b);
+
+            const VectorRegister4Float Refl     = VectorMultiply(VectorSubtract(One, Alpha), ScaleVec);
+            const VectorRegister4Float DiffGain = VectorMultiply(Refl, Sigma);
+            VectorStoreAligned(VectorSubtract(Refl, DiffGain), Spec + b);
+            VectorStoreAligned(DiffGain, Diff + b);
+            VectorStoreAligned(VectorMultiply(Tau, ScaleVec), Trans + b);
+        }
+        for (; b < NumBins; ++b)
+        {
+            const float Refl = (1.0f - Absorption[b]) * Scale;
+            Spec[b]  = Refl * (1.0f - Scattering[b]);
+            Diff[b]  = Refl * Scattering[b];
+            Trans[b] = FMath::Min(Transmission[b], Absorption[b]) * Scale;
+        }
+        for (; b < PaddedBins; ++b)
+        {
+            Spec[b] = Diff[b] = Trans[b] = 0.0f;
+        }
+    }
+}
 
 FAcousticOutputs UMaterialAcousticProcessor::ApplyMaterialFD(
     const TArray<float>& InBuffer,
     const FMaterialAcousticFD& PropsIn
 )
 {
-    const int32 L = InBuffer.Num();
-    // next power of two
-    int32 N = 1;
-    while (N < L) N <<= 1;
-    const int32 NumBins = N/2 + 1;
-
-    // quick error check
-    if (PropsIn.Absorption.Responses.Num()   != NumBins ||
-        PropsIn.Transmission.Responses.Num() != NumBins ||
-        PropsIn.Scattering.Responses.Num()   != NumBins)
+    // single block through the batched path, so the plans are cached here too
+    FAcousticBatchOutputs Batch;
+    const int32 MaterialIndex = 0;
+    if (InBuffer.Num() == 0 ||
+        !ApplyMaterialFDBatch(InBuffer, InBuffer.Num(), MakeArrayView(&PropsIn, 1), MakeArrayView(&MaterialIndex, 1), Batch))
     {
-        UE_LOG(LogTemp, Error, TEXT("All response curves must have length %d"), NumBins);
         return {};
     }
 
-    // --- 1) prepare time-domain buffer (zero-padded) ---
-    TArray<float> TimeIn; TimeIn.AddZeroed(N);
-    FMemory::Memcpy(TimeIn.GetData(), InBuffer.GetData(), sizeof(float)*L);
-
-    // allocate freq-domain arrays
-    TArray<kiss_fft_cpx> FreqIn;   FreqIn.SetNumZeroed(NumBins);
-    TArray<kiss_fft_cpx> FreqSpec; FreqSpec.SetNumZeroed(NumBins);
-    TArray<kiss_fft_cpx> FreqDiff; FreqDiff.SetNumZeroed(NumBins);
-    TArray<kiss_fft_cpx> FreqTrans;FreqTrans.SetNumZeroed(NumBins);
-
-    // allocate time-domain outputs
-    TArray<float> TimeSpec; TimeSpec.AddZeroed(N);
-    TArray<float> TimeDiff; TimeDiff.AddZeroed(N);
-    TArray<float> TimeTrans;TimeTrans.AddZeroed(N);
+    FAcousticOutputs Out;
+    Out.Specular    = MoveTemp(Batch.Specular);
+    Out.Diffuse     = MoveTemp(Batch.Diffuse);
+    Out.Transmitted = MoveTemp(Batch.Transmitted);
+    return Out;
+}
 
-    // --- 2) create KissFFT configs ---
-    kiss_fftr_cfg FFTFwd = kiss_fftr_alloc(N, 0, nullptr, nullptr);
-    kiss_fftr_cfg FFTInv = kiss_fftr_alloc(N, 1, nullptr, nullptr);
+bool UMaterialAcousticProcessor::ApplyMaterialFDBatch(
+    TArrayView<const float> InBlocks,
+    int32 BlockLength,
+    TArrayView<const FMaterialAcousticFD> Materials,
+    TArrayView<const int32> MaterialIndices,
+    FAcousticBatchOutputs& Out
+)
+{
+    const int32 NumBlocks = MaterialIndices.Num();
+    if (BlockLength <= 0 || InBlocks.Num() != NumBlocks * BlockLength)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Expected %d blocks of %d samples, got %d samples"), NumBlocks, BlockLength, InBlocks.Num());
+        return false;
+    }
 
-    // --- 3) forward FFT ---
-    kiss_fftr(FFTFwd, TimeIn.GetData(), FreqIn.GetData());
+    const int32 N = GetFFTSizeForBlock(BlockLength);
+    const int32 NumBins = N/2 + 1;
 
-    // --- 4) per-bin gains ---
-    for (int32 b = 0; b < NumBins; ++b)
+    // quick error check
+    for (const FMaterialAcousticFD& Props : Materials)
     {
-        const float α = PropsIn.Absorption.Responses[b];
-        float       τ = PropsIn.Transmission.Responses[b];
-        const float σ = PropsIn.Scattering.Responses[b];
-
-        // energy conservation
-        const float Refl = 1.0f - α;
-        if (Refl + τ > 1.0f) τ = 1.0f - Refl;
-
-        const float SpecGain = Refl * (1.0f - σ);
-        const float DiffGain = Refl * σ;
-        const float TransGain= τ;
-
-        kiss_fft_cpx InC = FreqIn[b];
-        FreqSpec[b].r = InC.r * SpecGain;
-        FreqSpec[b].i = InC.i * SpecGain;
-        FreqDiff[b].r = InC.r * DiffGain;
-        FreqDiff[b].i = InC.i * DiffGain;
-        FreqTrans[b].r= InC.r * TransGain;
-        FreqTrans[b].i= InC.i * TransGain;
+        if (Props.Absorption.Responses.Num()   != NumBins ||
+            Props.Transmission.Responses.Num() != NumBins ||
+            Props.Scattering.Responses.Num()   != NumBins)
+        {
+            UE_LOG(LogTemp, Error, TEXT("All response curves must have length %d"), NumBins);
+            return false;
+        }
+    }
+    for (int32 Index : MaterialIndices)
+    {
+        if (!Materials.IsValidIndex(Index))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Material index %d out of range (%d materials)"), Index, Materials.Num());
+            return false;
+        }
     }
 
-    // --- 5) inverse FFTs ---
-    kiss_fftri(FFTInv, FreqSpec.GetData(), TimeSpec.GetData());
-    kiss_fftri(FFTInv, FreqDiff.GetData(), TimeDiff.GetData());
-    kiss_fftri(FFTInv, FreqTrans.GetData(),TimeTrans.GetData());
+    // --- 1) (re)build plans and spectra only when the FFT size changes ---
+    if (FFT.GetFFTSize() != N)
+    {
+        FFT.Init(N);
+        BlockSpectrum.Init(NumBins);
+        for (FSplitComplexSpectrum& Spectrum : PathSpectra)
+        {
+            Spectrum.Init(NumBins);
+        }
+        TimeScratch.SetNumZeroed(N);
+    }
+    const int32 PaddedBins = BlockSpectrum.GetPaddedNumBins();
 
-    // --- 6) normalize & copy to outputs ---
-    FAcousticOutputs Out;
-    Out.Specular.SetNum(L);
-    Out.Diffuse.SetNum(L);
-    Out.Transmitted.SetNum(L);
+    // --- 2) one vectorized pass per material for all three gain curves ---
+    const int32 GainStride = NumPathTypes * PaddedBins;
+    if (MaterialGains.Num() < Materials.Num() * GainStride)
+    {
+        MaterialGains.SetNumUninitialized(Materials.Num() * GainStride);
+    }
+    for (int32 m = 0; m < Materials.Num(); ++m)
+    {
+        float* Gains = MaterialGains.GetData() + m * GainStride;
+        ComputeMaterialGains(Materials[m], NumBins, PaddedBins, 1.0f / float(N),
+                             Gains, Gains + PaddedBins, Gains + 2 * PaddedBins);
+    }
 
-    for (int32 i = 0; i < L; ++i)
+    // --- 3) outputs only ever grow ---
+    Out.BlockLength = BlockLength;
+    Out.NumBlocks   = NumBlocks;
+    TArray<float>* PathOutputs[NumPathTypes] = { &Out.Specular, &Out.Diffuse, &Out.Transmitted };
+    for (TArray<float>* Output : PathOutputs)
     {
-        const float Scale = 1.0f / float(N);
-        Out.Specular[i]    = TimeSpec[i]  * Scale;
-        Out.Diffuse[i]     = TimeDiff[i]  * Scale;
-        Out.Transmitted[i] = TimeTrans[i] * Scale;
+        Output->SetNumUninitialized(NumBlocks * BlockLength, EAllowShrinking::No);
     }
 
-    // --- 7) cleanup ---
-    free(FFTFwd);
-    free(FFTInv);
+    // --- 4) forward FFT, fused per-bin gains, inverse FFT per path type ---
+    FSplitComplexSpectrum* SpectrumPtrs[NumPathTypes] = { &PathSpectra[0], &PathSpectra[1], &PathSpectra[2] };
+    float* TimeData = TimeScratch.GetData();
+    for (int32 Block = 0; Block < NumBlocks; ++Block)
+    {
+        const int32 Offset = Block * BlockLength;
+        FMemory::Memcpy(TimeData, InBlocks.GetData() + Offset, sizeof(float) * BlockLength);
+        FMemory::Memzero(TimeData + BlockLength, sizeof(float) * (N - BlockLength));
+        FFT.Forward(TimeData, BlockSpectrum);
+
+        const float* Gains = MaterialGains.GetData() + MaterialIndices[Block] * GainStride;
+        const float* GainPtrs[NumPathTypes] = { Gains, Gains + PaddedBins, Gains + 2 * PaddedBins };
+        FrequenSeeSpectrum::MultiplyByGains(BlockSpectrum, GainPtrs, SpectrumPtrs, NumPathTypes);
+
+        for (int32 Path = 0; Path < NumPathTypes; ++Path)
+        {
+            FFT.Inverse(PathSpectra[Path], TimeData);
+            FMemory::Memcpy(PathOutputs[Path]->GetData() + Offset, TimeData, sizeof(float) * BlockLength);
+        }
+    }
 
-    return Out;
+    return true;
 }
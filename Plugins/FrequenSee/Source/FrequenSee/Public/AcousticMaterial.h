@@ -1,8 +1,15 @@
 ﻿#pragma once
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "FrequenSeeCoreTypes.h"
 #include "AcousticMaterial.generated.h"
 
+/** Number of frequency bands every UAcousticMaterial curve is expected to have. */
+inline constexpr int32 AcousticBandCount = FrequenSeeCore::BandCount;
+
+/** Centre frequency of each band, spread over the 125 Hz - 4 kHz range the curves describe. */
+inline constexpr float AcousticBandCentersHz[AcousticBandCount] = { 125.0f, 707.0f, 4000.0f };
+
 USTRUCT(BlueprintType)
 struct FAcousticBand
 {
@@ -31,4 +38,10 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Acoustics")
 	float ThicknessCm = 2.5f;  // in centimeters
+
+	/** 1 - Absorption in Band; curves shorter than AcousticBandCount repeat their last value. */
+	float GetBandReflectance(int32 Band) const;
+
+	/** Energy share in Band that gets through ThicknessCm of the material; no curve transmits nothing. */
+	float GetBandTransmission(int32 Band) const;
 };
\ No newline at end of file
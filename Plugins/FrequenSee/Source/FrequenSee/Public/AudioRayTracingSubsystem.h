@@ -7,9 +7,13 @@
 #include "Subsystems/WorldSubsystem.h"
 #include "AcousticGeometryComponent.h"
 #include "GameFramework/DefaultPawn.h"
+#include "Misc/MemStack.h"
+#include "FrequenSeeImageSources.h"
+#include "FrequenSeePathTracer.h"
 #include "AudioRayTracingSubsystem.generated.h"
 
 class UFrequenSeeAudioComponent;
+class FFrequenSeeSurfaceCache;
 
 USTRUCT()
 struct FAudioOcclusionParams
@@ -23,13 +27,22 @@ struct FAudioOcclusionParams
 	float LowpassCutoff = 20000.f;
 	float HighpassCutoff = 20.f;
 
-	// (Optional) early-reflection taps
+	// Energy share of the direct sound per AcousticBandCentersHz band that reaches the listener; the gain and lowpass
+	// above are fitted to it
+	float Transmission[AcousticBandCount] = { 1.f, 1.f, 1.f };
+
+	// (Optional) early-reflection taps, rendered as a sparse FIR ahead of the convolved tail
 	struct FEarlyReflectionTap
 	{
-		float DelaySeconds;
-		float Gain;
+		float DelaySeconds = 0.f;
+		float Gain = 0.f;
 	};
 	TArray<FEarlyReflectionTap> ReflectionTaps;
+
+	// Only the strongest arrivals up to this order and delay become taps, the rest stays in the tail
+	static constexpr int32 MaxReflectionTaps = 16;
+	static constexpr int32 MaxReflectionTapOrder = 2;
+	static constexpr float MaxReflectionTapDelaySeconds = 0.08f;
 };
 
 USTRUCT()
@@ -38,6 +51,14 @@ struct FActiveSource
 	GENERATED_BODY()
 
 	TWeakObjectPtr<UFrequenSeeAudioComponent> AudioComp;
+	/** The source's part of its trace seeds, hashed from the component's path name so it is the same every run. */
+	uint32 SeedKey = 0;
+	/** Traces UpdateSource() has done for this source, which picks the next trace's seed. */
+	uint32 NumTraces = 0;
+	/** The source's image-source tree, kept between updates so it is only rebuilt when the source moves. */
+	TSharedPtr<FrequenSeeCore::FImageSourceSolver> ImageSources;
+	/** Seconds until UpdateSources() next updates this source, counting down from its RaycastInterval. */
+	float TimeUntilUpdate = 0.0f;
 
 	bool operator==(const FActiveSource& Other) const
 	{
@@ -51,6 +72,14 @@ struct FPathEnergyResult
 	GENERATED_BODY()
 	float DelaySeconds;
 	float Gain;
+	// Number of surface reflections along the path, 0 for the direct path
+	int32 ReflectionOrder = 0;
+	// Exact specular arrival (image source) rather than a traced sample of the scattered energy
+	bool bDeterministic = false;
+	// Product of the per-band material reflectances along the path (AcousticBandCentersHz)
+	float BandReflectance[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+	// Unit vector from the listener towards the path's last bounce (or the source)
+	FVector3f Direction = FVector3f::ZeroVector;
 };
 
 
@@ -135,7 +164,7 @@ private:
 		//preparation step
 	void allocateSamples();
 		//trace step
-	void Is_GeneratePath(const AActor* ActorToIgnore, FSoundPath& OutPath, int bounces, bool fwd);
+	void Is_GeneratePath(const AActor* ActorToIgnore, FrequenSeeCore::FPathSampler& Sampler, FSoundPath& OutPath, int bounces, bool fwd);
 		//connect step
 	void Is_NaiveConnections();
 	float getExpectedWeight(int fwdNode, int bwdNode);
@@ -145,12 +174,74 @@ private:
 
 
 	
-	void GeneratePath(const AActor* ActorToIgnore, FSoundPath& OutPath) const;
+	/** Whether the ends of a forward and a backward subpath see each other. */
+	bool CanConnect(const FVector& ForwardEnd, const FVector& BackwardEnd) const;
 	bool ConnectSubpaths(FSoundPath& ForwardPath, FSoundPath& BackwardPath, FSoundPath& OutPath);
-	void GenerateFullPaths(const FActiveSource& Src, TArray<FSoundPath>& ForwardPathsOut, TArray<FSoundPath>& BackwardPathsOut, TArray<FSoundPath>& ConnectedPathsOut, int NumRays = USED_RAY_COUNT); 
+	/**
+	 * Traces NumRays subpath pairs between Src and the player through the simulation core into OutPaths. The trace is
+	 * seeded from FrequenSee.Trace.Seed, the source and its trace count, and comes out the same whether or not
+	 * FrequenSee.Trace.Parallel splits it across worker threads.
+	 */
+	void GenerateFullPaths(const FActiveSource& Src, FrequenSeeCore::FPathBatch& OutPaths, int NumRays = USED_RAY_COUNT);
 	FPathEnergyResult EvaluatePath(FSoundPath& Path) const;
+	/**
+	 * Reflectors of the registered geometry for the image sources: the six faces of each component's static mesh
+	 * bounds, one-sided and facing out, which fits the box-shaped walls, floors and blocking volumes levels are built
+	 * from.
+	 */
+	void GatherReflectors(std::vector<FrequenSeeCore::FReflector>& OutReflectors) const;
+	/**
+	 * Brings Src's specular paths up to MaxOrder reflections up to date with the geometry and the source and listener
+	 * positions. Returns false, leaving the paths alone, if there is no listener to trace to.
+	 */
+	bool UpdateImageSources(FActiveSource& Src, int32 MaxOrder);
+	/**
+	 * Picks the strongest low-order early specular arrivals as discrete taps and flags which results they came from.
+	 * Only deterministic results qualify: a traced sample is a noisy estimate that changes every trace, so it stays in
+	 * the histogram.
+	 */
+	static void ExtractReflectionTaps(TArrayView<const FPathEnergyResult> EnergyResults, float NormalizationFactor,
+	                                  TArray<FAudioOcclusionParams::FEarlyReflectionTap, TMemStackAllocator<>>& OutTaps,
+	                                  TBitArray<TMemStackAllocator<>>& OutIsTap);
 	TArray<float> GetEnergyBuffer(FActiveSource& Src) const;
+	/**
+	 * Updates every source whose RaycastInterval is up (all of them with bForceUpdate): traces its reverb unless it or
+	 * FrequenSee.Trace.OcclusionOnly asks for occlusion only, then its occlusion. Every source's parameters are
+	 * published each tick regardless, so reverb LOD changes reach the audio thread without waiting for a trace.
+	 */
 	void UpdateSources(float DeltaTime, bool bForceUpdate = false);
+	/**
+	 * Occlusion of all of Sources in one parallel pass: the direct path to the player plus FrequenSee.Occlusion.JitterRays
+	 * rays from around each source, every one traced both ways with multi-hit traces so each blocker's entry and exit,
+	 * and so the thickness crossed, are known. A blocked ray transmits the product over its blockers of their material's
+	 * Transmission, raised to the thickness crossed over the material's ThicknessCm. Sets each source's share of open
+	 * rays and the mean per-band transmission of its blocked ones.
+	 */
+	void UpdateOcclusion(TArrayView<FActiveSource* const> Sources);
+	/**
+	 * Reverb level of detail: the loudest sources within FrequenSee.Reverb.ConvolutionMaxDistance, up to
+	 * FrequenSee.Reverb.MaxConvolutionSources convolutions, are convolved; every other source renders the FDN
+	 * fallback. With FrequenSee.Reverb.Clustering, sources whose decay profiles lie within
+	 * FrequenSee.Reverb.ClusterThresholdDb of a louder one share its convolution on the reverb submix, so the budget
+	 * counts rooms rather than voices. FrequenSee.Reverb.ListenerBus sends every playing source to one cluster, a
+	 * single listener reverb convolved once on the submix.
+	 */
+	void UpdateReverbLOD();
+
+	/**
+	 * Paths of the trace UpdateSource() is working on. Reset, not freed, between traces, so steady-state tracing
+	 * reuses the storage of the largest trace so far instead of allocating.
+	 */
+	FrequenSeeCore::FPathBatch TraceScratch;
+	/** Per-task paths of a trace split across worker threads, appended to the trace's batch in ray order. */
+	TArray<FrequenSeeCore::FPathBatch> TraceChunkScratch;
+	/** Reflectors GatherReflectors() fills for every update, reused like TraceScratch. */
+	std::vector<FrequenSeeCore::FReflector> ReflectorScratch;
+	/** Materials and reflector boxes of Geometry, refreshed by UpdateSources() before any trace reads them off-thread. */
+	TSharedPtr<FFrequenSeeSurfaceCache> SurfaceCache;
+
+	/** Representative of each shared reverb cluster slot, kept across ticks so cluster IRs only change when needed. */
+	TArray<TWeakObjectPtr<UFrequenSeeAudioComponent>> ReverbClusterRepresentatives;
 
 	/** --- PATH VISUALIZATION METHODS --- */
 
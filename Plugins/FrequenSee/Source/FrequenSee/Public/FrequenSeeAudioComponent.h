@@ -6,6 +6,10 @@
 #include "Components/AudioComponent.h"
 #include "GameFramework/DefaultPawn.h"
 #include "Audio.h"
+#include "AcousticMaterial.h"
+#include "FrequenSeeArrivals.h"
+#include "FrequenSeeSlabPool.h"
+#include "AudioRayTracingSubsystem.h"
 #include "FrequenSeeAudioComponent.generated.h"
 
 class UFrequenSeeAudioReverbSettings;
@@ -35,47 +39,52 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
 	bool bIsRaycasting = false;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	int RaycastsPerTick = 1500;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	int RaycastBounces = 10;
+	/** Seconds between the subsystem's updates of this source: its trace, if any, and its occlusion. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent", meta = (ClampMin = "0.0"))
+	float RaycastInterval = 1.0f;
 
+	/**
+	 * Only update this source's occlusion, never trace its reverb: the cheap mode for sources whose reverb is not worth
+	 * a trace. FrequenSee.Trace.OcclusionOnly does the same for every source.
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	float RaycastDistance = 5000.0f;
+	bool bOcclusionOnly = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	float DampingFactor = 0.7f;
+	bool bGenerateReverb = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	float AbsorbtionFactor = 0.0002f;
+	bool bApplyReverb = true;
 
+	/** Shape the reverb spectrum by the band-wise absorption of the materials the traced paths hit. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	float AbsorbtionFactorAir = 0.0005f;
+	bool bApplyMaterialFiltering = true;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	bool bGenerateReverb = false;
+	/** Gain applied by the occlusion plugin when the direct path is fully blocked. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float OccludedGain = 0.3f;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	bool bApplyReverb = true;
+	/** Lowpass cutoff in Hz applied by the occlusion plugin when the direct path is fully blocked. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent", meta = (ClampMin = "20.0", ClampMax = "20000.0"))
+	float OccludedLowpassCutoff = 1000.0f;
 
 	UPROPERTY(VisibleAnywhere)
 	ADefaultPawn *Player;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FrequenSeeAudioComponent")
-	float RaycastInterval = 1.0f;
-
 	// ENERGY BUFFER
 	UPROPERTY()
 	TArray<float> EnergyBuffer;
 
-	int32 BinSizeMs = 1;
-	// float DurationSeconds = 1.0f;
-	// int32 NumBins = FMath::CeilToInt(SimulatedDuration * 1000.0f / BinSizeMs);
+	// Same histogram per AcousticBandCentersHz band, weighted by the band reflectance of each path
+	TArray<float> BandEnergyBuffers[AcousticBandCount];
+
+	// Arrivals of the current trace; the histograms above are binned from them by BuildEnergyHistograms()
+	FrequenSeeCore::FArrivalList Arrivals;
 
 	void FlushEnergyBuffer()
 	{
-		EnergyBuffer.SetNumZeroed(NumBins); // Zeroed for safety
+		ConfigureImpulseResponse();
+		Arrivals.Reset();
 	}
 
 	void UpdateEnergyBuffer(const TArray<float> &NewEnergyValues)
@@ -84,67 +93,132 @@ public:
 		EnergyBuffer = NewEnergyValues;			 // Flush and overwrite
 	}
 
-	void AddEnergyAtDelay(float DelaySeconds, float EnergyValue)
+	void AddEnergyAtDelay(float DelaySeconds, float EnergyValue, const float* BandReflectance = nullptr,
+	                      const FVector3f& Direction = FVector3f::ZeroVector)
 	{
-		int32 BinIndex = FMath::Clamp(FMath::FloorToInt((DelaySeconds * 1000.f) / BinSizeMs), 0, EnergyBuffer.Num() - 1);
-		EnergyBuffer[BinIndex] += EnergyValue;
+		if (DelaySeconds >= SimulatedDuration)
+		{
+			return; // past the end of the impulse response
+		}
+		FrequenSeeCore::FArrival Arrival;
+		Arrival.DelaySeconds = DelaySeconds;
+		Arrival.Energy = EnergyValue;
+		Arrival.Direction = FrequenSeeCore::FVec3(Direction.X, Direction.Y, Direction.Z);
+		for (int32 Band = 0; Band < AcousticBandCount; ++Band)
+		{
+			Arrival.BandEnergy[Band] = BandReflectance ? EnergyValue * BandReflectance[Band] : EnergyValue;
+		}
+		Arrivals.Add(Arrival);
 	}
 
+	/** Orders the arrivals added since FlushEnergyBuffer() and bins them into EnergyBuffer and BandEnergyBuffers. */
+	void BuildEnergyHistograms();
+
 	virtual void OnRegister() override; // auto‑hook into subsystem
 	virtual void OnUnregister() override;
-	//
-	/*
-	 * Returns the energy of an audio ray from this source from the player's perspective.
+	/**
+	 * Publishes the occlusion parameters for the last occlusion update along with the reverb state of the last trace.
+	 * Open rays pass everything; blocked ones pass OcclusionTransmission, but no less than OccludedGain lowpassed at
+	 * OccludedLowpassCutoff, which stands in for the sound bending around the blockers. The subsystem calls it every
+	 * tick. Game thread only.
 	 */
-	float CastAudioRay(FVector Dir, FVector StartPos, float MaxDistance, int Bounces, float Energy = 1.0f);
+	void PublishOcclusion();
 
-	/*
-	 * Calculates the attenuation factor based on direct rays and transmittance.
+	float GetOcclusionAttenuation() const { return OcclusionAttenuation; }
+	/**
+	 * Hands the occlusion parameters, material band response and render flags to the plugins on the audio render
+	 * thread. Game thread only.
+	 */
+	void PublishSourceParameters(const FAudioOcclusionParams& Params) const;
+	/**
+	 * Hands a copy of ImpulseBuffer to the reverb plugin, resampled to the audio device's rate if the IR was built at
+	 * another one. Game thread only.
 	 */
-	float CastDirectAudioRay(FVector Dir, FVector StartPos, float MaxDistance, int Bounces = 1, float Energy = 1.0f, AActor *DirectHitActor = nullptr);
+	void PublishImpulseResponse() const;
+	TArray<FFrequenSeeAlignedFloats> &GetImpulseResponse() { return ImpulseBuffer; }
+	/** Incremented every time ImpulseBuffer is rebuilt, so renderers only re-partition changed IRs. */
+	uint32 GetImpulseResponseVersion() const { return ImpulseResponseVersion; }
+	TArray<float> &GetAudioBuffer() { return AudioBuffer; }
+
+	/** Stores a new relative reflectance per AcousticBandCentersHz band, bumping the version if it changed. */
+	void SetMaterialBandResponse(const float* BandResponse);
+	const float* GetMaterialBandResponse() const { return MaterialBandResponse; }
+	/** Incremented every time MaterialBandResponse changes, so renderers only reshape the IR spectrum when needed. */
+	uint32 GetMaterialResponseVersion() const { return MaterialResponseVersion; }
 
-	void DebuggingDrawRay(FVector Start, FVector End, const UWorld *World, FHitResult Hit, bool bHit, int BouncesLeft, float Energy, bool HitPlayer = false);
-	/*
-	 * Casts audio rays, adjusting the current output volume based on the average sound energy received by the listener.
+	/**
+	 * Fits per-band reverberation times to BandEnergyBuffers (Schroeder integration) and measures the energy of the
+	 * impulse response, the parameters the FDN fallback needs to stand in for the convolution. Also refreshes the
+	 * decay profile the subsystem clusters similar impulse responses by.
 	 */
-	void UpdateSound();
+	void FitLateReverb();
+	const float* GetLateReverbT60() const { return LateReverbT60; }
+	float GetLateReverbEnergy() const { return LateReverbEnergy; }
+	const float* GetReverbProfile() const { return ReverbProfile; }
 
-	float GetOcclusionAttenuation() const { return OcclusionAttenuation; }
-	TArray<TArray<float>> &GetImpulseResponse() { return ImpulseBuffer; }
-	TArray<float> &GetAudioBuffer() { return AudioBuffer; }
+	static constexpr int32 ReverbProfilePoints = 16;
+
+	/** Whether the reverb plugin convolves this source or renders the cheaper FDN; set by the subsystem's LOD policy. */
+	bool bUseConvolutionReverb = true;
+
+	/**
+	 * Shared reverb cluster this source sends its dry signal to instead of being convolved on its own, and the send
+	 * gain that scales the cluster's impulse response to this source's level. INDEX_NONE convolves per source.
+	 */
+	int32 ReverbCluster = INDEX_NONE;
+	float ReverbClusterGain = 1.0f;
+
+	/** Stores the discrete early reflections of the last trace, bumping the version if they changed. */
+	void SetReflectionTaps(TArrayView<const FAudioOcclusionParams::FEarlyReflectionTap> Taps);
+	const TArray<FAudioOcclusionParams::FEarlyReflectionTap>& GetReflectionTaps() const { return ReflectionTaps; }
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
-	
-	int FrameCount = 0;
 	int AudioBufferNum = 0;
 
 	UFUNCTION(BlueprintCallable)
 	void RunScript(const FString &FilePath);
 
 public:
-	float Timer = 0.0f;
+	// share of the occlusion rays that reached the listener at the last occlusion update, set by the subsystem
 	float OcclusionAttenuation = 1.f;
+	// mean energy transmission per AcousticBandCentersHz band of the blocked ones
+	float OcclusionTransmission[AcousticBandCount] = { 0.0f, 0.0f, 0.0f };
 
-	// audio ray tracing sampling bins of float energy values
-	// dummy values assuming 44.1kHz sampling rate and 2 seconds of audio
-	int SampleRate = 48000;
-	// int SampleRate = 44100;
+	// impulse response layout, taken from ReverbSettings and the audio device by ConfigureImpulseResponse(); the
+	// buffers themselves are only allocated once a trace fills them
+	int SampleRate = 0;
+	int DeviceSampleRate = 0;
 	int NumChannels = 2;
 	float SimulatedDuration = 1.0f;
-	float BinDuration = 0.001f;									 // 1ms
-	int NumBins = FMath::CeilToInt(SimulatedDuration / BinDuration); // = 1,000
-	int NumSamples = FMath::CeilToInt(SimulatedDuration * SampleRate);
+	float BinDuration = 0.001f;
+	int NumBins = 0;
+	int NumSamples = 0;
 	// for energy responses per channel
 	// TArray<TArray<float>> EnergyBuffer;
-	// for impulse responses per channel
-	TArray<TArray<float>> ImpulseBuffer;
+	// for impulse responses per channel, taken from the slab pool on the first trace and handed back on unregister
+	TArray<FFrequenSeeAlignedFloats> ImpulseBuffer;
+	uint32 ImpulseResponseVersion = 0;
+	// relative band reflectance of the traced paths, 1 = flat
+	float MaterialBandResponse[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+	uint32 MaterialResponseVersion = 0;
+	// strongest low-order early arrivals, rendered as taps instead of through the impulse response
+	TArray<FAudioOcclusionParams::FEarlyReflectionTap> ReflectionTaps;
+	uint32 ReflectionTapsVersion = 0;
+	// fitted late reverb per band, for the FDN fallback
+	float LateReverbT60[AcousticBandCount] = { 1.0f, 1.0f, 1.0f };
+	float LateReverbEnergy = 0.0f;
+	float ReverbProfile[ReverbProfilePoints] = {};
 	TArray<float> AudioBuffer;
 
-	void ClearEnergyBuffer();
-	void Accumulate(float TimeSeconds, float Value, int32 Channel);
+	/** Reads IR length, sample rate and bin width from ReverbSettings, falling back to the audio device's rate. */
+	void ConfigureImpulseResponse();
+	/** Frees the impulse response, histograms and arrivals; the next trace allocates them again. */
+	void ReleaseImpulseResponse();
+	/** Bytes held by the impulse response, histograms and arrivals of this source. */
+	SIZE_T GetImpulseResponseMemory() const;
+
 	void ReconstructImpulseResponse();
 	void NormalizeImpulseResponse(TArray<float> &IR);
 	void GenerateDummyImpulseResponse(TArray<float> &IR);
@@ -9,6 +9,21 @@ class FREQUENSEE_API UFrequenSeeAudioReverbSettings : public UReverbPluginSource
 
 	UFrequenSeeAudioReverbSettings();
 public:
-	
-	
+	/**
+	 * Length of the traced impulse response in seconds. Sizes the component's buffers on the next trace and the
+	 * source's convolvers when its sound starts.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reverb", meta = (ClampMin = "0.1", ClampMax = "4.0", UIMin = "0.1", UIMax = "4.0"))
+	float ImpulseResponseDuration = 1.0f;
+
+	/**
+	 * Sample rate the impulse response is built at, 0 for the audio device's rate. A lower rate saves memory on the
+	 * component; the published copy is resampled to the device rate for the convolution.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reverb", meta = (ClampMin = "0", ClampMax = "96000"))
+	int32 ImpulseResponseSampleRate = 0;
+
+	/** Width of the energy histogram bins the traced arrivals are gathered into, in milliseconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reverb", meta = (ClampMin = "0.25", ClampMax = "10.0"))
+	float EnergyBinMs = 1.0f;
 };
@@ -4,7 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
-// #include "kiss_fftr.h" // the kiss FFT header (UE4 path)
+#include "FrequenSeeRealFFT.h"
 #include "MaterialAcousticProcessor.generated.h"
 
 /// Frequency response curve over N/2+1 bins
@@ -50,6 +50,18 @@ struct FAcousticOutputs
     TArray<float> Transmitted;
 };
 
+/// Outputs of ApplyMaterialFDBatch, one contiguous buffer per path type.
+/// Block i occupies [i * BlockLength, (i + 1) * BlockLength). Keep one around and pass it again: it only grows.
+struct FAcousticBatchOutputs
+{
+    int32 BlockLength = 0;
+    int32 NumBlocks = 0;
+
+    TArray<float> Specular;
+    TArray<float> Diffuse;
+    TArray<float> Transmitted;
+};
+
 /**
  *  Applies one FFT-block of frequency-dependent absorption/transmission/scattering.
  */
@@ -67,4 +79,31 @@ public:
      */
     UFUNCTION(BlueprintCallable, Category="Acoustics")
     FAcousticOutputs ApplyMaterialFD(const TArray<float>& InBuffer, const FMaterialAcousticFD& Props);
+
+    /**
+     * Filters many blocks against many materials in one call, e.g. one block per path cluster.
+     * FFT plans, gain curves and spectra are cached on the component and reused while the block length stays the
+     * same, so after the first call nothing is allocated. Not thread-safe: one batch at a time per component.
+     * @param InBlocks        NumBlocks * BlockLength mono samples, block after block
+     * @param BlockLength     Samples per block; curves must have NextPow2(BlockLength)/2+1 bins
+     * @param Materials       Material curves referenced by MaterialIndices
+     * @param MaterialIndices One entry per block, indexing Materials
+     * @param Out             Receives NumBlocks blocks of specular, diffuse and transmitted output
+     * @return                False (and logs) if the sizes do not line up
+     */
+    bool ApplyMaterialFDBatch(TArrayView<const float> InBlocks, int32 BlockLength,
+                              TArrayView<const FMaterialAcousticFD> Materials,
+                              TArrayView<const int32> MaterialIndices, FAcousticBatchOutputs& Out);
+
+private:
+    /// Specular, diffuse, transmitted
+    static constexpr int32 NumPathTypes = 3;
+
+    FFrequenSeeRealFFT FFT;
+    FSplitComplexSpectrum BlockSpectrum;
+    FSplitComplexSpectrum PathSpectra[NumPathTypes];
+    FFrequenSeeAlignedFloats TimeScratch;
+
+    /// NumPathTypes padded gain curves per material, with the 1/N inverse FFT scale folded in
+    FFrequenSeeAlignedFloats MaterialGains;
 };
@@ -0,0 +1,14 @@
+using System.IO;
+using UnrealBuildTool;
+
+public class FrequenSeeCore : ModuleRules
+{
+	public FrequenSeeCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		// Plain C++ with no engine types, so the same sources also build headless (Tools/FrequenSeeCLI)
+		PCHUsage = PCHUsageMode.NoPCHs;
+
+		// Only for IMPLEMENT_MODULE
+		PrivateDependencyModuleNames.Add("Core");
+	}
+}
@@ -0,0 +1,74 @@
+#include "FrequenSeeArrivals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace FrequenSeeCore
+{
+	void FArrivalList::Reset()
+	{
+		Arrivals.clear();
+		bSorted = true;
+	}
+
+	void FArrivalList::Empty()
+	{
+		std::vector<FArrival>().swap(Arrivals);
+		bSorted = true;
+	}
+
+	void FArrivalList::Add(const FArrival& Arrival)
+	{
+		bSorted = bSorted && (Arrivals.empty() || Arrivals.back().DelaySeconds <= Arrival.DelaySeconds);
+		Arrivals.push_back(Arrival);
+	}
+
+	void FArrivalList::Finalize()
+	{
+		if (!bSorted)
+		{
+			std::stable_sort(Arrivals.begin(), Arrivals.end(),
+			                 [](const FArrival& A, const FArrival& B) { return A.DelaySeconds < B.DelaySeconds; });
+			bSorted = true;
+		}
+	}
+
+	int32_t FArrivalList::LowerBound(float DelaySeconds) const
+	{
+		const auto It = std::lower_bound(Arrivals.begin(), Arrivals.end(), DelaySeconds,
+		                                 [](const FArrival& Arrival, float Delay) { return Arrival.DelaySeconds < Delay; });
+		return static_cast<int32_t>(It - Arrivals.begin());
+	}
+
+	void FArrivalList::ToHistograms(float BinSeconds, int32_t NumBins, float* OutEnergy, float* const* OutBandEnergy) const
+	{
+		if (NumBins <= 0)
+		{
+			return;
+		}
+
+		std::memset(OutEnergy, 0, sizeof(float) * NumBins);
+		if (OutBandEnergy)
+		{
+			for (int32_t Band = 0; Band < BandCount; ++Band)
+			{
+				std::memset(OutBandEnergy[Band], 0, sizeof(float) * NumBins);
+			}
+		}
+
+		const float BinsPerSecond = 1.0f / BinSeconds;
+		for (const FArrival& Arrival : Arrivals)
+		{
+			const int32_t Bin = std::min(std::max(static_cast<int32_t>(std::floor(Arrival.DelaySeconds * BinsPerSecond)), 0), NumBins - 1);
+			OutEnergy[Bin] += Arrival.Energy;
+			if (OutBandEnergy)
+			{
+				for (int32_t Band = 0; Band < BandCount; ++Band)
+				{
+					OutBandEnergy[Band][Bin] += Arrival.BandEnergy[Band];
+				}
+			}
+		}
+	}
+}
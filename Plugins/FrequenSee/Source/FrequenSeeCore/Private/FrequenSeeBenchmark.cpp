@@ -0,0 +1,492 @@
+#include "FrequenSeeBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "FrequenSeeImpulseSynthesis.h"
+
+namespace FrequenSeeCore
+{
+	namespace
+	{
+		using FClock = std::chrono::steady_clock;
+
+		double SecondsSince(FClock::time_point Start)
+		{
+			return std::max(std::chrono::duration<double>(FClock::now() - Start).count(), 1e-9);
+		}
+
+		double Median(std::vector<double> Values)
+		{
+			if (Values.empty())
+			{
+				return 0.0;
+			}
+			std::sort(Values.begin(), Values.end());
+			const size_t Middle = Values.size() / 2;
+			return Values.size() % 2 ? Values[Middle] : 0.5 * (Values[Middle - 1] + Values[Middle]);
+		}
+
+		/** Divisions x Divisions cells of two triangles each, spanning Corner + EdgeU + EdgeV. */
+		void AddQuadGrid(FTriangleMeshScene& Scene, const FVec3& Corner, const FVec3& EdgeU, const FVec3& EdgeV,
+		                 int32_t Divisions, int32_t Material)
+		{
+			const float Step = 1.0f / static_cast<float>(Divisions);
+			for (int32_t U = 0; U < Divisions; ++U)
+			{
+				for (int32_t V = 0; V < Divisions; ++V)
+				{
+					const FVec3 P00 = Corner + EdgeU * (U * Step) + EdgeV * (V * Step);
+					const FVec3 P10 = P00 + EdgeU * Step;
+					const FVec3 P01 = P00 + EdgeV * Step;
+					const FVec3 P11 = P10 + EdgeV * Step;
+					Scene.AddTriangle(P00, P10, P11, Material);
+					Scene.AddTriangle(P00, P11, P01, Material);
+				}
+			}
+		}
+
+		void AddBox(FTriangleMeshScene& Scene, const FVec3& Min, const FVec3& Max, int32_t Material, int32_t Divisions = 1)
+		{
+			const FVec3 Size = Max - Min;
+			const FVec3 X(Size.X, 0.0f, 0.0f);
+			const FVec3 Y(0.0f, Size.Y, 0.0f);
+			const FVec3 Z(0.0f, 0.0f, Size.Z);
+			AddQuadGrid(Scene, Min, X, Y, Divisions, Material);
+			AddQuadGrid(Scene, Min + Z, X, Y, Divisions, Material);
+			AddQuadGrid(Scene, Min, X, Z, Divisions, Material);
+			AddQuadGrid(Scene, Min + Y, X, Z, Divisions, Material);
+			AddQuadGrid(Scene, Min, Y, Z, Divisions, Material);
+			AddQuadGrid(Scene, Min + X, Y, Z, Divisions, Material);
+		}
+
+		int32_t AddMaterial(FTriangleMeshScene& Scene, float Low, float Mid, float High)
+		{
+			const float Absorption[BandCount] = { Low, Mid, High };
+			return Scene.AddMaterial(MakeSurfaceResponse(Absorption, BandCount));
+		}
+
+		const char* GetEstimatorName(EPathEstimator Estimator)
+		{
+			return Estimator == EPathEstimator::DiffuseRain ? "rain" : "bdpt";
+		}
+
+		/** Mean and sample standard deviation. */
+		void MeanAndStdDev(const std::vector<double>& Values, double& OutMean, double& OutStdDev)
+		{
+			OutMean = 0.0;
+			for (const double Value : Values)
+			{
+				OutMean += Value;
+			}
+			OutMean /= static_cast<double>(std::max<size_t>(Values.size(), 1));
+			double Variance = 0.0;
+			for (const double Value : Values)
+			{
+				Variance += (Value - OutMean) * (Value - OutMean);
+			}
+			OutStdDev = Values.size() > 1 ? std::sqrt(Variance / static_cast<double>(Values.size() - 1)) : 0.0;
+		}
+	}
+
+	const char* GetCannedSceneName(ECannedScene Scene)
+	{
+		switch (Scene)
+		{
+		case ECannedScene::Shoebox:
+			return "shoebox";
+		case ECannedScene::Corridor:
+			return "corridor";
+		case ECannedScene::Cluttered:
+			return "cluttered";
+		}
+		return "unknown";
+	}
+
+	void BuildCannedScene(ECannedScene Scene, FTriangleMeshScene& OutScene, FVec3& OutSource, FVec3& OutListener)
+	{
+		switch (Scene)
+		{
+		case ECannedScene::Shoebox:
+		{
+			AddBox(OutScene, FVec3(0.0f, 0.0f, 0.0f), FVec3(1000.0f, 800.0f, 300.0f), AddMaterial(OutScene, 0.1f, 0.15f, 0.2f));
+			OutSource = FVec3(200.0f, 200.0f, 150.0f);
+			OutListener = FVec3(700.0f, 550.0f, 160.0f);
+			break;
+		}
+		case ECannedScene::Corridor:
+		{
+			AddBox(OutScene, FVec3(0.0f, 0.0f, 0.0f), FVec3(4000.0f, 300.0f, 300.0f), AddMaterial(OutScene, 0.05f, 0.1f, 0.15f));
+			// Pillars alternate sides, so source and listener only see each other's subpaths through the gaps
+			const int32_t PillarMaterial = AddMaterial(OutScene, 0.02f, 0.03f, 0.05f);
+			for (int32_t Pillar = 1; Pillar < 8; ++Pillar)
+			{
+				const float X = 500.0f * Pillar;
+				const float MinY = Pillar % 2 ? 0.0f : 180.0f;
+				AddBox(OutScene, FVec3(X - 25.0f, MinY, 0.0f), FVec3(X + 25.0f, MinY + 120.0f, 300.0f), PillarMaterial);
+			}
+			OutSource = FVec3(100.0f, 150.0f, 150.0f);
+			OutListener = FVec3(3900.0f, 150.0f, 150.0f);
+			break;
+		}
+		case ECannedScene::Cluttered:
+		{
+			AddBox(OutScene, FVec3(0.0f, 0.0f, 0.0f), FVec3(2000.0f, 1500.0f, 500.0f), AddMaterial(OutScene, 0.2f, 0.3f, 0.4f), 32);
+			// Crates stay below the source and listener, which are placed above them
+			const int32_t CrateMaterial = AddMaterial(OutScene, 0.1f, 0.1f, 0.1f);
+			FRandom Random(7);
+			for (int32_t Crate = 0; Crate < 40; ++Crate)
+			{
+				const FVec3 Size(50.0f + 100.0f * Random.NextFloat(), 50.0f + 100.0f * Random.NextFloat(), 50.0f + 100.0f * Random.NextFloat());
+				const FVec3 Min(100.0f + 1700.0f * Random.NextFloat(), 100.0f + 1200.0f * Random.NextFloat(), 0.0f);
+				AddBox(OutScene, Min, Min + Size, CrateMaterial);
+			}
+			OutSource = FVec3(300.0f, 300.0f, 170.0f);
+			OutListener = FVec3(1700.0f, 1200.0f, 170.0f);
+			break;
+		}
+		}
+		OutScene.Build();
+	}
+
+	void RunTracerBenchmark(ECannedScene Scene, const FTracerBenchmarkSettings& Settings, std::vector<FBenchmarkMetric>& OutMetrics)
+	{
+		// Every subpath is tried against this many backward subpaths, for more connections per trace than one
+		constexpr int32_t ConnectionsPerSubpath = 4;
+
+		FTriangleMeshScene MeshScene;
+		FVec3 Source;
+		FVec3 Listener;
+		BuildCannedScene(Scene, MeshScene, Source, Listener);
+
+		FTracerSettings Tracer;
+		Tracer.NumRays = std::max(Settings.NumRays, 1);
+		Tracer.SamplePattern = Settings.SamplePattern;
+
+		FImpulseResponseLayout Layout;
+		Layout.SampleRate = Settings.SampleRate;
+		Layout.BinSeconds = Settings.BinSeconds;
+		Layout.NumBins = static_cast<int32_t>(std::ceil(Settings.DurationSeconds / Settings.BinSeconds));
+		Layout.NumSamples = static_cast<int32_t>(std::ceil(Settings.DurationSeconds * Settings.SampleRate));
+		Layout.EarlySeconds = 0.08f;
+		std::vector<float> Energy(Layout.NumBins);
+		std::vector<float> ImpulseResponse(Layout.NumSamples);
+
+		FPathBatch Batch;
+		std::vector<FPathEnergy> Results;
+		FArrivalList Arrivals;
+		std::vector<double> TraceMs, RaysPerSecond, SubpathsPerSecond, ConnectionsPerSecond, SuccessRatio, EvaluatedPerSecond, SynthesisMs;
+		for (int32_t Repetition = 0; Repetition < std::max(Settings.Repetitions, 1); ++Repetition)
+		{
+			const uint64_t Seed = Settings.Seed + static_cast<uint64_t>(Repetition);
+			// Capacity survives Reset(), so only the first repetition pays for growing the batch
+			Batch.Reset();
+
+			// Subpaths alone, the scene queries GeneratePath made in the plugin
+			FClock::time_point Start = FClock::now();
+			for (int32_t Ray = 0; Ray < Tracer.NumRays; ++Ray)
+			{
+				FPathRange Forward;
+				Forward.FirstVertex = static_cast<int32_t>(Batch.Vertices.size());
+				FPathSampler ForwardSampler(Tracer.SamplePattern, Seed, static_cast<uint32_t>(Ray), 0);
+				Forward.bEscaped = !GenerateSubpath(MeshScene, Tracer, Source, EPathOrigin::Source, ForwardSampler, Batch.Vertices);
+				Forward.NumVertices = static_cast<int32_t>(Batch.Vertices.size()) - Forward.FirstVertex;
+				Batch.ForwardPaths.push_back(Forward);
+
+				FPathRange Backward;
+				Backward.FirstVertex = static_cast<int32_t>(Batch.Vertices.size());
+				FPathSampler BackwardSampler(Tracer.SamplePattern, Seed, static_cast<uint32_t>(Ray), 1);
+				Backward.bEscaped = !GenerateSubpath(MeshScene, Tracer, Listener, EPathOrigin::Listener, BackwardSampler, Batch.Vertices);
+				Backward.NumVertices = static_cast<int32_t>(Batch.Vertices.size()) - Backward.FirstVertex;
+				Batch.BackwardPaths.push_back(Backward);
+			}
+			double Seconds = SecondsSince(Start);
+			// Every vertex after a subpath's first took one scene query to reach
+			const double NumSubpaths = 2.0 * Tracer.NumRays;
+			const double NumRays = static_cast<double>(Batch.Vertices.size()) - NumSubpaths;
+			TraceMs.push_back(Seconds * 1000.0);
+			RaysPerSecond.push_back(NumRays / Seconds);
+			SubpathsPerSecond.push_back(NumSubpaths / Seconds);
+
+			Start = FClock::now();
+			int32_t NumConnected = 0;
+			for (int32_t Offset = 0; Offset < ConnectionsPerSubpath; ++Offset)
+			{
+				for (int32_t Ray = 0; Ray < Tracer.NumRays; ++Ray)
+				{
+					NumConnected += ConnectSubpaths(MeshScene, Tracer, Batch, Ray, (Ray + Offset) % Tracer.NumRays) ? 1 : 0;
+				}
+			}
+			Seconds = SecondsSince(Start);
+			const double NumAttempts = static_cast<double>(ConnectionsPerSubpath) * Tracer.NumRays;
+			ConnectionsPerSecond.push_back(NumAttempts / Seconds);
+			SuccessRatio.push_back(NumConnected / NumAttempts);
+
+			Results.clear();
+			Results.reserve(Batch.ConnectedPaths.size());
+			Start = FClock::now();
+			for (const FPathRange& Path : Batch.ConnectedPaths)
+			{
+				Results.push_back(EvaluatePath(Tracer, Batch.GetVertices(Path), Path.NumVertices, Path.NumForwardVertices));
+			}
+			Seconds = SecondsSince(Start);
+			EvaluatedPerSecond.push_back(static_cast<double>(std::max<size_t>(Results.size(), 1)) / Seconds);
+
+			// Binning and synthesis, what BuildEnergyHistograms and ReconstructImpulseResponse cost per update
+			const float NormalizationFactor = 1.0f / static_cast<float>(NumAttempts);
+			Arrivals.Reset();
+			for (const FPathEnergy& Result : Results)
+			{
+				if (Result.DelaySeconds < Settings.DurationSeconds)
+				{
+					FArrival Arrival;
+					Arrival.DelaySeconds = Result.DelaySeconds;
+					Arrival.Energy = Result.Gain * NormalizationFactor;
+					Arrivals.Add(Arrival);
+				}
+			}
+			Start = FClock::now();
+			Arrivals.Finalize();
+			Arrivals.ToHistograms(Layout.BinSeconds, Layout.NumBins, Energy.data());
+			SynthesizeImpulseResponse(Arrivals, Energy.data(), Layout, ImpulseResponse.data());
+			SynthesisMs.push_back(SecondsSince(Start) * 1000.0);
+		}
+
+		const std::string Prefix = std::string("tracer.") + GetCannedSceneName(Scene) + ".";
+
+		// Whole traces per estimator: what each costs, and how much its estimate of the total energy varies for it
+		for (const EPathEstimator Estimator : { EPathEstimator::Bidirectional, EPathEstimator::DiffuseRain })
+		{
+			FTracerSettings EstimatorTracer = Tracer;
+			EstimatorTracer.Estimator = Estimator;
+			std::vector<double> EstimatorMs, TotalEnergies;
+			for (int32_t Repetition = 0; Repetition < std::max(Settings.Repetitions, 2); ++Repetition)
+			{
+				Batch.Reset();
+				const FClock::time_point Start = FClock::now();
+				TracePaths(MeshScene, EstimatorTracer, Source, Listener, Settings.Seed + static_cast<uint64_t>(Repetition), Batch);
+				EstimatorMs.push_back(SecondsSince(Start) * 1000.0);
+				double Total = 0.0;
+				for (const FPathRange& Path : Batch.ConnectedPaths)
+				{
+					Total += EvaluatePath(EstimatorTracer, Batch.GetVertices(Path), Path.NumVertices, Path.NumForwardVertices).Gain;
+				}
+				TotalEnergies.push_back(Total / EstimatorTracer.NumRays);
+			}
+			double Mean, StdDev;
+			MeanAndStdDev(TotalEnergies, Mean, StdDev);
+			const std::string EstimatorPrefix = Prefix + GetEstimatorName(Estimator) + ".";
+			OutMetrics.push_back({ EstimatorPrefix + "trace_ms", Median(EstimatorMs), "ms" });
+			OutMetrics.push_back({ EstimatorPrefix + "energy", Mean, "ratio" });
+			OutMetrics.push_back({ EstimatorPrefix + "energy_rel_stddev", Mean > 0.0 ? StdDev / Mean : 0.0, "ratio" });
+		}
+
+		OutMetrics.push_back({ Prefix + "triangles", static_cast<double>(MeshScene.NumTriangles()), "count" });
+		OutMetrics.push_back({ Prefix + "trace_ms", Median(TraceMs), "ms" });
+		OutMetrics.push_back({ Prefix + "rays_per_second", Median(RaysPerSecond), "1/s" });
+		OutMetrics.push_back({ Prefix + "subpaths_per_second", Median(SubpathsPerSecond), "1/s" });
+		OutMetrics.push_back({ Prefix + "connections_per_second", Median(ConnectionsPerSecond), "1/s" });
+		OutMetrics.push_back({ Prefix + "connection_success_ratio", Median(SuccessRatio), "ratio" });
+		OutMetrics.push_back({ Prefix + "paths_evaluated_per_second", Median(EvaluatedPerSecond), "1/s" });
+		OutMetrics.push_back({ Prefix + "ir_synthesis_ms", Median(SynthesisMs), "ms" });
+	}
+
+	void RunImageSourceBenchmark(ECannedScene Scene, const FTracerBenchmarkSettings& Settings,
+	                             const FImageSourceSettings& ImageSources, std::vector<FBenchmarkMetric>& OutMetrics)
+	{
+		// Far enough to revalidate every path, close enough to keep the listener in the room
+		const FVec3 ListenerStep(10.0f, 0.0f, 0.0f);
+
+		FTriangleMeshScene MeshScene;
+		FVec3 Source;
+		FVec3 Listener;
+		BuildCannedScene(Scene, MeshScene, Source, Listener);
+		std::vector<FReflector> Reflectors;
+		AppendTriangleReflectors(MeshScene, Reflectors);
+		FTracerSettings Tracer;
+		Tracer.ImageSourceOrder = ImageSources.MaxOrder;
+
+		FImageSourceSolver Solver;
+		std::vector<double> BuildMs, ListenerMoveMs, IdleMs;
+		for (int32_t Repetition = 0; Repetition < std::max(Settings.Repetitions, 1); ++Repetition)
+		{
+			Solver.SetReflectors(Reflectors);
+			Solver.Invalidate();
+			FClock::time_point Start = FClock::now();
+			Solver.Update(MeshScene, Tracer, ImageSources, Source, Listener);
+			BuildMs.push_back(SecondsSince(Start) * 1000.0);
+
+			const FVec3 MovedListener = Repetition % 2 ? Listener - ListenerStep : Listener + ListenerStep;
+			Start = FClock::now();
+			Solver.Update(MeshScene, Tracer, ImageSources, Source, MovedListener);
+			ListenerMoveMs.push_back(SecondsSince(Start) * 1000.0);
+
+			Start = FClock::now();
+			Solver.Update(MeshScene, Tracer, ImageSources, Source, MovedListener);
+			IdleMs.push_back(SecondsSince(Start) * 1000.0);
+		}
+		Solver.Update(MeshScene, Tracer, ImageSources, Source, Listener);
+
+		const std::string Prefix = std::string("image_sources.") + GetCannedSceneName(Scene) + ".";
+		OutMetrics.push_back({ Prefix + "reflectors", static_cast<double>(Solver.NumReflectors()), "count" });
+		OutMetrics.push_back({ Prefix + "images", static_cast<double>(Solver.NumImages()), "count" });
+		OutMetrics.push_back({ Prefix + "paths", static_cast<double>(Solver.GetPaths().size()), "count" });
+		OutMetrics.push_back({ Prefix + "build_ms", Median(BuildMs), "ms" });
+		OutMetrics.push_back({ Prefix + "listener_move_ms", Median(ListenerMoveMs), "ms" });
+		OutMetrics.push_back({ Prefix + "idle_update_ms", Median(IdleMs), "ms" });
+	}
+
+	bool RunShoeboxValidation(const FTracerBenchmarkSettings& Settings, EPathEstimator Estimator, std::vector<FBenchmarkMetric>& OutMetrics)
+	{
+		constexpr int32_t RayMultiplier = 20;
+		constexpr float UnitsPerMeter = 100.0f;
+
+		FTriangleMeshScene MeshScene;
+		FVec3 Source;
+		FVec3 Listener;
+		BuildCannedScene(ECannedScene::Shoebox, MeshScene, Source, Listener);
+
+		FTracerSettings Tracer;
+		Tracer.NumRays = std::max(Settings.NumRays, 1) * RayMultiplier;
+		Tracer.SamplePattern = Settings.SamplePattern;
+		Tracer.Estimator = Estimator;
+		Tracer.MetersPerUnit = 1.0f / UnitsPerMeter;
+		// Air absorption of mid frequencies; the game's default loses so much per free path that the field stops being diffuse
+		Tracer.AirAbsorption = 0.005f;
+
+		// Eyring: the diffuse field loses -ln(1 - alpha) of its energy per reflection, one every 4V/S metres
+		const FVec3 RoomSize = FVec3(1000.0f, 800.0f, 300.0f) * Tracer.MetersPerUnit;
+		const double Volume = static_cast<double>(RoomSize.X) * RoomSize.Y * RoomSize.Z;
+		const double Area = 2.0 * (static_cast<double>(RoomSize.X) * RoomSize.Y + RoomSize.X * RoomSize.Z + RoomSize.Y * RoomSize.Z);
+		const double Albedo = MeshScene.GetMaterial(0).DiffuseAlbedo;
+		const double LossPerMeter = Area * -std::log(Albedo) / (4.0 * Volume) + Tracer.AirAbsorption;
+		const double AnalyticT60 = 6.0 * std::log(10.0) / (Tracer.SpeedOfSound * LossPerMeter);
+		// What the first reflections feed in, 4 pi (1 - alpha) / V relative to the free field at 1 m, decaying from there,
+		// but only counted from the direct sound's arrival on (Barron's revised theory)
+		const double SourceDistance = Distance(Source, Listener) * Tracer.MetersPerUnit;
+		const double AnalyticEnergy = 4.0 * Pi * Albedo / (Volume * LossPerMeter) * std::exp(-LossPerMeter * SourceDistance);
+
+		const float BinSeconds = 0.001f;
+		const int32_t NumBins = static_cast<int32_t>(std::ceil(Settings.DurationSeconds / BinSeconds));
+		std::vector<double> Energy(NumBins);
+		std::vector<double> Schroeder(NumBins);
+		FPathBatch Batch;
+		std::vector<double> T60s, Energies;
+		for (int32_t Repetition = 0; Repetition < std::max(Settings.Repetitions, 2); ++Repetition)
+		{
+			Batch.Reset();
+			TracePaths(MeshScene, Tracer, Source, Listener, Settings.Seed + static_cast<uint64_t>(Repetition), Batch);
+			std::fill(Energy.begin(), Energy.end(), 0.0);
+			double Total = 0.0;
+			for (const FPathRange& Path : Batch.ConnectedPaths)
+			{
+				const FPathEnergy Result = EvaluatePath(Tracer, Batch.GetVertices(Path), Path.NumVertices, Path.NumForwardVertices);
+				const int32_t Bin = static_cast<int32_t>(Result.DelaySeconds / BinSeconds);
+				if (Result.ReflectionOrder >= 1 && Bin < NumBins)
+				{
+					Energy[Bin] += Result.Gain / Tracer.NumRays;
+					Total += Result.Gain / Tracer.NumRays;
+				}
+			}
+			Energies.push_back(Total);
+
+			// Least-squares slope of the Schroeder curve in dB between -5 and -25 dB
+			double Remaining = 0.0;
+			for (int32_t Bin = NumBins - 1; Bin >= 0; --Bin)
+			{
+				Remaining += Energy[Bin];
+				Schroeder[Bin] = Remaining;
+			}
+			double SumT = 0.0, SumL = 0.0, SumTT = 0.0, SumTL = 0.0;
+			int32_t NumPoints = 0;
+			for (int32_t Bin = 0; Bin < NumBins && Total > 0.0; ++Bin)
+			{
+				const double Level = 10.0 * std::log10(std::max(Schroeder[Bin], 1e-30) / Total);
+				if (Level <= -5.0 && Level >= -25.0)
+				{
+					const double Time = (Bin + 0.5) * BinSeconds;
+					SumT += Time;
+					SumL += Level;
+					SumTT += Time * Time;
+					SumTL += Time * Level;
+					++NumPoints;
+				}
+			}
+			const double Slope = NumPoints >= 2 ? (NumPoints * SumTL - SumT * SumL) / (NumPoints * SumTT - SumT * SumT) : 0.0;
+			T60s.push_back(Slope < 0.0 ? -60.0 / Slope : 0.0);
+		}
+
+		const std::string ScenePrefix = Estimator == EPathEstimator::DiffuseRain ? "validation.shoebox_rain." : "validation.shoebox.";
+		auto AddEstimate = [&OutMetrics, &ScenePrefix](const std::string& Name, const std::vector<double>& Values, double Analytic, const char* Unit)
+		{
+			double Mean, StdDev;
+			MeanAndStdDev(Values, Mean, StdDev);
+			const std::string Prefix = ScenePrefix + Name;
+			const double Error = (Mean - Analytic) / Analytic;
+			const double StdErr = StdDev / std::sqrt(static_cast<double>(Values.size())) / Analytic;
+			OutMetrics.push_back({ Prefix, Mean, Unit });
+			OutMetrics.push_back({ Prefix + "_analytic", Analytic, Unit });
+			OutMetrics.push_back({ Prefix + "_error", Error, "ratio" });
+			OutMetrics.push_back({ Prefix + "_stderr", StdErr, "ratio" });
+			// a NaN error fails too
+			return std::abs(Error) <= ShoeboxModelTolerance + ShoeboxStandardErrors * StdErr;
+		};
+		const bool bT60Passed = AddEstimate("t60", T60s, AnalyticT60, "s");
+		const bool bEnergyPassed = AddEstimate("reverberant_energy", Energies, AnalyticEnergy, "ratio");
+		const bool bPassed = bT60Passed && bEnergyPassed;
+		OutMetrics.push_back({ ScenePrefix + "pass", bPassed ? 1.0 : 0.0, "bool" });
+		return bPassed;
+	}
+
+	namespace
+	{
+		std::string JsonString(const std::string& Text)
+		{
+			std::string Quoted = "\"";
+			for (const char Character : Text)
+			{
+				if (Character == '"' || Character == '\\')
+				{
+					Quoted += '\\';
+					Quoted += Character;
+				}
+				else if (static_cast<unsigned char>(Character) < 0x20)
+				{
+					char Escaped[8];
+					std::snprintf(Escaped, sizeof(Escaped), "\\u%04x", static_cast<unsigned>(Character));
+					Quoted += Escaped;
+				}
+				else
+				{
+					Quoted += Character;
+				}
+			}
+			return Quoted + "\"";
+		}
+	}
+
+	std::string FormatBenchmarkJson(const std::vector<std::pair<std::string, std::string>>& Context,
+	                                const std::vector<FBenchmarkMetric>& Metrics)
+	{
+		std::string Json = "{\n  \"schema\": \"frequensee-bench/1\",\n  \"context\": {";
+		for (size_t Index = 0; Index < Context.size(); ++Index)
+		{
+			Json += Index ? ",\n    " : "\n    ";
+			Json += JsonString(Context[Index].first) + ": " + JsonString(Context[Index].second);
+		}
+		Json += Context.empty() ? "},\n  \"metrics\": [" : "\n  },\n  \"metrics\": [";
+		for (size_t Index = 0; Index < Metrics.size(); ++Index)
+		{
+			// JSON has no NaN or infinity
+			const double Value = std::isfinite(Metrics[Index].Value) ? Metrics[Index].Value : 0.0;
+			char Number[32];
+			std::snprintf(Number, sizeof(Number), "%.9g", Value);
+			Json += Index ? ",\n    " : "\n    ";
+			Json += "{\"name\": " + JsonString(Metrics[Index].Name) + ", \"value\": " + Number + ", \"unit\": " + JsonString(Metrics[Index].Unit) + "}";
+		}
+		Json += Metrics.empty() ? "]\n}\n" : "\n  ]\n}\n";
+		return Json;
+	}
+}
@@ -0,0 +1,4 @@
+#include "Modules/ModuleManager.h"
+
+// The only engine-dependent file of this module; the headless build leaves it out
+IMPLEMENT_MODULE(FDefaultModuleImpl, FrequenSeeCore);
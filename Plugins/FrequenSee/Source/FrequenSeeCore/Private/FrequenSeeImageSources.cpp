@@ -0,0 +1,266 @@
+#include "FrequenSeeImageSources.h"
+
+#include <algorithm>
+
+#include "FrequenSeeTriangleScene.h"
+
+namespace FrequenSeeCore
+{
+	namespace
+	{
+		/** Vertices closer to a plane than this count as lying on it, not in front of or behind it. */
+		constexpr float SideEpsilon = 0.01f;
+		/** Planes whose normals are closer to parallel than this merge, if their distances match within PlaneEpsilon. */
+		constexpr float NormalEpsilon = 1e-4f;
+		constexpr float PlaneEpsilon = 0.01f;
+
+		float SignedDistance(const FReflector& Reflector, const FVec3& Point)
+		{
+			return Dot(Reflector.Normal, Point) - Reflector.Distance;
+		}
+
+		uint8_t SideBit(float Side) { return Side > 0.0f ? 1u : 2u; }
+	}
+
+	bool FReflector::operator==(const FReflector& Other) const
+	{
+		if (Normal.X != Other.Normal.X || Normal.Y != Other.Normal.Y || Normal.Z != Other.Normal.Z ||
+		    Distance != Other.Distance || bTwoSided != Other.bTwoSided || Vertices.size() != Other.Vertices.size())
+		{
+			return false;
+		}
+		for (size_t Index = 0; Index < Vertices.size(); ++Index)
+		{
+			const FVec3& A = Vertices[Index];
+			const FVec3& B = Other.Vertices[Index];
+			if (A.X != B.X || A.Y != B.Y || A.Z != B.Z)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void AppendTriangleReflectors(const FTriangleMeshScene& Scene, std::vector<FReflector>& OutReflectors)
+	{
+		const size_t FirstReflector = OutReflectors.size();
+		for (int32_t Triangle = 0; Triangle < Scene.NumTriangles(); ++Triangle)
+		{
+			FVec3 Corners[3];
+			Scene.GetTriangle(Triangle, Corners[0], Corners[1], Corners[2]);
+			FVec3 Normal = Cross(Corners[1] - Corners[0], Corners[2] - Corners[0]).GetSafeNormal();
+			if (Normal.IsNearlyZero())
+			{
+				continue;
+			}
+			// Two-sided, so either orientation is the same plane; the first non-zero component picks one
+			const float Leading = std::fabs(Normal.X) > NormalEpsilon ? Normal.X : (std::fabs(Normal.Y) > NormalEpsilon ? Normal.Y : Normal.Z);
+			if (Leading < 0.0f)
+			{
+				Normal = -Normal;
+			}
+			const float Distance = Dot(Normal, Corners[0]);
+
+			auto Found = std::find_if(OutReflectors.begin() + FirstReflector, OutReflectors.end(), [&](const FReflector& Reflector)
+			{
+				return 1.0f - Dot(Reflector.Normal, Normal) < NormalEpsilon && std::fabs(Reflector.Distance - Distance) < PlaneEpsilon;
+			});
+			if (Found == OutReflectors.end())
+			{
+				FReflector& Reflector = OutReflectors.emplace_back();
+				Reflector.Normal = Normal;
+				Reflector.Distance = Distance;
+				Found = OutReflectors.end() - 1;
+			}
+			Found->Vertices.insert(Found->Vertices.end(), Corners, Corners + 3);
+		}
+	}
+
+	void FImageSourceSolver::SetReflectors(const std::vector<FReflector>& InReflectors)
+	{
+		if (InReflectors == Reflectors)
+		{
+			return;
+		}
+		Reflectors = InReflectors;
+		Invalidate();
+
+		const size_t NumReflectors = Reflectors.size();
+		VertexSides.assign(NumReflectors * NumReflectors, 0);
+		for (size_t Plane = 0; Plane < NumReflectors; ++Plane)
+		{
+			for (size_t Other = 0; Other < NumReflectors; ++Other)
+			{
+				uint8_t& Sides = VertexSides[Plane * NumReflectors + Other];
+				for (const FVec3& Vertex : Reflectors[Other].Vertices)
+				{
+					const float Distance = SignedDistance(Reflectors[Plane], Vertex);
+					Sides |= Distance > SideEpsilon ? 1u : (Distance < -SideEpsilon ? 2u : 0u);
+				}
+			}
+		}
+	}
+
+	void FImageSourceSolver::Invalidate()
+	{
+		bImagesValid = false;
+		bPathsValid = false;
+	}
+
+	bool FImageSourceSolver::Update(const IAcousticScene& Scene, const FTracerSettings& Tracer, const FImageSourceSettings& Settings,
+	                                const FVec3& Source, const FVec3& Listener)
+	{
+		if (!bImagesValid || Settings.MaxOrder != ImagesMaxOrder || Settings.MaxImages != ImagesMaxImages ||
+		    Distance(Source, ImagesSource) > Settings.UpdateDistance)
+		{
+			BuildImages(Source, Settings);
+			bPathsValid = false;
+		}
+		if (bPathsValid && Distance(Listener, PathsListener) <= Settings.UpdateDistance)
+		{
+			return false;
+		}
+		ValidatePaths(Scene, Tracer, Settings, Source, Listener);
+		return true;
+	}
+
+	void FImageSourceSolver::BuildImages(const FVec3& Source, const FImageSourceSettings& Settings)
+	{
+		Images.clear();
+		bImagesValid = true;
+		ImagesSource = Source;
+		ImagesMaxOrder = Settings.MaxOrder;
+		ImagesMaxImages = Settings.MaxImages;
+
+		const int32_t NumReflectors = static_cast<int32_t>(Reflectors.size());
+		const size_t MaxImages = static_cast<size_t>(std::max(Settings.MaxImages, 0));
+		// Mirrors the image at ParentIndex (-1 for the source) across every reflector a path can go on to
+		auto AddChildren = [&](int32_t ParentIndex)
+		{
+			for (int32_t Reflector = 0; Reflector < NumReflectors && Images.size() < MaxImages; ++Reflector)
+			{
+				const FImage* Parent = ParentIndex >= 0 ? &Images[ParentIndex] : nullptr;
+				if (Parent && Reflector == Parent->Reflector)
+				{
+					continue;
+				}
+
+				const FReflector& Plane = Reflectors[Reflector];
+				const FVec3 Mirrored = Parent ? Parent->Position : Source;
+				const float Distance = SignedDistance(Plane, Mirrored);
+				if (std::fabs(Distance) <= SideEpsilon || (!Plane.bTwoSided && Distance < 0.0f))
+				{
+					continue;
+				}
+				const float Side = Distance > 0.0f ? 1.0f : -1.0f;
+				// The path runs from the parent's reflector to this one, so each must reach into the half-space the
+				// other reflects into
+				if (Parent && (!(VertexSides[static_cast<size_t>(Parent->Reflector) * NumReflectors + Reflector] & SideBit(Parent->Side)) ||
+				               !(VertexSides[static_cast<size_t>(Reflector) * NumReflectors + Parent->Reflector] & SideBit(Side))))
+				{
+					continue;
+				}
+
+				FImage Image;
+				Image.Position = Mirrored - Plane.Normal * (2.0f * Distance);
+				Image.Reflector = Reflector;
+				Image.Parent = ParentIndex;
+				Image.Order = Parent ? Parent->Order + 1 : 1;
+				Image.Side = Side;
+				Images.push_back(Image);
+			}
+		};
+
+		// Breadth first, so running into MaxImages drops the highest orders first
+		if (Settings.MaxOrder >= 1)
+		{
+			AddChildren(-1);
+		}
+		for (size_t ParentIndex = 0; ParentIndex < Images.size() && Images.size() < MaxImages; ++ParentIndex)
+		{
+			if (Images[ParentIndex].Order < Settings.MaxOrder)
+			{
+				AddChildren(static_cast<int32_t>(ParentIndex));
+			}
+		}
+	}
+
+	void FImageSourceSolver::ValidatePaths(const IAcousticScene& Scene, const FTracerSettings& Tracer,
+	                                       const FImageSourceSettings& Settings, const FVec3& Source, const FVec3& Listener)
+	{
+		Paths.clear();
+		bPathsValid = true;
+		PathsListener = Listener;
+
+		for (const FImage& Image : Images)
+		{
+			// The listener has to be on the side the last reflection sends the sound to
+			if (SignedDistance(Reflectors[Image.Reflector], Listener) * Image.Side <= SideEpsilon)
+			{
+				continue;
+			}
+
+			// Back from the listener through every reflection point to the source, each segment traced through the scene
+			FPathEnergy Path;
+			const float Length = Distance(Listener, Image.Position);
+			float Specular = 1.0f;
+			FVec3 Target = Listener;
+			EPathOrigin TraceOrigin = EPathOrigin::Listener;
+			bool bValid = true;
+			for (const FImage* Current = &Image; Current && bValid; Current = Current->Parent >= 0 ? &Images[Current->Parent] : nullptr)
+			{
+				const FReflector& Plane = Reflectors[Current->Reflector];
+				const FVec3 Direction = (Current->Position - Target).GetSafeNormal();
+				const float Approach = Dot(Plane.Normal, Direction);
+				const float HitDistance = std::fabs(Approach) > 1e-6f ? -SignedDistance(Plane, Target) / Approach : -1.0f;
+				FSurfaceHit Hit;
+				bValid = HitDistance > 0.0f &&
+					Scene.Trace(Target, Direction, HitDistance + Settings.PlaneTolerance, TraceOrigin, Hit) &&
+					std::fabs(SignedDistance(Plane, Hit.Position)) <= Settings.PlaneTolerance &&
+					std::fabs(Dot(Hit.Normal, Plane.Normal)) > 0.99f;
+				if (!bValid)
+				{
+					break;
+				}
+
+				if (Current == &Image)
+				{
+					Path.Direction = Direction;
+				}
+				const FSurfaceResponse& Surface = Hit.Surface;
+				Specular *= Surface.DiffuseAlbedo * (1.0f - Surface.Scattering);
+				for (int32_t Band = 0; Band < BandCount; ++Band)
+				{
+					Path.BandReflectance[Band] *= Surface.DiffuseAlbedo > 0.0f ? Surface.BandReflectance[Band] / Surface.DiffuseAlbedo : 0.0f;
+				}
+				// On to the previous reflection point, from just off this one
+				Target = Target + Direction * HitDistance + Plane.Normal * (Current->Side * Tracer.SurfaceOffset);
+				TraceOrigin = EPathOrigin::Source;
+			}
+			if (!bValid || Specular <= 0.0f)
+			{
+				continue;
+			}
+
+			// The last leg reaches the source unless something is in the way
+			const FVec3 ToSource = Source - Target;
+			const float SourceDistance = ToSource.Size();
+			FSurfaceHit Blocker;
+			if (SourceDistance > Tracer.SurfaceOffset &&
+			    Scene.Trace(Target, ToSource * (1.0f / SourceDistance), SourceDistance - Tracer.SurfaceOffset, EPathOrigin::Source, Blocker))
+			{
+				continue;
+			}
+
+			// Mirror images keep the source's spherical spreading: 1 / d^2 relative to the free field at 1 m
+			const float ScaledLength = Length * Tracer.MetersPerUnit;
+			const float SpreadingDistance = std::max(Length, Tracer.MinConnectionDistance) * Tracer.MetersPerUnit;
+			Path.Gain = Specular * std::exp(-Tracer.AirAbsorption * ScaledLength) / (SpreadingDistance * SpreadingDistance);
+			Path.DelaySeconds = ScaledLength / Tracer.SpeedOfSound;
+			Path.ReflectionOrder = Image.Order;
+			Path.TotalLength = Length;
+			Path.bDeterministic = true;
+			Paths.push_back(Path);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#include "FrequenSeeImpulseSynthesis.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace FrequenSeeCore
+{
+	void SynthesizeImpulseResponse(const FArrivalList& Arrivals, const float* BinEnergy,
+	                               const FImpulseResponseLayout& Layout, float* OutSamples)
+	{
+		constexpr float kEnergyThreshold = 1e-6f;
+		const float Pi4 = std::sqrt(4.0f * Pi);
+		const int32_t NumSamples = Layout.NumSamples;
+		const int32_t NumBins = Layout.NumBins;
+		const int32_t NumSamplesPerBin = static_cast<int32_t>(std::ceil(Layout.BinSeconds * Layout.SampleRate));
+		auto EnvelopeAmplitude = [Pi4](float Energy)
+		{
+			return std::fabs(Energy) >= kEnergyThreshold ? Energy / std::sqrt(Energy * Pi4) : 0.0f;
+		};
+
+		if (NumSamples <= 0)
+		{
+			return;
+		}
+		std::memset(OutSamples, 0, sizeof(float) * NumSamples);
+
+		const int32_t EarlyBins = std::min(static_cast<int32_t>(std::ceil(Layout.EarlySeconds / Layout.BinSeconds)), NumBins);
+		const float EarlySeconds = EarlyBins * Layout.BinSeconds;
+		const float SpikeScale = std::sqrt(static_cast<float>(NumSamplesPerBin));
+		const std::vector<FArrival>& EarlyArrivals = Arrivals.GetArrivals();
+		const int32_t NumEarlyArrivals = Arrivals.LowerBound(EarlySeconds);
+		for (int32_t Index = 0; Index < NumEarlyArrivals; ++Index)
+		{
+			const float SamplePosition = EarlyArrivals[Index].DelaySeconds * Layout.SampleRate;
+			const int32_t Sample = static_cast<int32_t>(std::floor(SamplePosition));
+			if (Sample < 0 || Sample + 1 >= NumSamples)
+			{
+				continue;
+			}
+			const float Fraction = SamplePosition - Sample;
+			const float Amplitude = SpikeScale * EnvelopeAmplitude(EarlyArrivals[Index].Energy);
+			OutSamples[Sample] += (1.0f - Fraction) * Amplitude;
+			OutSamples[Sample + 1] += Fraction * Amplitude;
+		}
+
+		// The denser tail is an envelope interpolated between the histogram bins
+		for (int32_t Bin = EarlyBins; Bin < NumBins; ++Bin)
+		{
+			const float Energy = EnvelopeAmplitude(BinEnergy[Bin]);
+			const float PrevEnergy = Bin == EarlyBins ? Energy : EnvelopeAmplitude(BinEnergy[Bin - 1]);
+			if (Energy == 0.0f && PrevEnergy == 0.0f)
+			{
+				continue; // already zeroed
+			}
+
+			const int32_t NumBinSamples = std::min(NumSamplesPerBin, NumSamples - Bin * NumSamplesPerBin);
+			for (int32_t BinSample = 0, Sample = Bin * NumSamplesPerBin; BinSample < NumBinSamples; ++BinSample, ++Sample)
+			{
+				const float Weight = static_cast<float>(BinSample) / static_cast<float>(NumSamplesPerBin);
+				OutSamples[Sample] = (1.0f - Weight) * PrevEnergy + Weight * Energy;
+			}
+		}
+
+		// One-pole smoothing, in place
+		const float FilterCoefficient = 0.25f; // Tune between (0, 1)
+		for (int32_t Sample = 1; Sample < NumSamples; ++Sample)
+		{
+			OutSamples[Sample] = FilterCoefficient * OutSamples[Sample] + (1.0f - FilterCoefficient) * OutSamples[Sample - 1];
+		}
+	}
+}
@@ -0,0 +1,343 @@
+#include "FrequenSeePathTracer.h"
+
+#include <algorithm>
+
+namespace FrequenSeeCore
+{
+	FSurfaceResponse MakeSurfaceResponse(const float* Absorption, int32_t NumBands, float Scattering)
+	{
+		FSurfaceResponse Response;
+		Response.Scattering = std::min(std::max(Scattering, 0.0f), 1.0f);
+		if (!Absorption || NumBands <= 0)
+		{
+			return Response;
+		}
+
+		Response.bHasMaterial = true;
+		float Reflected = 0.0f;
+		for (int32_t Band = 0; Band < BandCount; ++Band)
+		{
+			const float Absorbed = Absorption[std::min(Band, NumBands - 1)];
+			Response.BandReflectance[Band] = std::min(std::max(1.0f - Absorbed, 0.0f), 1.0f);
+			Reflected += Response.BandReflectance[Band];
+		}
+		Response.DiffuseAlbedo = Reflected / BandCount;
+		return Response;
+	}
+
+	bool GenerateSubpath(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Start,
+	                     EPathOrigin PathOrigin, FPathSampler& Sampler, std::vector<FPathVertex>& OutVertices)
+	{
+		FPathVertex Current;
+		Current.Position = Start;
+		Current.Probability = 1.0f;
+
+		while (true)
+		{
+			OutVertices.push_back(Current);
+
+			// Russian roulette ends the walk
+			if (Sampler.NextFloat() >= Settings.ContinueProbability)
+			{
+				return true;
+			}
+
+			// Omnidirectional at the source and listener, Lambertian off surfaces
+			FVec3 Direction;
+			float DirectionPdf;
+			if (Current.Normal.IsNearlyZero())
+			{
+				Direction = Sampler.UnitVector();
+				DirectionPdf = UniformSpherePdf();
+			}
+			else
+			{
+				Direction = Sampler.CosineHemisphereVector(Current.Normal);
+				DirectionPdf = CosineHemispherePdf(Dot(Direction, Current.Normal));
+			}
+
+			FSurfaceHit Hit;
+			if (!Scene.Trace(Current.Position, Direction, Settings.MaxRayDistance, PathOrigin, Hit))
+			{
+				return false;
+			}
+			Current.Position = Hit.Position + Hit.Normal * Settings.SurfaceOffset;
+			Current.Normal = Hit.Normal;
+			Current.Surface = Hit.Surface;
+			Current.bImageSourceReflector = Hit.bImageSourceReflector;
+			Current.Probability = DirectionPdf * Settings.ContinueProbability;
+		}
+	}
+
+	bool ConnectSubpaths(const IAcousticScene& Scene, const FTracerSettings& Settings, FPathBatch& Batch,
+	                     int32_t ForwardPath, int32_t BackwardPath)
+	{
+		++Batch.NumConnectionAttempts;
+		const FPathRange Forward = Batch.ForwardPaths[ForwardPath];
+		const FPathRange Backward = Batch.BackwardPaths[BackwardPath];
+		if (Forward.NumVertices == 0 || Backward.NumVertices == 0 || Forward.bEscaped || Backward.bEscaped)
+		{
+			return false;
+		}
+
+		const FVec3 ForwardEnd = Batch.Vertices[Forward.FirstVertex + Forward.NumVertices - 1].Position;
+		const FVec3 BackwardEnd = Batch.Vertices[Backward.FirstVertex + Backward.NumVertices - 1].Position;
+		const FVec3 ConnectionEnd = BackwardEnd - (BackwardEnd - ForwardEnd).GetSafeNormal() * Settings.SurfaceOffset;
+		if (!Scene.IsVisible(ForwardEnd, ConnectionEnd))
+		{
+			return false;
+		}
+
+		// The connected path gets its own copy of the vertices, source to listener, so it can be evaluated as one range
+		FPathRange Connected;
+		Connected.FirstVertex = static_cast<int32_t>(Batch.Vertices.size());
+		Connected.NumVertices = Forward.NumVertices + Backward.NumVertices;
+		Connected.NumForwardVertices = Forward.NumVertices;
+		Batch.Vertices.resize(Batch.Vertices.size() + Connected.NumVertices);
+		FPathVertex* Vertices = Batch.Vertices.data();
+		std::copy(Vertices + Forward.FirstVertex, Vertices + Forward.FirstVertex + Forward.NumVertices,
+		          Vertices + Connected.FirstVertex);
+		std::reverse_copy(Vertices + Backward.FirstVertex, Vertices + Backward.FirstVertex + Backward.NumVertices,
+		                  Vertices + Connected.FirstVertex + Forward.NumVertices);
+		Batch.ConnectedPaths.push_back(Connected);
+		return true;
+	}
+
+	namespace
+	{
+		/** TraceRays() for diffuse rain: the forward subpaths first, then all of their shadow rays in one batch. */
+		void TraceDiffuseRain(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Source,
+		                      const FVec3& Listener, uint64_t Seed, int32_t FirstRay, int32_t NumRays, FPathBatch& OutPaths)
+		{
+			const size_t FirstPath = OutPaths.ForwardPaths.size();
+			OutPaths.ForwardPaths.reserve(FirstPath + static_cast<size_t>(NumRays));
+			for (int32_t Ray = FirstRay; Ray < FirstRay + NumRays; ++Ray)
+			{
+				FPathRange Forward;
+				Forward.FirstVertex = static_cast<int32_t>(OutPaths.Vertices.size());
+				FPathSampler Sampler(Settings.SamplePattern, Seed, static_cast<uint32_t>(Ray), 0);
+				// The vertices before an escape still see the listener, so escaped walks are kept
+				Forward.bEscaped = !GenerateSubpath(Scene, Settings, Source, EPathOrigin::Source, Sampler, OutPaths.Vertices);
+				Forward.NumVertices = static_cast<int32_t>(OutPaths.Vertices.size()) - Forward.FirstVertex;
+				OutPaths.ForwardPaths.push_back(Forward);
+			}
+
+			// One shadow ray per vertex, to where the segment towards the listener enters its sphere
+			std::vector<FVec3>& From = OutPaths.ShadowFrom;
+			std::vector<FVec3>& To = OutPaths.ShadowTo;
+			const size_t NumShadowRays = OutPaths.Vertices.size() - static_cast<size_t>(OutPaths.ForwardPaths[FirstPath].FirstVertex);
+			From.clear();
+			To.clear();
+			From.reserve(NumShadowRays);
+			To.reserve(NumShadowRays);
+			for (size_t Path = FirstPath; Path < OutPaths.ForwardPaths.size(); ++Path)
+			{
+				const FPathRange& Forward = OutPaths.ForwardPaths[Path];
+				for (int32_t Index = 0; Index < Forward.NumVertices; ++Index)
+				{
+					const FVec3& Position = OutPaths.Vertices[Forward.FirstVertex + Index].Position;
+					const FVec3 ToListener = Listener - Position;
+					const float Distance = ToListener.Size();
+					From.push_back(Position);
+					To.push_back(Distance > Settings.ListenerRadius ? Position + ToListener * (1.0f - Settings.ListenerRadius / Distance) : Position);
+				}
+			}
+			std::vector<uint8_t>& Visible = OutPaths.ShadowVisible;
+			Visible.resize(From.size());
+			Scene.AreVisible(From.data(), To.data(), static_cast<int32_t>(From.size()), Visible.data());
+			OutPaths.NumConnectionAttempts += static_cast<int32_t>(From.size());
+
+			// Each visible vertex ends a connected path: the forward subpath up to it, then the listener
+			FPathVertex ListenerVertex;
+			ListenerVertex.Position = Listener;
+			ListenerVertex.Probability = 1.0f;
+			size_t ShadowRay = 0;
+			for (size_t Path = FirstPath; Path < OutPaths.ForwardPaths.size(); ++Path)
+			{
+				const FPathRange Forward = OutPaths.ForwardPaths[Path];
+				for (int32_t Index = 0; Index < Forward.NumVertices; ++Index)
+				{
+					if (!Visible[ShadowRay++])
+					{
+						continue;
+					}
+					FPathRange Connected;
+					Connected.FirstVertex = static_cast<int32_t>(OutPaths.Vertices.size());
+					Connected.NumVertices = Index + 2;
+					Connected.NumForwardVertices = Index + 1;
+					OutPaths.Vertices.resize(OutPaths.Vertices.size() + Connected.NumVertices);
+					FPathVertex* Vertices = OutPaths.Vertices.data();
+					std::copy(Vertices + Forward.FirstVertex, Vertices + Forward.FirstVertex + Index + 1, Vertices + Connected.FirstVertex);
+					Vertices[Connected.FirstVertex + Index + 1] = ListenerVertex;
+					OutPaths.ConnectedPaths.push_back(Connected);
+				}
+			}
+		}
+	}
+
+	void TraceRays(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Source,
+	               const FVec3& Listener, uint64_t Seed, int32_t FirstRay, int32_t NumRays, FPathBatch& OutPaths)
+	{
+		// Russian roulette at 0.9 gives ten vertices per subpath on average, twenty per connected path
+		constexpr size_t ExpectedVerticesPerRay = 40;
+
+		NumRays = std::max(NumRays, 0);
+		if (Settings.Estimator == EPathEstimator::DiffuseRain)
+		{
+			if (NumRays > 0)
+			{
+				TraceDiffuseRain(Scene, Settings, Source, Listener, Seed, FirstRay, NumRays, OutPaths);
+			}
+			return;
+		}
+
+		const size_t NumReserved = static_cast<size_t>(NumRays);
+		OutPaths.Vertices.reserve(OutPaths.Vertices.size() + NumReserved * ExpectedVerticesPerRay);
+		OutPaths.ForwardPaths.reserve(OutPaths.ForwardPaths.size() + NumReserved);
+		OutPaths.BackwardPaths.reserve(OutPaths.BackwardPaths.size() + NumReserved);
+		OutPaths.ConnectedPaths.reserve(OutPaths.ConnectedPaths.size() + NumReserved);
+		for (int32_t Ray = FirstRay; Ray < FirstRay + NumRays; ++Ray)
+		{
+			FPathRange Forward;
+			Forward.FirstVertex = static_cast<int32_t>(OutPaths.Vertices.size());
+			FPathSampler ForwardSampler(Settings.SamplePattern, Seed, static_cast<uint32_t>(Ray), 0);
+			Forward.bEscaped = !GenerateSubpath(Scene, Settings, Source, EPathOrigin::Source, ForwardSampler, OutPaths.Vertices);
+			Forward.NumVertices = static_cast<int32_t>(OutPaths.Vertices.size()) - Forward.FirstVertex;
+			OutPaths.ForwardPaths.push_back(Forward);
+
+			FPathRange Backward;
+			Backward.FirstVertex = static_cast<int32_t>(OutPaths.Vertices.size());
+			FPathSampler BackwardSampler(Settings.SamplePattern, Seed, static_cast<uint32_t>(Ray), 1);
+			Backward.bEscaped = !GenerateSubpath(Scene, Settings, Listener, EPathOrigin::Listener, BackwardSampler, OutPaths.Vertices);
+			Backward.NumVertices = static_cast<int32_t>(OutPaths.Vertices.size()) - Backward.FirstVertex;
+			OutPaths.BackwardPaths.push_back(Backward);
+
+			ConnectSubpaths(Scene, Settings, OutPaths, static_cast<int32_t>(OutPaths.ForwardPaths.size()) - 1,
+			                static_cast<int32_t>(OutPaths.BackwardPaths.size()) - 1);
+		}
+	}
+
+	void TracePaths(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Source,
+	                const FVec3& Listener, uint64_t Seed, FPathBatch& OutPaths)
+	{
+		TraceRays(Scene, Settings, Source, Listener, Seed, 0, Settings.NumRays, OutPaths);
+	}
+
+	void AppendPaths(const FPathBatch& Paths, FPathBatch& OutPaths)
+	{
+		const int32_t VertexOffset = static_cast<int32_t>(OutPaths.Vertices.size());
+		OutPaths.Vertices.insert(OutPaths.Vertices.end(), Paths.Vertices.begin(), Paths.Vertices.end());
+		auto AppendRanges = [VertexOffset](const std::vector<FPathRange>& Ranges, std::vector<FPathRange>& OutRanges)
+		{
+			for (FPathRange Range : Ranges)
+			{
+				Range.FirstVertex += VertexOffset;
+				OutRanges.push_back(Range);
+			}
+		};
+		AppendRanges(Paths.ForwardPaths, OutPaths.ForwardPaths);
+		AppendRanges(Paths.BackwardPaths, OutPaths.BackwardPaths);
+		AppendRanges(Paths.ConnectedPaths, OutPaths.ConnectedPaths);
+		OutPaths.NumConnectionAttempts += Paths.NumConnectionAttempts;
+	}
+
+	FPathEnergy EvaluatePath(const FTracerSettings& Settings, const FPathVertex* Vertices, int32_t NumVertices,
+	                         int32_t NumForwardVertices)
+	{
+		FPathEnergy Result;
+		if (NumVertices < 2)
+		{
+			return Result;
+		}
+		const bool bValidSplit = NumForwardVertices >= 1 && NumForwardVertices < NumVertices;
+
+		// Energy a vertex sends along Direction per unit of what reaches it: a unit-power omnidirectional source's
+		// intensity, an omnidirectional listener's full sensitivity, or a Lambertian surface's BSDF times its cosine
+		auto Response = [Vertices, NumVertices](int32_t Index, const FVec3& Direction)
+		{
+			if (Index == 0)
+			{
+				return 1.0f / (4.0f * Pi);
+			}
+			if (Index == NumVertices - 1)
+			{
+				return 1.0f;
+			}
+			const FPathVertex& Vertex = Vertices[Index];
+			return Vertex.Surface.DiffuseAlbedo / Pi * std::max(Dot(Vertex.Normal, Direction), 0.0f);
+		};
+
+		float Length = 0.0f;
+		float ScaledDistance = 0.0f;
+		float Energy = 1.0f;
+		for (int32_t Index = 0; Index + 1 < NumVertices; ++Index)
+		{
+			const FVec3 Segment = Vertices[Index + 1].Position - Vertices[Index].Position;
+			const float SegmentLength = Segment.Size();
+			const FVec3 Direction = Segment.GetSafeNormal();
+			Length += SegmentLength;
+			ScaledDistance += SegmentLength * Settings.MetersPerUnit;
+			if (!bValidSplit)
+			{
+				continue;
+			}
+
+			if (Index + 1 < NumForwardVertices)
+			{
+				// Sampled from the forward subpath
+				const float Probability = Vertices[Index + 1].Probability;
+				Energy *= Probability > 0.0f ? Response(Index, Direction) / Probability : 0.0f;
+			}
+			else if (Index + 1 == NumForwardVertices)
+			{
+				// The connection
+				const float MinDistance = Settings.Estimator == EPathEstimator::DiffuseRain ? Settings.ListenerRadius : Settings.MinConnectionDistance;
+				const float ConnectionDistance = std::max(SegmentLength, MinDistance) * Settings.MetersPerUnit;
+				Energy *= Response(Index, Direction) * Response(Index + 1, -Direction) / (ConnectionDistance * ConnectionDistance);
+			}
+			else
+			{
+				// Sampled from the backward subpath, towards the source
+				const float Probability = Vertices[Index].Probability;
+				Energy *= Probability > 0.0f ? Response(Index + 1, -Direction) / Probability : 0.0f;
+			}
+			// Media term (equation 3)
+			Energy *= std::exp(-Settings.AirAbsorption * SegmentLength * Settings.MetersPerUnit);
+		}
+
+		float Specular = 1.0f;
+		bool bImageSourcesCover = true;
+		for (int32_t Index = 1; Index + 1 < NumVertices; ++Index)
+		{
+			bImageSourcesCover &= Vertices[Index].bImageSourceReflector;
+			const FSurfaceResponse& Surface = Vertices[Index].Surface;
+			for (int32_t Band = 0; Band < BandCount; ++Band)
+			{
+				Result.BandReflectance[Band] *= Surface.DiffuseAlbedo > 0.0f ? Surface.BandReflectance[Band] / Surface.DiffuseAlbedo : 0.0f;
+			}
+			Specular *= 1.0f - Surface.Scattering;
+		}
+		// The image sources have the purely specular part of the early reflections, exactly, but only off the
+		// surfaces they mirror; anywhere else the tracer keeps all of it
+		if (bImageSourcesCover && NumVertices - 2 >= 1 && NumVertices - 2 <= Settings.ImageSourceOrder)
+		{
+			Energy *= 1.0f - Specular;
+		}
+
+		if (Settings.Estimator == EPathEstimator::Bidirectional)
+		{
+			// Both walks stopped at roulette, and any of the NumVertices - 1 splits of the path could have traced it
+			const float StopProbability = 1.0f - Settings.ContinueProbability;
+			Energy /= StopProbability * StopProbability * static_cast<float>(NumVertices - 1);
+		}
+
+		const FVec3& Listener = Vertices[NumVertices - 1].Position;
+		Result.Direction = (Vertices[NumVertices - 2].Position - Listener).GetSafeNormal();
+		Result.DelaySeconds = ScaledDistance / Settings.SpeedOfSound;
+		// Relative to the free field 1 m from the source, where the unit-power source's intensity is 1 / (4 pi)
+		Result.Gain = bValidSplit ? Energy * 4.0f * Pi : 0.0f;
+		Result.ReflectionOrder = NumVertices - 2;
+		Result.TotalLength = Length;
+		return Result;
+	}
+}
@@ -0,0 +1,231 @@
+#include "FrequenSeeTriangleScene.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace FrequenSeeCore
+{
+	namespace
+	{
+		constexpr int32_t MaxTrianglesPerLeaf = 4;
+		constexpr float HitEpsilon = 1e-6f;
+
+		FVec3 Min(const FVec3& A, const FVec3& B)
+		{
+			return FVec3(std::min(A.X, B.X), std::min(A.Y, B.Y), std::min(A.Z, B.Z));
+		}
+
+		FVec3 Max(const FVec3& A, const FVec3& B)
+		{
+			return FVec3(std::max(A.X, B.X), std::max(A.Y, B.Y), std::max(A.Z, B.Z));
+		}
+
+		/** Slab test against a node's bounds; InverseDirection may hold infinities. */
+		bool IntersectsBounds(const FVec3& BoundsMin, const FVec3& BoundsMax, const FVec3& Origin,
+		                      const FVec3& InverseDirection, float MaxDistance)
+		{
+			float Near = 0.0f;
+			float Far = MaxDistance;
+			for (int32_t Axis = 0; Axis < 3; ++Axis)
+			{
+				float T0 = (BoundsMin[Axis] - Origin[Axis]) * InverseDirection[Axis];
+				float T1 = (BoundsMax[Axis] - Origin[Axis]) * InverseDirection[Axis];
+				if (T0 > T1)
+				{
+					std::swap(T0, T1);
+				}
+				// NaN from 0 * inf (origin on the slab plane of a parallel ray) keeps the current interval
+				Near = T0 > Near ? T0 : Near;
+				Far = T1 < Far ? T1 : Far;
+				if (Near > Far)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	int32_t FTriangleMeshScene::AddMaterial(const FSurfaceResponse& Surface)
+	{
+		Materials.push_back(Surface);
+		return static_cast<int32_t>(Materials.size()) - 1;
+	}
+
+	void FTriangleMeshScene::AddTriangle(const FVec3& A, const FVec3& B, const FVec3& C, int32_t Material)
+	{
+		FTriangle& Triangle = Triangles.emplace_back();
+		Triangle.Vertex0 = A;
+		Triangle.Edge1 = B - A;
+		Triangle.Edge2 = C - A;
+		Triangle.Normal = Cross(Triangle.Edge1, Triangle.Edge2).GetSafeNormal();
+		Triangle.Centroid = (A + B + C) * (1.0f / 3.0f);
+		Triangle.Material = Material;
+	}
+
+	void FTriangleMeshScene::GetTriangle(int32_t Index, FVec3& OutA, FVec3& OutB, FVec3& OutC) const
+	{
+		const FTriangle& Triangle = Triangles[Index];
+		OutA = Triangle.Vertex0;
+		OutB = Triangle.Vertex0 + Triangle.Edge1;
+		OutC = Triangle.Vertex0 + Triangle.Edge2;
+	}
+
+	void FTriangleMeshScene::Build()
+	{
+		Nodes.clear();
+		if (!Triangles.empty())
+		{
+			Nodes.reserve(2 * Triangles.size() / MaxTrianglesPerLeaf + 1);
+			BuildNode(0, static_cast<int32_t>(Triangles.size()));
+		}
+	}
+
+	int32_t FTriangleMeshScene::BuildNode(int32_t First, int32_t Count)
+	{
+		const int32_t NodeIndex = static_cast<int32_t>(Nodes.size());
+		Nodes.emplace_back();
+
+		FVec3 BoundsMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		FVec3 BoundsMax = -BoundsMin;
+		FVec3 CentroidMin = BoundsMin;
+		FVec3 CentroidMax = BoundsMax;
+		for (int32_t Index = First; Index < First + Count; ++Index)
+		{
+			const FTriangle& Triangle = Triangles[Index];
+			const FVec3 Vertex1 = Triangle.Vertex0 + Triangle.Edge1;
+			const FVec3 Vertex2 = Triangle.Vertex0 + Triangle.Edge2;
+			BoundsMin = Min(Min(BoundsMin, Triangle.Vertex0), Min(Vertex1, Vertex2));
+			BoundsMax = Max(Max(BoundsMax, Triangle.Vertex0), Max(Vertex1, Vertex2));
+			CentroidMin = Min(CentroidMin, Triangle.Centroid);
+			CentroidMax = Max(CentroidMax, Triangle.Centroid);
+		}
+		Nodes[NodeIndex].BoundsMin = BoundsMin;
+		Nodes[NodeIndex].BoundsMax = BoundsMax;
+
+		if (Count <= MaxTrianglesPerLeaf)
+		{
+			Nodes[NodeIndex].Index = First;
+			Nodes[NodeIndex].NumTriangles = Count;
+			return NodeIndex;
+		}
+
+		// Median split along the widest spread of centroids
+		const FVec3 Extent = CentroidMax - CentroidMin;
+		const int32_t Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+		const int32_t Half = Count / 2;
+		std::nth_element(Triangles.begin() + First, Triangles.begin() + First + Half, Triangles.begin() + First + Count,
+		                 [Axis](const FTriangle& A, const FTriangle& B) { return A.Centroid[Axis] < B.Centroid[Axis]; });
+
+		BuildNode(First, Half);
+		const int32_t SecondChild = BuildNode(First + Half, Count - Half);
+		Nodes[NodeIndex].Index = SecondChild;
+		return NodeIndex;
+	}
+
+	bool FTriangleMeshScene::Intersect(const FVec3& Origin, const FVec3& Direction, float MaxDistance, bool bAnyHit,
+	                                   float& OutDistance, int32_t& OutTriangle) const
+	{
+		if (Nodes.empty())
+		{
+			return false;
+		}
+
+		const FVec3 InverseDirection(1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z);
+		float Closest = MaxDistance;
+		OutTriangle = -1;
+
+		int32_t Stack[64];
+		int32_t StackSize = 0;
+		Stack[StackSize++] = 0;
+		while (StackSize > 0)
+		{
+			const FNode& Node = Nodes[Stack[--StackSize]];
+			if (!IntersectsBounds(Node.BoundsMin, Node.BoundsMax, Origin, InverseDirection, Closest))
+			{
+				continue;
+			}
+
+			if (Node.NumTriangles == 0)
+			{
+				Stack[StackSize++] = static_cast<int32_t>(&Node - Nodes.data()) + 1;
+				Stack[StackSize++] = Node.Index;
+				continue;
+			}
+
+			// Moeller-Trumbore, both sides
+			for (int32_t Index = Node.Index; Index < Node.Index + Node.NumTriangles; ++Index)
+			{
+				const FTriangle& Triangle = Triangles[Index];
+				const FVec3 P = Cross(Direction, Triangle.Edge2);
+				const float Determinant = Dot(Triangle.Edge1, P);
+				if (std::fabs(Determinant) < 1e-12f)
+				{
+					continue;
+				}
+				const float InverseDeterminant = 1.0f / Determinant;
+				const FVec3 ToOrigin = Origin - Triangle.Vertex0;
+				const float U = Dot(ToOrigin, P) * InverseDeterminant;
+				if (U < 0.0f || U > 1.0f)
+				{
+					continue;
+				}
+				const FVec3 Q = Cross(ToOrigin, Triangle.Edge1);
+				const float V = Dot(Direction, Q) * InverseDeterminant;
+				if (V < 0.0f || U + V > 1.0f)
+				{
+					continue;
+				}
+				const float T = Dot(Triangle.Edge2, Q) * InverseDeterminant;
+				if (T > HitEpsilon && T < Closest)
+				{
+					Closest = T;
+					OutTriangle = Index;
+					if (bAnyHit)
+					{
+						OutDistance = Closest;
+						return true;
+					}
+				}
+			}
+		}
+
+		OutDistance = Closest;
+		return OutTriangle >= 0;
+	}
+
+	bool FTriangleMeshScene::Trace(const FVec3& Origin, const FVec3& Direction, float MaxDistance, EPathOrigin /*PathOrigin*/,
+	                               FSurfaceHit& OutHit) const
+	{
+		float HitDistance = 0.0f;
+		int32_t HitTriangle = -1;
+		if (!Intersect(Origin, Direction, MaxDistance, false, HitDistance, HitTriangle))
+		{
+			return false;
+		}
+
+		const FTriangle& Triangle = Triangles[HitTriangle];
+		OutHit.Position = Origin + Direction * HitDistance;
+		OutHit.Normal = Dot(Triangle.Normal, Direction) > 0.0f ? -Triangle.Normal : Triangle.Normal;
+		OutHit.Surface = Triangle.Material >= 0 && Triangle.Material < static_cast<int32_t>(Materials.size())
+			? Materials[Triangle.Material]
+			: FSurfaceResponse();
+		// AppendTriangleReflectors() turns every triangle into a reflector
+		OutHit.bImageSourceReflector = true;
+		return true;
+	}
+
+	bool FTriangleMeshScene::IsVisible(const FVec3& From, const FVec3& To) const
+	{
+		const FVec3 Segment = To - From;
+		const float Length = Segment.Size();
+		if (Length <= HitEpsilon)
+		{
+			return true;
+		}
+
+		float HitDistance = 0.0f;
+		int32_t HitTriangle = -1;
+		return !Intersect(From, Segment * (1.0f / Length), Length, true, HitDistance, HitTriangle);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "FrequenSeeCoreTypes.h"
+
+namespace FrequenSeeCore
+{
+	/** Acoustic response of a surface, carried by value so traced paths never point back into the scene. */
+	struct FSurfaceResponse
+	{
+		bool bHasMaterial = false;
+		/** Share of the incident energy reflected, averaged over the bands; the diffuse BSDF is DiffuseAlbedo / Pi. */
+		float DiffuseAlbedo = 1.0f;
+		/** 1 - absorption per band. */
+		float BandReflectance[BandCount] = { 1.0f, 1.0f, 1.0f };
+		/**
+		 * Share of the reflected energy scattered diffusely; the rest reflects specularly, which the image sources
+		 * render exactly for the orders and reflectors they cover (the tracer treats everything else as diffuse). 0, a
+		 * mirror, is also the default of the plugin's materials.
+		 */
+		float Scattering = 0.0f;
+	};
+
+	/**
+	 * Response of a material from its absorption curve, NumBands coefficients in 0..1 (curves shorter than BandCount
+	 * repeat their last value), and its broadband scattering coefficient. The plugin's materials and the headless scenes
+	 * both go through here, so the same values produce the same paths in and out of the engine.
+	 */
+	FREQUENSEECORE_API FSurfaceResponse MakeSurfaceResponse(const float* Absorption, int32_t NumBands, float Scattering = 0.0f);
+
+	struct FSurfaceHit
+	{
+		FVec3 Position;
+		FVec3 Normal;
+		FSurfaceResponse Surface;
+		/** Whether the hit lies on a reflector the image sources mirror; only there do they render the specular share. */
+		bool bImageSourceReflector = false;
+	};
+
+	/** Which end of a bidirectional path a subpath starts from. */
+	enum class EPathOrigin : uint8_t
+	{
+		Source,
+		Listener,
+	};
+
+	/** The geometry paths are traced against. Implementations must be safe to query from several threads at once. */
+	class IAcousticScene
+	{
+	public:
+		virtual ~IAcousticScene() = default;
+
+		/**
+		 * Closest surface along the unit vector Direction within MaxDistance of Origin. Scenes that give the source or
+		 * listener a body skip it for subpaths starting from that end.
+		 */
+		virtual bool Trace(const FVec3& Origin, const FVec3& Direction, float MaxDistance, EPathOrigin PathOrigin,
+		                   FSurfaceHit& OutHit) const = 0;
+
+		/** Whether nothing blocks the segment between From and To. */
+		virtual bool IsVisible(const FVec3& From, const FVec3& To) const = 0;
+
+		/**
+		 * IsVisible() for NumSegments segments at once, OutVisible[Index] set to 1 or 0, for scenes that answer a batch
+		 * of queries faster than one at a time.
+		 */
+		virtual void AreVisible(const FVec3* From, const FVec3* To, int32_t NumSegments, uint8_t* OutVisible) const
+		{
+			for (int32_t Index = 0; Index < NumSegments; ++Index)
+			{
+				OutVisible[Index] = IsVisible(From[Index], To[Index]) ? 1 : 0;
+			}
+		}
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FrequenSeeCoreTypes.h"
+
+namespace FrequenSeeCore
+{
+	/** One traced arrival at the listener. */
+	struct FArrival
+	{
+		float DelaySeconds = 0.0f;
+		/** Broadband energy, already normalized by the ray count. */
+		float Energy = 0.0f;
+		/** Unit vector from the listener towards where the arrival comes from; zero if unknown. */
+		FVec3 Direction;
+		/** Energy per band. */
+		float BandEnergy[BandCount] = {};
+	};
+
+	/**
+	 * Delay-ordered list of the arrivals one trace produced, the ray tracer's output before binning. At low ray counts
+	 * most histogram bins stay empty, so this is smaller and cheaper to fill than dense histograms; ToHistograms() bins it
+	 * in one pass when a dense view is needed and the early part of an impulse response can be rendered from it directly.
+	 */
+	class FREQUENSEECORE_API FArrivalList
+	{
+	public:
+		void Reset();
+		/** Reset() that also frees the storage. */
+		void Empty();
+
+		void Add(const FArrival& Arrival);
+
+		/** Sorts by delay if arrivals came out of order. Call after the last Add() and before reading. */
+		void Finalize();
+
+		const std::vector<FArrival>& GetArrivals() const { return Arrivals; }
+		int32_t Num() const { return static_cast<int32_t>(Arrivals.size()); }
+		size_t GetAllocatedSize() const { return Arrivals.capacity() * sizeof(FArrival); }
+
+		/** Index of the first arrival at or after DelaySeconds. Needs Finalize(). */
+		int32_t LowerBound(float DelaySeconds) const;
+
+		/**
+		 * Overwrites NumBins bins of BinSeconds with the broadband energy and, if OutBandEnergy is given, with the energy
+		 * of each band. Arrivals past the last bin land in it.
+		 */
+		void ToHistograms(float BinSeconds, int32_t NumBins, float* OutEnergy, float* const* OutBandEnergy = nullptr) const;
+
+	private:
+		std::vector<FArrival> Arrivals;
+		bool bSorted = true;
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FrequenSeeImageSources.h"
+#include "FrequenSeePathTracer.h"
+#include "FrequenSeeTriangleScene.h"
+
+namespace FrequenSeeCore
+{
+	/** Procedural scenes the benchmarks trace, identical on every machine and in and out of the engine. */
+	enum class ECannedScene : uint8_t
+	{
+		/** 10 x 8 x 3 m room, 12 triangles: the tracer's fixed cost per ray. */
+		Shoebox,
+		/** 40 m corridor with staggered pillars, so only some subpaths connect. */
+		Corridor,
+		/** 20 x 15 x 5 m hall with finely tessellated walls and crates, around 13k triangles: the BVH's share. */
+		Cluttered,
+	};
+
+	constexpr int32_t NumCannedScenes = 3;
+
+	FREQUENSEECORE_API const char* GetCannedSceneName(ECannedScene Scene);
+
+	/** Builds Scene into OutScene (in centimetres, like the plugin) and picks its source and listener positions. */
+	FREQUENSEECORE_API void BuildCannedScene(ECannedScene Scene, FTriangleMeshScene& OutScene, FVec3& OutSource, FVec3& OutListener);
+
+	/** One measured number. Names are dotted paths, stable across commits so results can be compared. */
+	struct FBenchmarkMetric
+	{
+		std::string Name;
+		double Value = 0.0;
+		std::string Unit;
+	};
+
+	struct FTracerBenchmarkSettings
+	{
+		/** Subpath pairs per trace, USED_RAY_COUNT in the plugin. */
+		int32_t NumRays = 1000;
+		/** Timings are the median over this many runs. */
+		int32_t Repetitions = 5;
+		uint64_t Seed = 1;
+		ESamplePattern SamplePattern = ESamplePattern::Sobol;
+		/** Layout of the synthesized impulse response. */
+		float SampleRate = 48000.0f;
+		float DurationSeconds = 1.0f;
+		float BinSeconds = 0.001f;
+	};
+
+	/**
+	 * Times subpath tracing (rays/s, i.e. GenerateSubpath's scene queries), subpath connection, path evaluation and
+	 * impulse response synthesis on Scene and appends the results as tracer.<scene>.* metrics. Whole traces are also
+	 * timed with each estimator, tracer.<scene>.<bdpt|rain>.*, with the spread of their total energy over the
+	 * repetitions, so the cheaper estimator for a scene is the one with the smaller trace_ms * energy_rel_stddev^2.
+	 */
+	FREQUENSEECORE_API void RunTracerBenchmark(ECannedScene Scene, const FTracerBenchmarkSettings& Settings,
+	                                           std::vector<FBenchmarkMetric>& OutMetrics);
+
+	/**
+	 * Times FImageSourceSolver on Scene's reflector planes: building the image tree up to Settings' order, revalidating
+	 * its paths after the listener moved, and an update with neither end moved. Appends image_sources.<scene>.* metrics.
+	 */
+	FREQUENSEECORE_API void RunImageSourceBenchmark(ECannedScene Scene, const FTracerBenchmarkSettings& Settings,
+	                                                const FImageSourceSettings& ImageSources, std::vector<FBenchmarkMetric>& OutMetrics);
+
+	/** Relative error the analytic shoebox models themselves allow, and how many standard errors of noise go on top. */
+	constexpr double ShoeboxModelTolerance = 0.1;
+	constexpr double ShoeboxStandardErrors = 4.0;
+
+	/**
+	 * Checks the tracer's estimate against the analytic decay of a diffuse field (Eyring, plus air absorption) in the
+	 * shoebox scene, taken at real scale (1 unit = 1 cm): the reverberation time from the Schroeder curve's -5 to -25 dB
+	 * slope, and the total reverberant energy against Barron's revised theory, each averaged over Settings.Repetitions
+	 * traces of 20 * Settings.NumRays rays. Appends validation.shoebox.* metrics, the *_error ones relative to the
+	 * analytic values and the *_stderr ones the standard error of the mean, likewise relative. The models are only good
+	 * to about 10% in this room, so an unbiased tracer stays within that plus a few standard errors: the estimate
+	 * passes when both errors are within ShoeboxModelTolerance + ShoeboxStandardErrors * stderr, recorded as
+	 * validation.shoebox.pass and returned. Diffuse rain's metrics are validation.shoebox_rain.*.
+	 */
+	FREQUENSEECORE_API bool RunShoeboxValidation(const FTracerBenchmarkSettings& Settings, EPathEstimator Estimator,
+	                                             std::vector<FBenchmarkMetric>& OutMetrics);
+
+	/**
+	 * Results as one JSON document, {"schema", "context": {...}, "metrics": [{"name", "value", "unit"}...]}, the format
+	 * both the headless and the in-engine benchmarks write so per-commit results can be tracked side by side.
+	 */
+	FREQUENSEECORE_API std::string FormatBenchmarkJson(const std::vector<std::pair<std::string, std::string>>& Context,
+	                                                   const std::vector<FBenchmarkMetric>& Metrics);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Defined by UnrealBuildTool inside the engine; the headless build links the core statically
+#ifndef FREQUENSEECORE_API
+#define FREQUENSEECORE_API
+#endif
+
+/**
+ * Engine-independent acoustic simulation core: path generation and connection, path evaluation, arrival binning and
+ * impulse response synthesis. Nothing in here may include engine headers; the plugin drives it through a scene
+ * adapter and Tools/FrequenSeeCLI drives it headless on a triangle mesh.
+ */
+namespace FrequenSeeCore
+{
+	constexpr float Pi = 3.14159265358979323846f;
+
+	/** Frequency bands of every per-band quantity (AcousticBandCount in the plugin). */
+	constexpr int32_t BandCount = 3;
+
+	struct FVec3
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+
+		FVec3() = default;
+		FVec3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FVec3 operator+(const FVec3& Other) const { return FVec3(X + Other.X, Y + Other.Y, Z + Other.Z); }
+		FVec3 operator-(const FVec3& Other) const { return FVec3(X - Other.X, Y - Other.Y, Z - Other.Z); }
+		FVec3 operator*(float Scale) const { return FVec3(X * Scale, Y * Scale, Z * Scale); }
+		FVec3 operator-() const { return FVec3(-X, -Y, -Z); }
+
+		float operator[](int32_t Axis) const { return Axis == 0 ? X : (Axis == 1 ? Y : Z); }
+
+		float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+		float Size() const { return std::sqrt(SizeSquared()); }
+		bool IsNearlyZero(float Tolerance = 1e-4f) const
+		{
+			return std::fabs(X) <= Tolerance && std::fabs(Y) <= Tolerance && std::fabs(Z) <= Tolerance;
+		}
+
+		/** Unit vector in the same direction, or zero if this is too short to normalize. */
+		FVec3 GetSafeNormal() const
+		{
+			const float SquareSum = SizeSquared();
+			return SquareSum > 1e-8f ? *this * (1.0f / std::sqrt(SquareSum)) : FVec3();
+		}
+	};
+
+	inline float Dot(const FVec3& A, const FVec3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+
+	inline FVec3 Cross(const FVec3& A, const FVec3& B)
+	{
+		return FVec3(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+	}
+
+	inline float Distance(const FVec3& A, const FVec3& B) { return (B - A).Size(); }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+#include "FrequenSeePathTracer.h"
+
+namespace FrequenSeeCore
+{
+	class FTriangleMeshScene;
+
+	/**
+	 * A plane specular reflections happen on, Dot(Normal, X) == Distance. Images only depend on the plane; which part of
+	 * it actually reflects is up to the scene, which the paths are traced against, so a reflector can stand for any
+	 * number of coplanar faces. Vertices only serve to prune reflector sequences no path can take.
+	 */
+	struct FReflector
+	{
+		FVec3 Normal;
+		float Distance = 0.0f;
+		/** One-sided reflectors only reflect on the side Normal points to. */
+		bool bTwoSided = true;
+		std::vector<FVec3> Vertices;
+
+		bool operator==(const FReflector& Other) const;
+	};
+
+	/**
+	 * One reflector per plane of Scene's triangles (two-sided, like the scene), with coplanar triangles merged, so a
+	 * wall made of many triangles mirrors the source once.
+	 */
+	FREQUENSEECORE_API void AppendTriangleReflectors(const FTriangleMeshScene& Scene, std::vector<FReflector>& OutReflectors);
+
+	struct FImageSourceSettings
+	{
+		/** Highest reflection order, 0 to disable. The image tree grows with the number of reflectors to this power. */
+		int32_t MaxOrder = 2;
+		/** No more images than this are generated, bounding the cost in scenes with many reflectors. */
+		int32_t MaxImages = 20000;
+		/** How far the source or listener may move, in scene units, before the images or paths are recomputed. */
+		float UpdateDistance = 1.0f;
+		/** How far a traced hit may lie from a reflector's plane and still be its reflection point. */
+		float PlaneTolerance = 1.0f;
+	};
+
+	/**
+	 * Image-source method for the early specular reflections: the exact paths up to FImageSourceSettings::MaxOrder
+	 * bounces that the random walks of the path tracer rarely find.
+	 *
+	 * The source is mirrored across the reflectors recursively into a tree of images, pruning reflector sequences that
+	 * cannot be followed geometrically (the next reflector lying entirely behind the last one, or an image on the
+	 * non-reflecting side of a one-sided reflector). Each image is then checked for the listener by tracing its path
+	 * back through the scene, whose BVH or line traces show whether the reflection points really lie on a surface and
+	 * nothing blocks the segments between them.
+	 *
+	 * Updates are incremental: the tree is only rebuilt when the source moves or the reflectors change, and the paths
+	 * only revalidated when either end moves. Other scene changes are not noticed; Invalidate() after them.
+	 */
+	class FREQUENSEECORE_API FImageSourceSolver
+	{
+	public:
+		/** The images are rebuilt on the next Update() unless InReflectors are the ones the solver already has. */
+		void SetReflectors(const std::vector<FReflector>& InReflectors);
+
+		/** Recomputes everything on the next Update(). */
+		void Invalidate();
+
+		/**
+		 * Brings the paths up to date for Source and Listener, returning whether anything was recomputed. The paths'
+		 * gains are exact, not estimates to average over rays; Tracer supplies the units, air absorption and offsets.
+		 */
+		bool Update(const IAcousticScene& Scene, const FTracerSettings& Tracer, const FImageSourceSettings& Settings,
+		            const FVec3& Source, const FVec3& Listener);
+
+		/**
+		 * The specular paths the listener receives, carrying the specular share (1 - scattering) of every reflection.
+		 * EvaluatePath() leaves that share out of the tracer's paths up to FTracerSettings::ImageSourceOrder, for paths
+		 * whose reflections all hit surfaces the scene flags with FSurfaceHit::bImageSourceReflector.
+		 */
+		const std::vector<FPathEnergy>& GetPaths() const { return Paths; }
+
+		int32_t NumReflectors() const { return static_cast<int32_t>(Reflectors.size()); }
+		int32_t NumImages() const { return static_cast<int32_t>(Images.size()); }
+
+	private:
+		struct FImage
+		{
+			FVec3 Position;
+			int32_t Reflector = 0;
+			/** The image this one mirrors, -1 for the source itself. */
+			int32_t Parent = -1;
+			int32_t Order = 0;
+			/** Side of the reflector the reflection happens on, +1 in front and -1 behind. */
+			float Side = 1.0f;
+		};
+
+		void BuildImages(const FVec3& Source, const FImageSourceSettings& Settings);
+		void ValidatePaths(const IAcousticScene& Scene, const FTracerSettings& Tracer, const FImageSourceSettings& Settings,
+		                   const FVec3& Source, const FVec3& Listener);
+
+		std::vector<FReflector> Reflectors;
+		/** For every pair, bit 0 if any vertex of the second reflector lies in front of the first one, bit 1 if behind. */
+		std::vector<uint8_t> VertexSides;
+		std::vector<FImage> Images;
+		std::vector<FPathEnergy> Paths;
+
+		bool bImagesValid = false;
+		bool bPathsValid = false;
+		FVec3 ImagesSource;
+		int32_t ImagesMaxOrder = 0;
+		int32_t ImagesMaxImages = 0;
+		FVec3 PathsListener;
+	};
+}
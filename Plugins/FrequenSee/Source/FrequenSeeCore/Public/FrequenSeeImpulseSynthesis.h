@@ -0,0 +1,25 @@
+#pragma once
+
+#include "FrequenSeeArrivals.h"
+
+namespace FrequenSeeCore
+{
+	/** Shape of a mono impulse response synthesized from a trace. */
+	struct FImpulseResponseLayout
+	{
+		float SampleRate = 48000.0f;
+		float BinSeconds = 0.001f;
+		int32_t NumBins = 0;
+		int32_t NumSamples = 0;
+		/** Arrivals before this delay become individual spikes; the binned envelope starts at the next bin boundary. */
+		float EarlySeconds = 0.0f;
+	};
+
+	/**
+	 * Overwrites Layout.NumSamples of OutSamples with the impulse response of a trace: the early window straight from
+	 * the (finalized) sparse arrivals, one spike per arrival carrying the energy the bin envelope would have spread over
+	 * its bin, then the envelope of BinEnergy (Layout.NumBins bins) interpolated between bins, one-pole smoothed.
+	 */
+	FREQUENSEECORE_API void SynthesizeImpulseResponse(const FArrivalList& Arrivals, const float* BinEnergy,
+	                                                  const FImpulseResponseLayout& Layout, float* OutSamples);
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <vector>
+
+#include "FrequenSeeAcousticScene.h"
+#include "FrequenSeeRandom.h"
+
+namespace FrequenSeeCore
+{
+	/** How a trace joins the walks from the source to the listener. */
+	enum class EPathEstimator : uint8_t
+	{
+		/** Every forward walk connects, end to end, to a backward walk from the listener. */
+		Bidirectional,
+		/**
+		 * Diffuse rain: forward walks only, every vertex sending a shadow ray to the listener sphere with its Lambertian
+		 * share of the energy. No backward walks to trace and a connection per bounce rather than per walk, so it tends
+		 * to win in open or convex scenes, where the listener is in view of most surfaces.
+		 */
+		DiffuseRain,
+	};
+
+	/** Distances are in scene units; the defaults are the plugin's (Unreal centimetres). */
+	struct FTracerSettings
+	{
+		/** Forward/backward subpath pairs per trace. */
+		int32_t NumRays = 1000;
+		/** Chance for a subpath to take another bounce (Russian roulette). */
+		float ContinueProbability = 0.9f;
+		float MaxRayDistance = 1000000.0f;
+		/** How far hit points are pushed off the surface, and connection rays stop short of their target. */
+		float SurfaceOffset = 0.1f;
+		/** Scene units to the metres the propagation terms work in; the plugin has always divided centimetres by 1000. */
+		float MetersPerUnit = 0.001f;
+		float SpeedOfSound = 343.0f;
+		/** Air absorption per metre. */
+		float AirAbsorption = 0.05f;
+		/** Connections shorter than this are evaluated as if they were this long, bounding their 1/d^2 term. */
+		float MinConnectionDistance = 10.0f;
+		/** Where subpaths draw their directions from. */
+		ESamplePattern SamplePattern = ESamplePattern::Sobol;
+		EPathEstimator Estimator = EPathEstimator::Bidirectional;
+		/**
+		 * Radius of the listener sphere diffuse rain's shadow rays aim at. They stop at its surface, so the listener's
+		 * own body does not block them, and no vertex counts as closer to the listener than this.
+		 */
+		float ListenerRadius = 50.0f;
+		/**
+		 * Reflection orders up to which FImageSourceSolver renders the specular reflections; paths of these orders off
+		 * image-source reflectors only carry the share of their energy that was scattered at least once. 0 when no
+		 * image sources run.
+		 */
+		int32_t ImageSourceOrder = 0;
+	};
+
+	struct FPathVertex
+	{
+		FVec3 Position;
+		/** Zero at the source and listener. */
+		FVec3 Normal;
+		FSurfaceResponse Surface;
+		/** FSurfaceHit::bImageSourceReflector of the surface this vertex lies on. */
+		bool bImageSourceReflector = false;
+		/**
+		 * Probability of the sampling decision that led to this vertex: the density (per steradian) of the direction
+		 * taken from the previous vertex of its subpath, times the chance the walk went on to take it. 1 for the first.
+		 */
+		float Probability = 0.0f;
+	};
+
+	/** A subpath or connected path: a range of FPathBatch::Vertices. */
+	struct FPathRange
+	{
+		int32_t FirstVertex = 0;
+		int32_t NumVertices = 0;
+		/** For connected paths, how many of the vertices come from the forward subpath. */
+		int32_t NumForwardVertices = 0;
+		/** For subpaths, whether the walk left the scene instead of stopping at Russian roulette. */
+		bool bEscaped = false;
+	};
+
+	/**
+	 * All paths of one trace. Every subpath and connected path is a range of one shared vertex array, and Reset() keeps
+	 * the storage, so a batch that is reused from trace to trace stops allocating once it has seen its largest trace.
+	 */
+	struct FPathBatch
+	{
+		std::vector<FPathVertex> Vertices;
+		std::vector<FPathRange> ForwardPaths;
+		std::vector<FPathRange> BackwardPaths;
+		std::vector<FPathRange> ConnectedPaths;
+		/** ConnectSubpaths() calls since Reset(), for profiling; the successful ones are ConnectedPaths. */
+		int32_t NumConnectionAttempts = 0;
+		/** Shadow rays of the last diffuse rain, kept only so their storage is reused. */
+		std::vector<FVec3> ShadowFrom;
+		std::vector<FVec3> ShadowTo;
+		std::vector<uint8_t> ShadowVisible;
+
+		void Reset()
+		{
+			Vertices.clear();
+			ForwardPaths.clear();
+			BackwardPaths.clear();
+			ConnectedPaths.clear();
+			NumConnectionAttempts = 0;
+		}
+
+		const FPathVertex* GetVertices(const FPathRange& Path) const { return Vertices.data() + Path.FirstVertex; }
+	};
+
+	/** Energy one path carries to the listener. */
+	struct FPathEnergy
+	{
+		float DelaySeconds = 0.0f;
+		/**
+		 * Broadband energy relative to the free field 1 m from the source, so a direct path d m long has 1 / d^2. The
+		 * path's estimate of it, that is: averaged over a trace's ray pairs, the gains of its connected paths add up
+		 * to the listener's energy response.
+		 */
+		float Gain = 0.0f;
+		/** Number of surface reflections along the path, 0 for the direct path. */
+		int32_t ReflectionOrder = 0;
+		/** Product of the per-band reflectances along the path over the broadband one in Gain; Gain * this is the band's energy. */
+		float BandReflectance[BandCount] = { 1.0f, 1.0f, 1.0f };
+		/** Unit vector from the listener towards the path's last bounce (or the source). */
+		FVec3 Direction;
+		/** Length in scene units. */
+		float TotalLength = 0.0f;
+		/**
+		 * Whether the path is an exact specular arrival (an image source) rather than one ray's Monte Carlo sample of
+		 * the scattered energy, which only means something averaged with the rest of its trace.
+		 */
+		bool bDeterministic = false;
+	};
+
+	/**
+	 * Appends the vertices of one random walk starting at Start, the walk's first vertex, to OutVertices: uniform over
+	 * the sphere from Start, cosine-weighted off every surface hit, with Russian roulette before every bounce. Returns
+	 * false if the walk escaped the scene, which leaves it without energy to connect.
+	 */
+	FREQUENSEECORE_API bool GenerateSubpath(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Start,
+	                                        EPathOrigin PathOrigin, FPathSampler& Sampler, std::vector<FPathVertex>& OutVertices);
+
+	/**
+	 * Appends the path joining two of Batch's subpaths, source to listener, to its connected paths if neither escaped
+	 * and their ends see each other.
+	 */
+	FREQUENSEECORE_API bool ConnectSubpaths(const IAcousticScene& Scene, const FTracerSettings& Settings, FPathBatch& Batch,
+	                                        int32_t ForwardPath, int32_t BackwardPath);
+
+	/**
+	 * Traces rays FirstRay to FirstRay + NumRays - 1 of the trace Seed picks between Source and Listener into OutPaths
+	 * with Settings.Estimator: subpath pairs, each connected end to end, or forward subpaths with every vertex connected
+	 * to the listener, their shadow rays queried as one batch. Every ray samples from its own streams, so tracing a
+	 * trace's rays in chunks, on any number of threads, and appending the chunks in order gives the same paths as
+	 * tracing them in one go.
+	 */
+	FREQUENSEECORE_API void TraceRays(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Source,
+	                                  const FVec3& Listener, uint64_t Seed, int32_t FirstRay, int32_t NumRays, FPathBatch& OutPaths);
+
+	/** Traces all Settings.NumRays rays of the trace Seed picks into OutPaths. */
+	FREQUENSEECORE_API void TracePaths(const IAcousticScene& Scene, const FTracerSettings& Settings, const FVec3& Source,
+	                                   const FVec3& Listener, uint64_t Seed, FPathBatch& OutPaths);
+
+	/** Appends the paths of Paths to OutPaths, e.g. to join the chunks of a trace split across threads. */
+	FREQUENSEECORE_API void AppendPaths(const FPathBatch& Paths, FPathBatch& OutPaths);
+
+	/**
+	 * Energy arriving along NumVertices vertices, source first, the first NumForwardVertices of them a forward subpath
+	 * and the rest a reversed backward one. Each sampled segment weighs its BSDF and cosine by its direction's
+	 * density and the connection adds the geometry term between the subpaths' ends. For bidirectional traces the
+	 * result is divided by the chance of both walks stopping where they did and by the number of subpath splits a path
+	 * of this length can come from; diffuse rain connects every vertex and needs neither. Either way the sum over a
+	 * trace's connected paths is an unbiased estimate of the energy response. Up to Settings.ImageSourceOrder
+	 * reflections, all off image-source reflectors, the share the image sources render specularly is left out.
+	 */
+	FREQUENSEECORE_API FPathEnergy EvaluatePath(const FTracerSettings& Settings, const FPathVertex* Vertices, int32_t NumVertices,
+	                                            int32_t NumForwardVertices);
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "FrequenSeeSampling.h"
+
+namespace FrequenSeeCore
+{
+	/**
+	 * Small seedable generator (PCG32) for the tracer's sampling decisions. Unlike the engine's global FMath::FRand
+	 * it is owned by the caller, so a trace with a fixed seed is reproducible run to run and across platforms.
+	 * Generators with the same seed but different streams are independent, which is how every path of a trace gets
+	 * its own without any of them depending on the order the others are traced in.
+	 */
+	class FRandom
+	{
+	public:
+		explicit FRandom(uint64_t Seed = 0x853c49e6748fea9bull, uint64_t Stream = DefaultStream)
+			: Increment((Stream << 1u) | 1u)
+		{
+			State = 0;
+			NextUInt();
+			State += Seed;
+			NextUInt();
+		}
+
+		uint32_t NextUInt()
+		{
+			const uint64_t OldState = State;
+			State = OldState * 6364136223846793005ull + Increment;
+			const uint32_t XorShifted = static_cast<uint32_t>(((OldState >> 18u) ^ OldState) >> 27u);
+			const uint32_t Rotation = static_cast<uint32_t>(OldState >> 59u);
+			return (XorShifted >> Rotation) | (XorShifted << ((0u - Rotation) & 31u));
+		}
+
+		uint64_t NextUInt64() { return static_cast<uint64_t>(NextUInt()) << 32u | NextUInt(); }
+
+		/** Uniform in [0, 1). */
+		float NextFloat() { return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f); }
+
+		/** Uniformly distributed over the unit sphere. */
+		FVec3 UnitVector()
+		{
+			const float U = NextFloat();
+			return UniformSphereDirection(U, NextFloat());
+		}
+
+		/** Uniformly distributed over the hemisphere around the unit vector Normal. */
+		FVec3 HemisphereVector(const FVec3& Normal)
+		{
+			const float U = NextFloat();
+			return UniformHemisphereDirection(Normal, U, NextFloat());
+		}
+
+	private:
+		/** PCG's reference stream, the one every generator used before streams could be picked. */
+		static constexpr uint64_t DefaultStream = 1442695040888963407ull >> 1u;
+
+		uint64_t State;
+		uint64_t Increment;
+	};
+
+	/** Where the tracer's direction samples come from. */
+	enum class ESamplePattern : uint8_t
+	{
+		/** Independent uniforms from each path's FRandom stream. */
+		Random,
+		/**
+		 * Owen-scrambled Sobol points: the paths of a trace stratify every bounce's directions between them, so the
+		 * same number of rays covers the sphere more evenly and the estimate converges faster.
+		 */
+		Sobol,
+	};
+
+	/** Mixes Value into a well-distributed 32-bit hash, for scramble seeds (the 64-bit finalizer of MurmurHash3). */
+	inline uint32_t HashSeed(uint64_t Value)
+	{
+		Value ^= Value >> 33u;
+		Value *= 0xff51afd7ed558ccdull;
+		Value ^= Value >> 33u;
+		Value *= 0xc4ceb9fe1a85ec53ull;
+		Value ^= Value >> 33u;
+		return static_cast<uint32_t>(Value);
+	}
+
+	/**
+	 * Sampling decisions of one subpath of a trace. Russian roulette always draws from the path's own PCG stream;
+	 * directions come from the stream too, or from point PathIndex of an Owen-scrambled Sobol sequence with one
+	 * dimension pair per bounce (Burley, "Practical Hash-based Owen Scrambling", 2020). Either way the samples only
+	 * depend on the seed, the path's index and its sequence, so a trace can be split across threads in any way
+	 * and still come out identical.
+	 */
+	class FPathSampler
+	{
+	public:
+		/** Sequence tells apart the subpaths sharing a path index, e.g. 0 for the forward and 1 for the backward one. */
+		FPathSampler(ESamplePattern InPattern, uint64_t Seed, uint32_t InPathIndex, uint32_t Sequence)
+			: Random(Seed, static_cast<uint64_t>(InPathIndex) << 1u | (Sequence & 1u))
+			, Pattern(InPattern)
+			, PathIndex(InPathIndex)
+			, ScrambleSeed(HashSeed(Seed ^ (static_cast<uint64_t>(Sequence) << 32u)))
+		{
+		}
+
+		/** Uniform in [0, 1), for decisions other than directions. */
+		float NextFloat() { return Random.NextFloat(); }
+
+		/** The next pair of uniforms in [0, 1) for a direction; each call moves on to the next dimension pair. */
+		void Next2D(float& OutU, float& OutV)
+		{
+			if (Pattern == ESamplePattern::Random)
+			{
+				OutU = Random.NextFloat();
+				OutV = Random.NextFloat();
+				return;
+			}
+
+			// Shuffling the index per dimension pair decorrelates the bounces, scrambling each dimension randomizes it
+			const uint32_t PairSeed = HashSeed(static_cast<uint64_t>(ScrambleSeed) << 32u | Dimension++);
+			const uint32_t Index = NestedUniformScramble(PathIndex, PairSeed);
+			OutU = ToFloat(NestedUniformScramble(ReverseBits(Index), HashSeed(PairSeed ^ 0x9e3779b97f4a7c15ull)));
+			OutV = ToFloat(NestedUniformScramble(SobolSecondDimension(Index), HashSeed(PairSeed ^ 0x6a09e667f3bcc909ull)));
+		}
+
+		/** Uniformly distributed over the unit sphere. */
+		FVec3 UnitVector()
+		{
+			float U, V;
+			Next2D(U, V);
+			return UniformSphereDirection(U, V);
+		}
+
+		/** Cosine-weighted over the hemisphere around the unit vector Normal. */
+		FVec3 CosineHemisphereVector(const FVec3& Normal)
+		{
+			float U, V;
+			Next2D(U, V);
+			return CosineHemisphereDirection(Normal, U, V);
+		}
+
+	private:
+		static uint32_t ReverseBits(uint32_t Value)
+		{
+			Value = (Value << 16u) | (Value >> 16u);
+			Value = ((Value & 0x00ff00ffu) << 8u) | ((Value & 0xff00ff00u) >> 8u);
+			Value = ((Value & 0x0f0f0f0fu) << 4u) | ((Value & 0xf0f0f0f0u) >> 4u);
+			Value = ((Value & 0x33333333u) << 2u) | ((Value & 0xccccccccu) >> 2u);
+			Value = ((Value & 0x55555555u) << 1u) | ((Value & 0xaaaaaaaau) >> 1u);
+			return Value;
+		}
+
+		/** Sobol's second dimension as a 32-bit fraction, as ReverseBits(Index) is the first. */
+		static uint32_t SobolSecondDimension(uint32_t Index)
+		{
+			uint32_t Result = 0;
+			for (uint32_t Direction = 1u << 31u; Index; Index >>= 1u, Direction ^= Direction >> 1u)
+			{
+				if (Index & 1u)
+				{
+					Result ^= Direction;
+				}
+			}
+			return Result;
+		}
+
+		/** Owen scrambling in base 2: every bit is flipped depending on the bits above it. */
+		static uint32_t NestedUniformScramble(uint32_t Value, uint32_t Seed)
+		{
+			Value = ReverseBits(Value);
+			Value ^= Value * 0x3d20adeau;
+			Value += Seed;
+			Value *= (Seed >> 16u) | 1u;
+			Value ^= Value * 0x05526c56u;
+			Value ^= Value * 0x53a22864u;
+			return ReverseBits(Value);
+		}
+
+		static float ToFloat(uint32_t Value) { return static_cast<float>(Value >> 8) * (1.0f / 16777216.0f); }
+
+		FRandom Random;
+		ESamplePattern Pattern;
+		uint32_t PathIndex;
+		uint32_t ScrambleSeed;
+		uint32_t Dimension = 0;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "FrequenSeeCoreTypes.h"
+
+/**
+ * Direction samplers of the tracer and their densities. Each maps a pair of uniforms in [0, 1) to a unit vector
+ * analytically, without rejection, so it works with stratified sequences as well as with independent samples, and
+ * every Pdf function is the exact density (per steradian) of its sampler.
+ */
+namespace FrequenSeeCore
+{
+	/** Tangent and bitangent completing the unit vector Normal to an orthonormal frame. */
+	inline void MakeOrthonormalBasis(const FVec3& Normal, FVec3& OutTangent, FVec3& OutBitangent)
+	{
+		const FVec3 Helper = std::fabs(Normal.X) < 0.9f ? FVec3(1.0f, 0.0f, 0.0f) : FVec3(0.0f, 1.0f, 0.0f);
+		OutTangent = Cross(Helper, Normal).GetSafeNormal();
+		OutBitangent = Cross(Normal, OutTangent);
+	}
+
+	/** Uniformly distributed over the unit sphere. */
+	inline FVec3 UniformSphereDirection(float U, float V)
+	{
+		const float CosTheta = 1.0f - 2.0f * U;
+		const float SinTheta = std::sqrt(std::fmax(0.0f, 1.0f - CosTheta * CosTheta));
+		const float Phi = 2.0f * Pi * V;
+		return FVec3(SinTheta * std::cos(Phi), SinTheta * std::sin(Phi), CosTheta);
+	}
+
+	inline float UniformSpherePdf() { return 1.0f / (4.0f * Pi); }
+
+	/** Uniformly distributed over the hemisphere around the unit vector Normal. */
+	inline FVec3 UniformHemisphereDirection(const FVec3& Normal, float U, float V)
+	{
+		const float CosTheta = U;
+		const float SinTheta = std::sqrt(std::fmax(0.0f, 1.0f - CosTheta * CosTheta));
+		const float Phi = 2.0f * Pi * V;
+		FVec3 Tangent, Bitangent;
+		MakeOrthonormalBasis(Normal, Tangent, Bitangent);
+		return Tangent * (SinTheta * std::cos(Phi)) + Bitangent * (SinTheta * std::sin(Phi)) + Normal * CosTheta;
+	}
+
+	inline float UniformHemispherePdf() { return 1.0f / (2.0f * Pi); }
+
+	/**
+	 * Cosine-weighted over the hemisphere around the unit vector Normal, the distribution a Lambertian surface
+	 * reflects into: a point of the unit disk (Shirley's concentric mapping, which keeps the uniforms' stratification)
+	 * lifted onto the hemisphere.
+	 */
+	inline FVec3 CosineHemisphereDirection(const FVec3& Normal, float U, float V)
+	{
+		const float X = 2.0f * U - 1.0f;
+		const float Y = 2.0f * V - 1.0f;
+		float Radius = 0.0f;
+		float Phi = 0.0f;
+		if (X != 0.0f || Y != 0.0f)
+		{
+			if (std::fabs(X) > std::fabs(Y))
+			{
+				Radius = X;
+				Phi = (Pi / 4.0f) * (Y / X);
+			}
+			else
+			{
+				Radius = Y;
+				Phi = (Pi / 2.0f) - (Pi / 4.0f) * (X / Y);
+			}
+		}
+		const float CosTheta = std::sqrt(std::fmax(0.0f, 1.0f - Radius * Radius));
+		FVec3 Tangent, Bitangent;
+		MakeOrthonormalBasis(Normal, Tangent, Bitangent);
+		return Tangent * (Radius * std::cos(Phi)) + Bitangent * (Radius * std::sin(Phi)) + Normal * CosTheta;
+	}
+
+	/** Density of CosineHemisphereDirection for a direction at CosTheta to the normal. */
+	inline float CosineHemispherePdf(float CosTheta) { return std::fmax(CosTheta, 0.0f) / Pi; }
+}
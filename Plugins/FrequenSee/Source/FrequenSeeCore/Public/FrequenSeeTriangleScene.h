@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "FrequenSeeAcousticScene.h"
+
+namespace FrequenSeeCore
+{
+	/**
+	 * Static triangle soup behind a bounding volume hierarchy, the scene the headless tools trace against. Triangles are
+	 * two-sided: hits report the face normal turned towards the ray. Source and listener have no body here, so
+	 * Trace() ignores the path origin.
+	 */
+	class FREQUENSEECORE_API FTriangleMeshScene : public IAcousticScene
+	{
+	public:
+		/** Registers a surface response and returns the index AddTriangle() takes. */
+		int32_t AddMaterial(const FSurfaceResponse& Surface);
+		const FSurfaceResponse& GetMaterial(int32_t Material) const { return Materials[Material]; }
+
+		/** Material -1 reflects like a surface without an acoustic material. */
+		void AddTriangle(const FVec3& A, const FVec3& B, const FVec3& C, int32_t Material = -1);
+
+		/** Builds the hierarchy. Call after the last AddTriangle() and before tracing. */
+		void Build();
+
+		int32_t NumTriangles() const { return static_cast<int32_t>(Triangles.size()); }
+		/** Corners of a triangle, in the order the hierarchy keeps them (not necessarily the order they were added). */
+		void GetTriangle(int32_t Triangle, FVec3& OutA, FVec3& OutB, FVec3& OutC) const;
+
+		virtual bool Trace(const FVec3& Origin, const FVec3& Direction, float MaxDistance, EPathOrigin PathOrigin,
+		                   FSurfaceHit& OutHit) const override;
+		virtual bool IsVisible(const FVec3& From, const FVec3& To) const override;
+
+	private:
+		struct FTriangle
+		{
+			FVec3 Vertex0;
+			FVec3 Edge1;
+			FVec3 Edge2;
+			FVec3 Normal;
+			FVec3 Centroid;
+			int32_t Material = -1;
+		};
+
+		struct FNode
+		{
+			FVec3 BoundsMin;
+			FVec3 BoundsMax;
+			/** Leaves: the first of NumTriangles triangles. Inner nodes: the second child, the first follows the node. */
+			int32_t Index = 0;
+			int32_t NumTriangles = 0;
+		};
+
+		int32_t BuildNode(int32_t First, int32_t Count);
+
+		/** Closest (or, with bAnyHit, any) intersection within MaxDistance; the triangle goes to OutTriangle. */
+		bool Intersect(const FVec3& Origin, const FVec3& Direction, float MaxDistance, bool bAnyHit, float& OutDistance,
+		               int32_t& OutTriangle) const;
+
+		std::vector<FTriangle> Triangles;
+		std::vector<FSurfaceResponse> Materials;
+		std::vector<FNode> Nodes;
+	};
+}
@@ -0,0 +1,17 @@
+using System.IO;
+using UnrealBuildTool;
+
+public class FrequenSeeDSP : ModuleRules
+{
+	public FrequenSeeDSP(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] {
+			"Core",
+		});
+
+		// KissFFT is an implementation detail; other modules go through FFrequenSeeRealFFT.
+		PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "ThirdParty", "KissFFT"));
+	}
+}
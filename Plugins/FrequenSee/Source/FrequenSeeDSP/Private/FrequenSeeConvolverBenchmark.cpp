@@ -0,0 +1,58 @@
+#include "FrequenSeePartitionedConvolver.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	/**
+	 * FrequenSee.Bench.Convolver [BlockSize=256] [IRLength=48000] [NumChannels=2] [NumFrames=96000]
+	 * Reports the steady-state cost per 1024-frame callback of streaming noise through the convolver. Correctness
+	 * against direct convolution is the FrequenSee.DSP.PartitionedConvolver automation test.
+	 */
+	void RunConvolverBenchmark(const TArray<FString>& Args)
+	{
+		const int32 BlockSize = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 256;
+		const int32 IRLength = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 48000;
+		const int32 NumChannels = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 2;
+		const int32 CallbackFrames = 1024;
+		const int32 NumFrames = Args.Num() > 3 ? FMath::Max(CallbackFrames, FCString::Atoi(*Args[3])) : 96000;
+
+		FRandomStream Random(1234);
+		TArray<float> IR;
+		IR.SetNumUninitialized(IRLength);
+		for (int32 i = 0; i < IRLength; ++i)
+		{
+			IR[i] = Random.FRandRange(-1.0f, 1.0f) * FMath::Exp(-6.9f * i / IRLength);
+		}
+
+		TArray<float> Buffer;
+		Buffer.SetNumUninitialized(NumFrames * NumChannels);
+		for (float& Sample : Buffer)
+		{
+			Sample = Random.FRandRange(-1.0f, 1.0f);
+		}
+
+		FFrequenSeePartitionedConvolver Convolver;
+		Convolver.Init(BlockSize, IRLength, NumChannels);
+		Convolver.SetImpulseResponse(IR.GetData(), IRLength);
+
+		const int32 Iterations = NumFrames / CallbackFrames;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			float* Data = Buffer.GetData() + Iteration * CallbackFrames * NumChannels;
+			Convolver.Process(Data, Data, CallbackFrames);
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+
+		UE_LOG(LogTemp, Display, TEXT("Convolver: block %d, IR %d samples (%d partitions), %d channel(s), latency %d frames"),
+		       BlockSize, IRLength, Convolver.GetNumPartitions(), NumChannels, Convolver.GetLatency());
+		UE_LOG(LogTemp, Display, TEXT("  %.3f ms per %d-frame callback (%s kernel)"),
+		       Seconds * 1000.0 / Iterations, CallbackFrames, FrequenSeeSpectrum::GetKernelName());
+	}
+
+	FAutoConsoleCommand ConvolverBenchmarkCommand(
+		TEXT("FrequenSee.Bench.Convolver"),
+		TEXT("Times the partitioned convolver per 1024-frame callback. Args: [BlockSize] [IRLength] [NumChannels] [NumFrames]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunConvolverBenchmark));
+}
@@ -0,0 +1,123 @@
+#include "FrequenSeePartitionedConvolver.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Worst error against the largest reference sample tolerated; float FFTs land around 1e-6. */
+	constexpr double MaxRelativeError = 1e-4;
+
+	/**
+	 * Streams noise through a convolver of NumChannels channels in host callbacks that do not divide BlockSize, swaps
+	 * to a shorter IR half way through, partitioned up front when bPrepared, and compares every frame outside the
+	 * crossfade block with direct convolution, delayed by the convolver's latency. Returns the worst error relative to
+	 * the largest reference sample.
+	 */
+	double MeasureConvolverError(int32 NumChannels, bool bPrepared, int32& OutNumChecked)
+	{
+		const int32 BlockSize = 64;
+		const int32 IRLengths[2] = { 1000, 611 };
+		const int32 NumFrames = 6000;
+
+		FRandomStream Random(1234 + NumChannels);
+		TArray<float> IRs[2];
+		for (int32 Index = 0; Index < 2; ++Index)
+		{
+			IRs[Index].SetNumUninitialized(IRLengths[Index]);
+			for (int32 i = 0; i < IRLengths[Index]; ++i)
+			{
+				IRs[Index][i] = Random.FRandRange(-1.0f, 1.0f) * FMath::Exp(-6.9f * i / IRLengths[Index]);
+			}
+		}
+
+		TArray<float> Input, Output;
+		Input.SetNumUninitialized(NumFrames * NumChannels);
+		for (float& Sample : Input)
+		{
+			Sample = Random.FRandRange(-1.0f, 1.0f);
+		}
+		Output = Input;
+
+		FFrequenSeePartitionedConvolver Convolver;
+		Convolver.Init(BlockSize, IRLengths[0], NumChannels);
+		Convolver.SetImpulseResponse(IRs[0].GetData(), IRLengths[0]);
+		FFrequenSeePreparedImpulseResponsePtr Prepared = FFrequenSeePartitionedConvolver::PrepareImpulseResponse(BlockSize, IRs[1].GetData(), IRLengths[1]);
+
+		// Host callbacks of varying size, processed in place; the IR switches at SwapFrame
+		const int32 HostBlockSizes[] = { 100, 17, 480, 1, 333, 5, 97 };
+		int32 SwapFrame = -1;
+		for (int32 Frame = 0, Call = 0; Frame < NumFrames; ++Call)
+		{
+			if (SwapFrame < 0 && Frame >= NumFrames / 2)
+			{
+				if (bPrepared)
+				{
+					Convolver.SetImpulseResponse(Prepared);
+				}
+				else
+				{
+					Convolver.SetImpulseResponse(IRs[1].GetData(), IRLengths[1]);
+				}
+				SwapFrame = Frame;
+			}
+			const int32 Count = FMath::Min(HostBlockSizes[Call % UE_ARRAY_COUNT(HostBlockSizes)], NumFrames - Frame);
+			float* Data = Output.GetData() + Frame * NumChannels;
+			Convolver.Process(Data, Data, Count);
+			Frame += Count;
+		}
+
+		// The block being staged when the IR switched is the one rendered with the crossfade
+		const int32 Latency = Convolver.GetLatency();
+		const int32 CrossfadeStart = (SwapFrame / BlockSize) * BlockSize + Latency;
+		double MaxError = 0.0;
+		double MaxReference = 0.0;
+		OutNumChecked = 0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const bool bBeforeSwap = Frame < CrossfadeStart;
+			const bool bAfterSwap = Frame >= CrossfadeStart + BlockSize;
+			if (!bBeforeSwap && !bAfterSwap)
+			{
+				continue;
+			}
+			const TArray<float>& IR = IRs[bAfterSwap ? 1 : 0];
+			const int32 InputFrame = Frame - Latency;
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				double Reference = 0.0;
+				for (int32 Tap = 0; Tap < IR.Num() && Tap <= InputFrame; ++Tap)
+				{
+					Reference += IR[Tap] * Input[(InputFrame - Tap) * NumChannels + Channel];
+				}
+				MaxError = FMath::Max(MaxError, FMath::Abs(Reference - Output[Frame * NumChannels + Channel]));
+				MaxReference = FMath::Max(MaxReference, FMath::Abs(Reference));
+			}
+			++OutNumChecked;
+		}
+		return MaxError / FMath::Max(MaxReference, 1e-9);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrequenSeePartitionedConvolverTest, "FrequenSee.DSP.PartitionedConvolver",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFrequenSeePartitionedConvolverTest::RunTest(const FString& Parameters)
+{
+	for (const int32 NumChannels : { 1, 2, 5 })
+	{
+		for (const bool bPrepared : { false, true })
+		{
+			const TCHAR* SwapKind = bPrepared ? TEXT("prepared") : TEXT("direct");
+			int32 NumChecked = 0;
+			const double Error = MeasureConvolverError(NumChannels, bPrepared, NumChecked);
+			TestTrue(FString::Printf(TEXT("%d channel(s), %s swap: frames checked against direct convolution"), NumChannels, SwapKind), NumChecked > 0);
+			TestTrue(FString::Printf(TEXT("%d channel(s), %s swap: relative error %g within %g"), NumChannels, SwapKind, Error, MaxRelativeError),
+			         Error <= MaxRelativeError);
+		}
+	}
+	return true;
+}
+
+#endif
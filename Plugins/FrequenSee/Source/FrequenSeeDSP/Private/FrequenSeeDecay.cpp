@@ -0,0 +1,90 @@
+#include "FrequenSeeDecay.h"
+
+void FrequenSeeDecay::SchroederIntegrate(const float* Energy, int32 NumBins, float* OutDecayDb)
+{
+	double Remaining = 0.0;
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		Remaining += FMath::Max(Energy[Bin], 0.0f);
+	}
+
+	const double Total = Remaining;
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		// Clamp the tail to -200 dB so an exhausted histogram doesn't produce -inf
+		OutDecayDb[Bin] = Total > 0.0 ? float(10.0 * FMath::LogX(10.0, FMath::Max(Remaining / Total, 1e-20))) : 0.0f;
+		Remaining -= FMath::Max(Energy[Bin], 0.0f);
+	}
+}
+
+float FrequenSeeDecay::EstimateT60(const float* Energy, int32 NumBins, float BinSeconds)
+{
+	constexpr int32 MinFitBins = 3;
+	if (NumBins < MinFitBins)
+	{
+		return 0.0f;
+	}
+
+	TArray<float, TInlineAllocator<1024>> DecayDb;
+	DecayDb.SetNumUninitialized(NumBins);
+	SchroederIntegrate(Energy, NumBins, DecayDb.GetData());
+
+	auto Fit = [&DecayDb, NumBins, BinSeconds](float UpperDb, float LowerDb) -> float
+	{
+		double SumT = 0.0, SumD = 0.0, SumTT = 0.0, SumTD = 0.0;
+		int32 Count = 0;
+		bool bReachedLower = false;
+		for (int32 Bin = 0; Bin < NumBins; ++Bin)
+		{
+			const float Db = DecayDb[Bin];
+			if (Db < LowerDb)
+			{
+				bReachedLower = true;
+				break;
+			}
+			if (Db <= UpperDb)
+			{
+				const double T = (Bin + 0.5) * BinSeconds;
+				SumT += T;
+				SumD += Db;
+				SumTT += T * T;
+				SumTD += T * Db;
+				++Count;
+			}
+		}
+		if (!bReachedLower || Count < MinFitBins)
+		{
+			return 0.0f;
+		}
+
+		const double Denominator = Count * SumTT - SumT * SumT;
+		const double SlopeDbPerSecond = Denominator > 0.0 ? (Count * SumTD - SumT * SumD) / Denominator : 0.0;
+		return SlopeDbPerSecond < 0.0 ? float(-60.0 / SlopeDbPerSecond) : 0.0f;
+	};
+
+	const float T20 = Fit(-5.0f, -25.0f);
+	return T20 > 0.0f ? T20 : Fit(-5.0f, -15.0f);
+}
+
+void FrequenSeeDecay::DecayProfile(const float* Energy, int32 NumBins, float* OutProfileDb, int32 NumPoints)
+{
+	TArray<float, TInlineAllocator<1024>> DecayDb;
+	DecayDb.SetNumUninitialized(NumBins);
+	SchroederIntegrate(Energy, NumBins, DecayDb.GetData());
+
+	for (int32 Point = 0; Point < NumPoints; ++Point)
+	{
+		const int32 Bin = NumPoints > 1 ? (Point * (NumBins - 1)) / (NumPoints - 1) : 0;
+		OutProfileDb[Point] = NumBins > 0 ? FMath::Max(DecayDb[Bin], -60.0f) : 0.0f;
+	}
+}
+
+float FrequenSeeDecay::ProfileDistanceDb(const float* ProfileA, const float* ProfileB, int32 NumPoints)
+{
+	float SumSquares = 0.0f;
+	for (int32 Point = 0; Point < NumPoints; ++Point)
+	{
+		SumSquares += FMath::Square(ProfileA[Point] - ProfileB[Point]);
+	}
+	return NumPoints > 0 ? FMath::Sqrt(SumSquares / NumPoints) : 0.0f;
+}
@@ -0,0 +1,189 @@
+#include "FrequenSeeFDNReverb.h"
+
+namespace
+{
+	/** Mutually detuned line lengths, roughly a small room's mean free path spread over 30-75 ms. */
+	constexpr float LineDelaysMs[FFrequenSeeFDNReverb::NumLines] = { 29.7f, 37.1f, 41.1f, 43.7f, 53.3f, 59.9f, 67.9f, 73.1f };
+
+	/** Input and output signs; the output sets are orthogonal so left and right decorrelate. */
+	constexpr float InputSigns[FFrequenSeeFDNReverb::NumLines] = { 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f };
+	constexpr float OutputSigns[FFrequenSeeFDNReverb::NumOutputs][FFrequenSeeFDNReverb::NumLines] = {
+		{ 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f },
+		{ 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f },
+	};
+
+	/** Per-pass gain of a line of DelayFrames frames for a 60 dB decay in T60 seconds. */
+	float LoopGain(int32 DelayFrames, float T60, float SampleRate)
+	{
+		return FMath::Pow(10.0f, -3.0f * DelayFrames / (T60 * SampleRate));
+	}
+
+	/** |b0 + b1 z^-1| / |1 - p z^-1| at angular frequency Omega. */
+	float ShelfMagnitude(float B0, float B1, float Pole, float CosOmega)
+	{
+		const float Numerator = B0 * B0 + B1 * B1 + 2.0f * B0 * B1 * CosOmega;
+		const float Denominator = 1.0f + Pole * Pole - 2.0f * Pole * CosOmega;
+		return FMath::Sqrt(Numerator / Denominator);
+	}
+}
+
+void FFrequenSeeFDNReverb::Init(float InSampleRate)
+{
+	check(InSampleRate > 0.0f);
+	SampleRate = InSampleRate;
+
+	int32 MaxDelay = 0;
+	for (int32 Line = 0; Line < NumLines; ++Line)
+	{
+		Delays[Line] = FMath::Max(1, FMath::RoundToInt32(LineDelaysMs[Line] * 0.001f * SampleRate));
+		MaxDelay = FMath::Max(MaxDelay, Delays[Line]);
+	}
+	LineSize = FMath::RoundUpToPowerOfTwo(MaxDelay + 1);
+	Lines.SetNumZeroed(NumLines * LineSize);
+
+	SetDecay(1.0f, 1.0f, 1.0f, 1000.0f);
+	SetLevel(0.0f);
+	Reset();
+}
+
+void FFrequenSeeFDNReverb::Reset()
+{
+	FMemory::Memzero(Lines.GetData(), sizeof(float) * Lines.Num());
+	FMemory::Memzero(ShelfInput, sizeof(ShelfInput));
+	FMemory::Memzero(ShelfOutput, sizeof(ShelfOutput));
+	WritePosition = 0;
+}
+
+void FFrequenSeeFDNReverb::SetDecay(float LowT60, float MidT60, float HighT60, float MidFrequencyHz)
+{
+	constexpr float MinT60 = 0.05f;
+	constexpr float MaxT60 = 30.0f;
+	LowT60 = FMath::Clamp(LowT60, MinT60, MaxT60);
+	MidT60 = FMath::Clamp(MidT60, MinT60, MaxT60);
+	HighT60 = FMath::Clamp(HighT60, MinT60, MaxT60);
+	const float CosMid = FMath::Cos(2.0f * PI * FMath::Clamp(MidFrequencyHz, 1.0f, 0.45f * SampleRate) / SampleRate);
+
+	for (int32 Line = 0; Line < NumLines; ++Line)
+	{
+		const float GainLow = LoopGain(Delays[Line], LowT60, SampleRate);
+		const float GainMid = LoopGain(Delays[Line], MidT60, SampleRate);
+		const float GainHigh = LoopGain(Delays[Line], HighT60, SampleRate);
+
+		// The pole moves the shelf transition: -1 leaves GainLow everywhere, +1 GainHigh. Bisect for GainMid.
+		auto MidError = [GainLow, GainHigh, GainMid, CosMid](float Pole, float& OutB0, float& OutB1)
+		{
+			OutB0 = 0.5f * (GainLow * (1.0f - Pole) + GainHigh * (1.0f + Pole));
+			OutB1 = 0.5f * (GainLow * (1.0f - Pole) - GainHigh * (1.0f + Pole));
+			return ShelfMagnitude(OutB0, OutB1, Pole, CosMid) - GainMid;
+		};
+
+		float B0, B1;
+		float Lower = -0.999f;
+		float Upper = 0.999f;
+		const float ErrorAtLower = MidError(Lower, B0, B1);
+		for (int32 Iteration = 0; Iteration < 32; ++Iteration)
+		{
+			const float Middle = 0.5f * (Lower + Upper);
+			if ((MidError(Middle, B0, B1) > 0.0f) == (ErrorAtLower > 0.0f))
+			{
+				Lower = Middle;
+			}
+			else
+			{
+				Upper = Middle;
+			}
+		}
+
+		FShelf& Shelf = Shelves[Line];
+		Shelf.Pole = 0.5f * (Lower + Upper);
+		MidError(Shelf.Pole, B0, B1);
+		Shelf.B0 = B0;
+		Shelf.B1 = B1;
+	}
+
+	// Each frequency decays at its own rate, so the impulse energy is integrated over the band rather than taken
+	// from one mean loop gain: per pass a fraction G of the energy at that frequency survives, G / (1 - G) in total
+	constexpr int32 NumEnergyPoints = 64;
+	float EnergySum = 0.0f;
+	for (int32 Point = 0; Point < NumEnergyPoints; ++Point)
+	{
+		const float CosOmega = FMath::Cos(PI * (Point + 0.5f) / NumEnergyPoints);
+		float LoopEnergyGain = 0.0f;
+		for (const FShelf& Shelf : Shelves)
+		{
+			LoopEnergyGain += FMath::Square(ShelfMagnitude(Shelf.B0, Shelf.B1, Shelf.Pole, CosOmega));
+		}
+		LoopEnergyGain = FMath::Min(LoopEnergyGain / NumLines, 0.999999f);
+		EnergySum += LoopEnergyGain / (1.0f - LoopEnergyGain);
+	}
+	UnitImpulseEnergy = EnergySum / NumEnergyPoints;
+	UpdateOutputGain();
+}
+
+void FFrequenSeeFDNReverb::SetLevel(float InImpulseEnergy)
+{
+	ImpulseEnergy = FMath::Max(InImpulseEnergy, 0.0f);
+	UpdateOutputGain();
+}
+
+void FFrequenSeeFDNReverb::UpdateOutputGain()
+{
+	// Each output sums the lines with unit signs, and the lines are uncorrelated, so it carries UnitImpulseEnergy
+	OutputGain = UnitImpulseEnergy > 0.0f ? FMath::Sqrt(ImpulseEnergy / UnitImpulseEnergy) : 0.0f;
+}
+
+void FFrequenSeeFDNReverb::Process(const float* In, float* Out, int32 NumFrames)
+{
+	checkSlow(IsInitialized());
+
+	const float InputScale = 1.0f / FMath::Sqrt(float(NumLines));
+	const float MixScale = InputScale;
+	const int32 Mask = LineSize - 1;
+	float* LineData = Lines.GetData();
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		float Filtered[NumLines];
+		for (int32 Line = 0; Line < NumLines; ++Line)
+		{
+			const float Delayed = LineData[Line * LineSize + ((WritePosition - Delays[Line]) & Mask)];
+			const FShelf& Shelf = Shelves[Line];
+			const float Y = Shelf.B0 * Delayed + Shelf.B1 * ShelfInput[Line] + Shelf.Pole * ShelfOutput[Line];
+			ShelfInput[Line] = Delayed;
+			ShelfOutput[Line] = Y;
+			Filtered[Line] = Y;
+		}
+
+		for (int32 Output = 0; Output < NumOutputs; ++Output)
+		{
+			float Sum = 0.0f;
+			for (int32 Line = 0; Line < NumLines; ++Line)
+			{
+				Sum += OutputSigns[Output][Line] * Filtered[Line];
+			}
+			Out[Frame * NumOutputs + Output] += OutputGain * Sum;
+		}
+
+		// In-place fast Walsh-Hadamard transform, the orthogonal (lossless) feedback mix
+		for (int32 Span = 1; Span < NumLines; Span *= 2)
+		{
+			for (int32 Start = 0; Start < NumLines; Start += 2 * Span)
+			{
+				for (int32 Line = Start; Line < Start + Span; ++Line)
+				{
+					const float A = Filtered[Line];
+					const float B = Filtered[Line + Span];
+					Filtered[Line] = A + B;
+					Filtered[Line + Span] = A - B;
+				}
+			}
+		}
+
+		const float Input = In[Frame] * InputScale;
+		for (int32 Line = 0; Line < NumLines; ++Line)
+		{
+			LineData[Line * LineSize + WritePosition] = MixScale * Filtered[Line] + InputSigns[Line] * Input;
+		}
+		WritePosition = (WritePosition + 1) & Mask;
+	}
+}
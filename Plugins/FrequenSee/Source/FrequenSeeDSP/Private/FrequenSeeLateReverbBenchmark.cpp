@@ -0,0 +1,110 @@
+#include "FrequenSeeDecay.h"
+#include "FrequenSeeFDNReverb.h"
+#include "FrequenSeePartitionedConvolver.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	/**
+	 * FrequenSee.Bench.LateReverb [T60=1.0] [SampleRate=48000]
+	 * Builds an exponentially decaying noise IR with the given T60, fits it back with Schroeder integration, drives
+	 * the FDN fallback with the fit and checks that its impulse response has the IR's decay and energy. Then times
+	 * the FDN against a 1-second convolution per stereo 1024-frame callback, the trade the reverb LOD makes.
+	 */
+	void RunLateReverbBenchmark(const TArray<FString>& Args)
+	{
+		const float T60 = Args.Num() > 0 ? FMath::Clamp(FCString::Atof(*Args[0]), 0.1f, 10.0f) : 1.0f;
+		const float SampleRate = Args.Num() > 1 ? FMath::Max(8000.0f, FCString::Atof(*Args[1])) : 48000.0f;
+		const int32 IRLength = FMath::RoundToInt32(SampleRate);
+		const int32 BinFrames = FMath::RoundToInt32(0.001f * SampleRate);
+		const int32 NumBins = IRLength / BinFrames;
+
+		FRandomStream Random(1234);
+		TArray<float> IR;
+		IR.SetNumUninitialized(IRLength);
+		float IREnergy = 0.0f;
+		for (int32 i = 0; i < IRLength; ++i)
+		{
+			IR[i] = Random.FRandRange(-1.0f, 1.0f) * FMath::Exp(-6.9078f * i / (T60 * SampleRate));
+			IREnergy += IR[i] * IR[i];
+		}
+
+		auto Histogram = [BinFrames, NumBins](const float* Samples, int32 Stride)
+		{
+			TArray<float> Bins;
+			Bins.SetNumZeroed(NumBins);
+			for (int32 i = 0; i < NumBins * BinFrames; ++i)
+			{
+				Bins[i / BinFrames] += Samples[i * Stride] * Samples[i * Stride];
+			}
+			return Bins;
+		};
+		const TArray<float> IRBins = Histogram(IR.GetData(), 1);
+		const float FittedT60 = FrequenSeeDecay::EstimateT60(IRBins.GetData(), NumBins, 0.001f);
+
+		FFrequenSeeFDNReverb Fdn;
+		Fdn.Init(SampleRate);
+		Fdn.SetDecay(FittedT60, FittedT60, FittedT60, 1000.0f);
+		Fdn.SetLevel(IREnergy);
+
+		const int32 NumFrames = 4 * IRLength;
+		TArray<float> Impulse, FdnResponse;
+		Impulse.SetNumZeroed(NumFrames);
+		Impulse[0] = 1.0f;
+		FdnResponse.SetNumZeroed(NumFrames * FFrequenSeeFDNReverb::NumOutputs);
+		Fdn.Process(Impulse.GetData(), FdnResponse.GetData(), NumFrames);
+
+		float FdnEnergy = 0.0f;
+		for (int32 i = 0; i < NumFrames; ++i)
+		{
+			FdnEnergy += FdnResponse[i * FFrequenSeeFDNReverb::NumOutputs] * FdnResponse[i * FFrequenSeeFDNReverb::NumOutputs];
+		}
+		const TArray<float> FdnBins = Histogram(FdnResponse.GetData(), FFrequenSeeFDNReverb::NumOutputs);
+		const float FdnT60 = FrequenSeeDecay::EstimateT60(FdnBins.GetData(), NumBins, 0.001f);
+
+		const int32 CallbackFrames = 1024;
+		const int32 Iterations = 200;
+		TArray<float> Input, Output;
+		Input.SetNumUninitialized(CallbackFrames);
+		for (float& Sample : Input)
+		{
+			Sample = Random.FRandRange(-1.0f, 1.0f);
+		}
+		Output.SetNumZeroed(CallbackFrames * FFrequenSeeFDNReverb::NumOutputs);
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Fdn.Process(Input.GetData(), Output.GetData(), CallbackFrames);
+		}
+		const double FdnSeconds = FPlatformTime::Seconds() - Start;
+
+		FFrequenSeePartitionedConvolver Convolvers[FFrequenSeeFDNReverb::NumOutputs];
+		for (FFrequenSeePartitionedConvolver& Convolver : Convolvers)
+		{
+			Convolver.Init(256, IRLength);
+			Convolver.SetImpulseResponse(IR.GetData(), IRLength);
+		}
+		Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (FFrequenSeePartitionedConvolver& Convolver : Convolvers)
+			{
+				Convolver.Process(Input.GetData(), Output.GetData(), CallbackFrames);
+			}
+		}
+		const double ConvolutionSeconds = FPlatformTime::Seconds() - Start;
+
+		UE_LOG(LogTemp, Display, TEXT("Late reverb: T60 %.3f s, IR energy %.3f"), T60, IREnergy);
+		UE_LOG(LogTemp, Display, TEXT("  Schroeder fit of the IR: T60 %.3f s"), FittedT60);
+		UE_LOG(LogTemp, Display, TEXT("  FDN impulse response: T60 %.3f s, energy %.3f per channel"), FdnT60, FdnEnergy);
+		UE_LOG(LogTemp, Display, TEXT("  %.3f ms FDN vs %.3f ms convolution per stereo %d-frame callback"),
+		       FdnSeconds * 1000.0 / Iterations, ConvolutionSeconds * 1000.0 / Iterations, CallbackFrames);
+	}
+
+	FAutoConsoleCommand LateReverbBenchmarkCommand(
+		TEXT("FrequenSee.Bench.LateReverb"),
+		TEXT("Fits a synthetic IR's decay, checks the FDN fallback reproduces its T60 and energy, and times it against convolution. Args: [T60] [SampleRate]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunLateReverbBenchmark));
+}
@@ -0,0 +1,164 @@
+#include "FrequenSeeOcclusionFilter.h"
+
+namespace
+{
+	constexpr float ButterworthQ = 0.70710678f;
+	constexpr int32 NumLanes = 4;
+	/** Floats of direct form I state per lane group: two past inputs, lowpass outputs and highpass outputs. */
+	constexpr int32 StatePerGroup = 6 * NumLanes;
+}
+
+void FFrequenSeeOcclusionFilter::Init(float InSampleRate, int32 InNumChannels)
+{
+	check(InSampleRate > 0.0f && InNumChannels > 0);
+
+	SampleRate = InSampleRate;
+	NumChannels = InNumChannels;
+	NumLaneGroups = FMath::DivideAndRoundUp(NumChannels, NumLanes);
+	State.SetNumZeroed(NumLaneGroups * StatePerGroup);
+
+	SetTargets(1.0f, SampleRate, 0.0f);
+	SnapToTargets();
+}
+
+void FFrequenSeeOcclusionFilter::SetTargets(float InGain, float InLowpassHz, float InHighpassHz)
+{
+	const float MaxCutoff = 0.45f * SampleRate;
+	TargetGain = FMath::Max(InGain, 0.0f);
+	TargetLowpassHz = FMath::Clamp(InLowpassHz, 10.0f, MaxCutoff);
+	TargetHighpassHz = FMath::Clamp(InHighpassHz, 10.0f, MaxCutoff);
+}
+
+void FFrequenSeeOcclusionFilter::SnapToTargets()
+{
+	CurrentGain = TargetGain;
+	CurrentLowpassHz = TargetLowpassHz;
+	CurrentHighpassHz = TargetHighpassHz;
+	UpdateCoefficients();
+}
+
+void FFrequenSeeOcclusionFilter::Reset()
+{
+	FMemory::Memzero(State.GetData(), sizeof(float) * State.Num());
+	SnapToTargets();
+}
+
+void FFrequenSeeOcclusionFilter::UpdateCoefficients()
+{
+	auto Design = [this](float CutoffHz, bool bHighpass, FBiquadCoefficients& Out)
+	{
+		const float Omega = 2.0f * PI * CutoffHz / SampleRate;
+		const float CosOmega = FMath::Cos(Omega);
+		const float Alpha = FMath::Sin(Omega) / (2.0f * ButterworthQ);
+		const float InvA0 = 1.0f / (1.0f + Alpha);
+		const float Edge = bHighpass ? (1.0f + CosOmega) : (1.0f - CosOmega);
+
+		Out.B0 = 0.5f * Edge * InvA0;
+		Out.B1 = (bHighpass ? -Edge : Edge) * InvA0;
+		Out.B2 = Out.B0;
+		Out.A1 = -2.0f * CosOmega * InvA0;
+		Out.A2 = (1.0f - Alpha) * InvA0;
+	};
+
+	Design(CurrentLowpassHz, false, Lowpass);
+	Design(CurrentHighpassHz, true, Highpass);
+}
+
+void FFrequenSeeOcclusionFilter::Process(const float* In, float* Out, int32 NumFrames)
+{
+	checkSlow(IsInitialized());
+
+	// Coefficients are refreshed every CoefficientInterval frames so a glide never jumps far in one step
+	for (int32 Offset = 0; Offset < NumFrames; Offset += CoefficientInterval)
+	{
+		const int32 Count = FMath::Min(CoefficientInterval, NumFrames - Offset);
+		ProcessSpan(In + Offset * NumChannels, Out + Offset * NumChannels, Count);
+	}
+}
+
+void FFrequenSeeOcclusionFilter::ProcessSpan(const float* In, float* Out, int32 NumFrames)
+{
+	// Glide towards the targets by this span's share of the smoothing time constant
+	const float Smoothing = 1.0f - FMath::Exp(-NumFrames / (SampleRate * SmoothingSeconds));
+	const float StartGain = CurrentGain;
+	CurrentGain += (TargetGain - CurrentGain) * Smoothing;
+	CurrentLowpassHz *= FMath::Pow(TargetLowpassHz / CurrentLowpassHz, Smoothing);
+	CurrentHighpassHz *= FMath::Pow(TargetHighpassHz / CurrentHighpassHz, Smoothing);
+	UpdateCoefficients();
+
+	const float GainStep = (CurrentGain - StartGain) / NumFrames;
+
+	const VectorRegister4Float LB0 = VectorSetFloat1(Lowpass.B0);
+	const VectorRegister4Float LB1 = VectorSetFloat1(Lowpass.B1);
+	const VectorRegister4Float LB2 = VectorSetFloat1(Lowpass.B2);
+	const VectorRegister4Float LA1 = VectorSetFloat1(Lowpass.A1);
+	const VectorRegister4Float LA2 = VectorSetFloat1(Lowpass.A2);
+	const VectorRegister4Float HB0 = VectorSetFloat1(Highpass.B0);
+	const VectorRegister4Float HB1 = VectorSetFloat1(Highpass.B1);
+	const VectorRegister4Float HB2 = VectorSetFloat1(Highpass.B2);
+	const VectorRegister4Float HA1 = VectorSetFloat1(Highpass.A1);
+	const VectorRegister4Float HA2 = VectorSetFloat1(Highpass.A2);
+
+	for (int32 Group = 0; Group < NumLaneGroups; ++Group)
+	{
+		const int32 FirstChannel = Group * NumLanes;
+		const int32 NumGroupLanes = FMath::Min(NumLanes, NumChannels - FirstChannel);
+
+		// Direct form I keeps only past samples as state, so coefficient changes cannot produce transients
+		float* GroupState = State.GetData() + Group * StatePerGroup;
+		VectorRegister4Float X1 = VectorLoadAligned(GroupState);
+		VectorRegister4Float X2 = VectorLoadAligned(GroupState + NumLanes);
+		VectorRegister4Float L1 = VectorLoadAligned(GroupState + 2 * NumLanes);
+		VectorRegister4Float L2 = VectorLoadAligned(GroupState + 3 * NumLanes);
+		VectorRegister4Float H1 = VectorLoadAligned(GroupState + 4 * NumLanes);
+		VectorRegister4Float H2 = VectorLoadAligned(GroupState + 5 * NumLanes);
+
+		alignas(16) float InLanes[NumLanes] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		alignas(16) float OutLanes[NumLanes];
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float* Source = In + Frame * NumChannels + FirstChannel;
+			for (int32 Lane = 0; Lane < NumGroupLanes; ++Lane)
+			{
+				InLanes[Lane] = Source[Lane];
+			}
+			const VectorRegister4Float X = VectorLoadAligned(InLanes);
+
+			// Lowpass, then highpass on the lowpass output
+			VectorRegister4Float L = VectorMultiply(LB0, X);
+			L = VectorMultiplyAdd(LB1, X1, L);
+			L = VectorMultiplyAdd(LB2, X2, L);
+			L = VectorNegateMultiplyAdd(LA1, L1, L);
+			L = VectorNegateMultiplyAdd(LA2, L2, L);
+
+			VectorRegister4Float H = VectorMultiply(HB0, L);
+			H = VectorMultiplyAdd(HB1, L1, H);
+			H = VectorMultiplyAdd(HB2, L2, H);
+			H = VectorNegateMultiplyAdd(HA1, H1, H);
+			H = VectorNegateMultiplyAdd(HA2, H2, H);
+
+			X2 = X1;
+			X1 = X;
+			L2 = L1;
+			L1 = L;
+			H2 = H1;
+			H1 = H;
+
+			const float Gain = StartGain + GainStep * (Frame + 1);
+			VectorStoreAligned(VectorMultiply(H, VectorSetFloat1(Gain)), OutLanes);
+
+			float* Dest = Out + Frame * NumChannels + FirstChannel;
+			for (int32 Lane = 0; Lane < NumGroupLanes; ++Lane)
+			{
+				Dest[Lane] = OutLanes[Lane];
+			}
+		}
+
+		VectorStoreAligned(X1, GroupState);
+		VectorStoreAligned(X2, GroupState + NumLanes);
+		VectorStoreAligned(L1, GroupState + 2 * NumLanes);
+		VectorStoreAligned(L2, GroupState + 3 * NumLanes);
+		VectorStoreAligned(H1, GroupState + 4 * NumLanes);
+		VectorStoreAligned(H2, GroupState + 5 * NumLanes);
+	}
+}
@@ -0,0 +1,315 @@
+#include "FrequenSeePartitionedConvolver.h"
+
+void FFrequenSeePartitionedConvolver::Init(int32 InBlockSize, int32 InMaxIRLength, int32 InNumChannels, bool bInSpectralShaping)
+{
+	check(InBlockSize > 0 && InMaxIRLength > 0 && InNumChannels > 0);
+
+	BlockSize = InBlockSize;
+	FFT.Init(2 * BlockSize);
+
+	const int32 NumBins = FFT.GetNumBins();
+	const int32 MaxPartitions = FMath::DivideAndRoundUp(InMaxIRLength, BlockSize);
+
+	for (int32 FilterIndex = 0; FilterIndex < 2; ++FilterIndex)
+	{
+		Filters[FilterIndex].SetNum(MaxPartitions);
+		FilterPointers[FilterIndex].SetNumUninitialized(MaxPartitions);
+		for (int32 Partition = 0; Partition < MaxPartitions; ++Partition)
+		{
+			Filters[FilterIndex][Partition].Init(NumBins);
+			FilterPointers[FilterIndex][Partition] = &Filters[FilterIndex][Partition];
+		}
+		BankResponses[FilterIndex].Reset();
+		NumPartitions[FilterIndex] = 0;
+	}
+	ActiveFilter = 0;
+	bCrossfadePending = false;
+
+	ShapingSourcePartitions = 0;
+	ShapingResponse.Reset();
+	if (bInSpectralShaping)
+	{
+		ShapingSource.SetNum(MaxPartitions);
+		ShapingPointers.SetNumUninitialized(MaxPartitions);
+		for (int32 Partition = 0; Partition < MaxPartitions; ++Partition)
+		{
+			ShapingSource[Partition].Init(NumBins);
+			ShapingPointers[Partition] = &ShapingSource[Partition];
+		}
+		SpectralGains.SetNumZeroed(Align(NumBins, FrequenSeeSpectrum::BinAlignment));
+		for (int32 Bin = 0; Bin < NumBins; ++Bin)
+		{
+			SpectralGains[Bin] = 1.0f;
+		}
+	}
+	else
+	{
+		ShapingSource.Empty();
+		ShapingPointers.Empty();
+		SpectralGains.Empty();
+	}
+
+	Channels.SetNum(InNumChannels);
+	for (FChannelState& Channel : Channels)
+	{
+		Channel.InputWindow.SetNumZeroed(2 * BlockSize);
+		Channel.OutputBlock.SetNumZeroed(BlockSize);
+		Channel.DelayLine.SetNum(MaxPartitions);
+		for (FSplitComplexSpectrum& Spectrum : Channel.DelayLine)
+		{
+			Spectrum.Init(NumBins);
+		}
+	}
+	DelayLineHead = 0;
+	StagedFrames = 0;
+
+	InputPointers.SetNumUninitialized(MaxPartitions);
+	TimeScratch.SetNumZeroed(2 * BlockSize);
+	CrossfadeScratch.SetNumZeroed(BlockSize);
+	Accumulator.Init(NumBins);
+}
+
+int32 FFrequenSeePartitionedConvolver::BeginFilterUpdate()
+{
+	// A filter that has not been heard yet can simply be overwritten; otherwise fill the idle bank and fade to it
+	const int32 Target = bCrossfadePending ? ActiveFilter : 1 - ActiveFilter;
+	ActiveFilter = Target;
+	bCrossfadePending = true;
+	return Target;
+}
+
+void FFrequenSeePartitionedConvolver::SetImpulseResponse(const float* IR, int32 IRLength)
+{
+	check(IsInitialized());
+
+	const int32 Target = BeginFilterUpdate();
+	IRLength = FMath::Min(IRLength, GetMaxPartitions() * BlockSize);
+	const int32 NumIRPartitions = FMath::DivideAndRoundUp(IRLength, BlockSize);
+
+	// With shaping the transform goes to the unshaped copy and the bank is filled from it below
+	TArray<FSplitComplexSpectrum>& Destination = HasSpectralShaping() ? ShapingSource : Filters[Target];
+	TArray<const FSplitComplexSpectrum*>& Pointers = HasSpectralShaping() ? ShapingPointers : FilterPointers[Target];
+
+	const float Scale = 1.0f / FFT.GetFFTSize();
+	float* Padded = TimeScratch.GetData();
+	for (int32 Partition = 0; Partition < NumIRPartitions; ++Partition)
+	{
+		const int32 Offset = Partition * BlockSize;
+		const int32 Count = FMath::Min(BlockSize, IRLength - Offset);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Padded[i] = IR[Offset + i] * Scale;
+		}
+		FMemory::Memzero(Padded + Count, sizeof(float) * (2 * BlockSize - Count));
+		FFT.Forward(Padded, Destination[Partition]);
+		Pointers[Partition] = &Destination[Partition];
+	}
+
+	if (HasSpectralShaping())
+	{
+		ShapingSourcePartitions = NumIRPartitions;
+		ApplySpectralGains(Target);
+		ShapingResponse.Reset();
+	}
+	else
+	{
+		NumPartitions[Target] = NumIRPartitions;
+		BankResponses[Target].Reset();
+	}
+}
+
+FFrequenSeePreparedImpulseResponsePtr FFrequenSeePartitionedConvolver::PrepareImpulseResponse(int32 InBlockSize, const float* IR, int32 IRLength)
+{
+	check(InBlockSize > 0);
+
+	FFrequenSeeRealFFT PrepareFFT(2 * InBlockSize);
+	FFrequenSeeAlignedFloats Padded;
+	Padded.SetNumZeroed(2 * InBlockSize);
+
+	TSharedRef<FFrequenSeePreparedImpulseResponse, ESPMode::ThreadSafe> Prepared = MakeShared<FFrequenSeePreparedImpulseResponse, ESPMode::ThreadSafe>();
+	Prepared->BlockSize = InBlockSize;
+	Prepared->NumPartitions = IR ? FMath::DivideAndRoundUp(FMath::Max(IRLength, 0), InBlockSize) : 0;
+	Prepared->Partitions.SetNum(Prepared->NumPartitions);
+
+	const float Scale = 1.0f / PrepareFFT.GetFFTSize();
+	for (int32 Partition = 0; Partition < Prepared->NumPartitions; ++Partition)
+	{
+		const int32 Offset = Partition * InBlockSize;
+		const int32 Count = FMath::Min(InBlockSize, IRLength - Offset);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Padded[i] = IR[Offset + i] * Scale;
+		}
+		FMemory::Memzero(Padded.GetData() + Count, sizeof(float) * (2 * InBlockSize - Count));
+		Prepared->Partitions[Partition].Init(PrepareFFT.GetNumBins());
+		PrepareFFT.Forward(Padded.GetData(), Prepared->Partitions[Partition]);
+	}
+	return Prepared;
+}
+
+FFrequenSeePreparedImpulseResponsePtr FFrequenSeePartitionedConvolver::SetImpulseResponse(FFrequenSeePreparedImpulseResponsePtr Prepared, int32 MaxIRPartitions)
+{
+	check(IsInitialized());
+	check(!Prepared.IsValid() || Prepared->BlockSize == BlockSize);
+
+	const int32 Target = BeginFilterUpdate();
+	const int32 NumIRPartitions = Prepared.IsValid() ? FMath::Clamp(FMath::Min(Prepared->NumPartitions, MaxIRPartitions), 0, GetMaxPartitions()) : 0;
+
+	// Only pointers change hands; the reference swapped out below is what the convolver stops using
+	TArray<const FSplitComplexSpectrum*>& Pointers = HasSpectralShaping() ? ShapingPointers : FilterPointers[Target];
+	for (int32 Partition = 0; Partition < NumIRPartitions; ++Partition)
+	{
+		Pointers[Partition] = &Prepared->Partitions[Partition];
+	}
+
+	if (HasSpectralShaping())
+	{
+		ShapingSourcePartitions = NumIRPartitions;
+		ApplySpectralGains(Target);
+		Swap(ShapingResponse, Prepared);
+	}
+	else
+	{
+		NumPartitions[Target] = NumIRPartitions;
+		Swap(BankResponses[Target], Prepared);
+	}
+	return Prepared;
+}
+
+void FFrequenSeePartitionedConvolver::SetSpectralGains(const float* Gains, int32 NumGains)
+{
+	check(HasSpectralShaping());
+
+	const int32 NumBins = GetNumBins();
+	if (Gains)
+	{
+		check(NumGains == NumBins);
+		FMemory::Memcpy(SpectralGains.GetData(), Gains, sizeof(float) * NumBins);
+	}
+	else
+	{
+		for (int32 Bin = 0; Bin < NumBins; ++Bin)
+		{
+			SpectralGains[Bin] = 1.0f;
+		}
+	}
+
+	ApplySpectralGains(BeginFilterUpdate());
+}
+
+void FFrequenSeePartitionedConvolver::ApplySpectralGains(int32 FilterIndex)
+{
+	const float* Gains = SpectralGains.GetData();
+	NumPartitions[FilterIndex] = ShapingSourcePartitions;
+	for (int32 Partition = 0; Partition < ShapingSourcePartitions; ++Partition)
+	{
+		FSplitComplexSpectrum* Shaped = &Filters[FilterIndex][Partition];
+		FrequenSeeSpectrum::MultiplyByGains(*ShapingPointers[Partition], &Gains, &Shaped, 1);
+	}
+}
+
+void FFrequenSeePartitionedConvolver::Process(const float* In, float* Out, int32 NumFrames)
+{
+	check(IsInitialized());
+
+	const int32 NumChannels = Channels.Num();
+	int32 Frame = 0;
+	while (Frame < NumFrames)
+	{
+		// Stage input into the current block while handing out the previous block's output
+		const int32 Count = FMath::Min(BlockSize - StagedFrames, NumFrames - Frame);
+		for (int32 ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+		{
+			FChannelState& Channel = Channels[ChannelIndex];
+			float* Staging = Channel.InputWindow.GetData() + BlockSize + StagedFrames;
+			const float* Ready = Channel.OutputBlock.GetData() + StagedFrames;
+			const float* Source = In + Frame * NumChannels + ChannelIndex;
+			float* Dest = Out + Frame * NumChannels + ChannelIndex;
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Staging[i] = Source[i * NumChannels];
+				Dest[i * NumChannels] = Ready[i];
+			}
+		}
+
+		StagedFrames += Count;
+		Frame += Count;
+		if (StagedFrames == BlockSize)
+		{
+			ProcessStagedBlock();
+			StagedFrames = 0;
+		}
+	}
+}
+
+void FFrequenSeePartitionedConvolver::ProcessStagedBlock()
+{
+	const int32 MaxPartitions = GetMaxPartitions();
+	DelayLineHead = (DelayLineHead + 1) % MaxPartitions;
+
+	const int32 FadingFilter = 1 - ActiveFilter;
+	const int32 NumInputs = bCrossfadePending
+		? FMath::Max(NumPartitions[ActiveFilter], NumPartitions[FadingFilter])
+		: NumPartitions[ActiveFilter];
+
+	for (FChannelState& Channel : Channels)
+	{
+		float* Window = Channel.InputWindow.GetData();
+		FFT.Forward(Window, Channel.DelayLine[DelayLineHead]);
+		FMemory::Memcpy(Window, Window + BlockSize, sizeof(float) * BlockSize);
+
+		// Partition p of the filter meets the input from p blocks ago
+		for (int32 Partition = 0, Slot = DelayLineHead; Partition < NumInputs; ++Partition)
+		{
+			InputPointers[Partition] = &Channel.DelayLine[Slot];
+			Slot = (Slot == 0) ? MaxPartitions - 1 : Slot - 1;
+		}
+
+		float* Out = Channel.OutputBlock.GetData();
+		RenderFilter(ActiveFilter, Out);
+
+		if (bCrossfadePending)
+		{
+			float* Fading = CrossfadeScratch.GetData();
+			RenderFilter(FadingFilter, Fading);
+			const float Step = 1.0f / BlockSize;
+			for (int32 i = 0; i < BlockSize; ++i)
+			{
+				Out[i] = Fading[i] + (Out[i] - Fading[i]) * (i + 1) * Step;
+			}
+		}
+	}
+
+	bCrossfadePending = false;
+}
+
+void FFrequenSeePartitionedConvolver::RenderFilter(int32 FilterIndex, float* Out)
+{
+	if (NumPartitions[FilterIndex] == 0)
+	{
+		FMemory::Memzero(Out, sizeof(float) * BlockSize);
+		return;
+	}
+
+	FrequenSeeSpectrum::MultiplyAccumulate(InputPointers.GetData(), FilterPointers[FilterIndex].GetData(),
+	                                       NumPartitions[FilterIndex], Accumulator, false);
+
+	// Overlap-save: the second half of the circular convolution is the linear result for this block
+	FFT.Inverse(Accumulator, TimeScratch.GetData());
+	FMemory::Memcpy(Out, TimeScratch.GetData() + BlockSize, sizeof(float) * BlockSize);
+}
+
+void FFrequenSeePartitionedConvolver::Reset()
+{
+	for (FChannelState& Channel : Channels)
+	{
+		FMemory::Memzero(Channel.InputWindow.GetData(), sizeof(float) * Channel.InputWindow.Num());
+		FMemory::Memzero(Channel.OutputBlock.GetData(), sizeof(float) * Channel.OutputBlock.Num());
+		for (FSplitComplexSpectrum& Spectrum : Channel.DelayLine)
+		{
+			Spectrum.Zero();
+		}
+	}
+	StagedFrames = 0;
+	bCrossfadePending = false;
+}
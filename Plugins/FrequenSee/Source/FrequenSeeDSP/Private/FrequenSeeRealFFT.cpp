@@ -0,0 +1,57 @@
+#include "FrequenSeeRealFFT.h"
+
+#include "kiss_fftr.h"
+
+FFrequenSeeRealFFT::FFrequenSeeRealFFT(int32 InFFTSize)
+{
+	Init(InFFTSize);
+}
+
+FFrequenSeeRealFFT::~FFrequenSeeRealFFT()
+{
+	Release();
+}
+
+void FFrequenSeeRealFFT::Init(int32 InFFTSize)
+{
+	check(InFFTSize > 0 && InFFTSize % 2 == 0);
+	if (InFFTSize == FFTSize)
+	{
+		return;
+	}
+
+	Release();
+	FFTSize = InFFTSize;
+	ForwardCfg = kiss_fftr_alloc(FFTSize, 0, nullptr, nullptr);
+	InverseCfg = kiss_fftr_alloc(FFTSize, 1, nullptr, nullptr);
+	Scratch.SetNumZeroed(2 * GetNumBins());
+}
+
+void FFrequenSeeRealFFT::Release()
+{
+	if (ForwardCfg)
+	{
+		kiss_fftr_free(ForwardCfg);
+		ForwardCfg = nullptr;
+	}
+	if (InverseCfg)
+	{
+		kiss_fftr_free(InverseCfg);
+		InverseCfg = nullptr;
+	}
+	FFTSize = 0;
+}
+
+void FFrequenSeeRealFFT::Forward(const float* TimeData, FSplitComplexSpectrum& OutSpectrum)
+{
+	checkSlow(OutSpectrum.GetNumBins() == GetNumBins());
+	kiss_fftr(ForwardCfg, TimeData, reinterpret_cast<kiss_fft_cpx*>(Scratch.GetData()));
+	OutSpectrum.FromInterleaved(Scratch.GetData());
+}
+
+void FFrequenSeeRealFFT::Inverse(const FSplitComplexSpectrum& Spectrum, float* OutTimeData)
+{
+	checkSlow(Spectrum.GetNumBins() == GetNumBins());
+	Spectrum.ToInterleaved(Scratch.GetData());
+	kiss_fftri(InverseCfg, reinterpret_cast<const kiss_fft_cpx*>(Scratch.GetData()), OutTimeData);
+}
@@ -0,0 +1,160 @@
+#include "FrequenSeeSlabPool.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+FFrequenSeeSlabPool& FFrequenSeeSlabPool::Get()
+{
+	// Never destroyed: pooled arrays in other statics may still release into it during shutdown
+	static FFrequenSeeSlabPool* Pool = new FFrequenSeeSlabPool();
+	return *Pool;
+}
+
+void* FFrequenSeeSlabPool::Acquire(SIZE_T Bytes, SIZE_T& OutSlabBytes)
+{
+	check(Bytes > 0);
+	OutSlabBytes = GetSlabBytes(Bytes);
+	const int32 ClassIndex = GetClassIndex(OutSlabBytes);
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		BytesInUse += OutSlabBytes;
+		HighWaterBytesInUse = FMath::Max(HighWaterBytesInUse, BytesInUse);
+		if (ClassIndex != INDEX_NONE)
+		{
+			FSlabClass& Class = Classes[ClassIndex];
+			++Class.NumInUse;
+			Class.HighWaterInUse = FMath::Max(Class.HighWaterInUse, Class.NumInUse);
+
+			if (FFreeSlab* Slab = Class.FreeList)
+			{
+				Class.FreeList = Slab->Next;
+				--Class.NumFree;
+				BytesFree -= OutSlabBytes;
+				++NumReused;
+				return Slab;
+			}
+		}
+		++NumHeapAllocations;
+	}
+
+	// The heap is only touched outside the lock
+	return FMemory::Malloc(OutSlabBytes, SlabAlignment);
+}
+
+void FFrequenSeeSlabPool::Release(void* Slab, SIZE_T SlabBytes)
+{
+	check(Slab && SlabBytes == GetSlabBytes(SlabBytes));
+	const int32 ClassIndex = GetClassIndex(SlabBytes);
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		BytesInUse -= SlabBytes;
+		if (ClassIndex != INDEX_NONE)
+		{
+			FSlabClass& Class = Classes[ClassIndex];
+			check(Class.NumInUse > 0);
+			--Class.NumInUse;
+			if (Class.NumFree < GetMaxFreeSlabs(ClassIndex))
+			{
+				FFreeSlab* FreeSlab = static_cast<FFreeSlab*>(Slab);
+				FreeSlab->Next = Class.FreeList;
+				Class.FreeList = FreeSlab;
+				++Class.NumFree;
+				BytesFree += SlabBytes;
+				return;
+			}
+		}
+		++NumHeapFrees;
+	}
+
+	// A full class or an oversized slab goes back to the heap, outside the lock
+	FMemory::Free(Slab);
+}
+
+void FFrequenSeeSlabPool::Trim()
+{
+	FFreeSlab* ToFree = nullptr;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (FSlabClass& Class : Classes)
+		{
+			while (FFreeSlab* Slab = Class.FreeList)
+			{
+				Class.FreeList = Slab->Next;
+				Slab->Next = ToFree;
+				ToFree = Slab;
+			}
+			Class.NumFree = 0;
+		}
+		BytesFree = 0;
+	}
+
+	while (ToFree)
+	{
+		FFreeSlab* Next = ToFree->Next;
+		FMemory::Free(ToFree);
+		ToFree = Next;
+	}
+}
+
+FFrequenSeeSlabPool::FStats FFrequenSeeSlabPool::GetStats() const
+{
+	FStats Stats;
+	FScopeLock ScopeLock(&Lock);
+	Stats.BytesInUse = BytesInUse;
+	Stats.BytesFree = BytesFree;
+	Stats.HighWaterBytesInUse = HighWaterBytesInUse;
+	Stats.NumReused = NumReused;
+	Stats.NumHeapAllocations = NumHeapAllocations;
+	Stats.NumHeapFrees = NumHeapFrees;
+	for (int32 ClassIndex = 0; ClassIndex < NumClasses; ++ClassIndex)
+	{
+		const FSlabClass& Class = Classes[ClassIndex];
+		if (Class.HighWaterInUse == 0)
+		{
+			continue;
+		}
+		FClassStats& ClassStats = Stats.Classes.AddDefaulted_GetRef();
+		ClassStats.SlabBytes = GetClassSlabBytes(ClassIndex);
+		ClassStats.NumInUse = Class.NumInUse;
+		ClassStats.NumFree = Class.NumFree;
+		ClassStats.HighWaterInUse = Class.HighWaterInUse;
+	}
+	return Stats;
+}
+
+namespace
+{
+	/**
+	 * FrequenSee.Memory.Pool [trim]
+	 * Logs the slab pool's bytes in use, cached and at the high-water mark, and every slab class from the largest down.
+	 * With "trim", first returns the cached slabs to the heap.
+	 */
+	void ReportSlabPool(const TArray<FString>& Args)
+	{
+		FFrequenSeeSlabPool& Pool = FFrequenSeeSlabPool::Get();
+		if (Args.Num() > 0 && Args[0] == TEXT("trim"))
+		{
+			Pool.Trim();
+		}
+
+		FFrequenSeeSlabPool::FStats Stats = Pool.GetStats();
+		Stats.Classes.Sort([](const FFrequenSeeSlabPool::FClassStats& A, const FFrequenSeeSlabPool::FClassStats& B) { return A.SlabBytes > B.SlabBytes; });
+
+		constexpr double MB = 1024.0 * 1024.0;
+		UE_LOG(LogTemp, Display, TEXT("Slab pool: %.2f MB in use, %.2f MB free, %.2f MB high-water; %llu reused, %llu heap allocations, %llu heap frees"),
+		       Stats.BytesInUse / MB, Stats.BytesFree / MB, Stats.HighWaterBytesInUse / MB, Stats.NumReused, Stats.NumHeapAllocations,
+		       Stats.NumHeapFrees);
+		for (const FFrequenSeeSlabPool::FClassStats& Class : Stats.Classes)
+		{
+			UE_LOG(LogTemp, Display, TEXT("  %8.1f KB: %d in use, %d free, %d high-water"),
+			       Class.SlabBytes / 1024.0, Class.NumInUse, Class.NumFree, Class.HighWaterInUse);
+		}
+	}
+
+	FAutoConsoleCommand SlabPoolCommand(
+		TEXT("FrequenSee.Memory.Pool"),
+		TEXT("Logs the slab pool that backs impulse responses, convolver partitions and delay rings. Args: [trim]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ReportSlabPool));
+}
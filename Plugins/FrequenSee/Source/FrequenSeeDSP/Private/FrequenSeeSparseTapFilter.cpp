@@ -0,0 +1,183 @@
+#include "FrequenSeeSparseTapFilter.h"
+
+namespace
+{
+	/** Samples a Lagrange tap reads beyond its integer delay: one newer, two older. */
+	constexpr int32 InterpolationSpan = 4;
+}
+
+void FFrequenSeeSparseTapFilter::Init(int32 InMaxDelayFrames, int32 InMaxBlockFrames)
+{
+	check(InMaxDelayFrames >= 1 && InMaxBlockFrames > 0);
+
+	MaxDelayFrames = InMaxDelayFrames;
+	MaxBlockFrames = InMaxBlockFrames;
+	HistorySize = FMath::RoundUpToPowerOfTwo(FMath::Max(MaxDelayFrames, MaxHeadFrames) + MaxBlockFrames + InterpolationSpan);
+	History.SetNumZeroed(2 * HistorySize);
+	Reset();
+}
+
+void FFrequenSeeSparseTapFilter::Reset()
+{
+	FMemory::Memzero(History.GetData(), sizeof(float) * History.Num());
+	WritePosition = 0;
+	for (FTapSet& Set : TapSets)
+	{
+		Set.NumTaps = 0;
+		Set.HeadStart = 0;
+		Set.HeadEnd = 0;
+	}
+	ActiveSet = 0;
+	CrossfadeRemaining = 0;
+}
+
+FFrequenSeeSparseTapFilter::FTapSet& FFrequenSeeSparseTapFilter::BeginUpdate()
+{
+	checkSlow(IsInitialized());
+
+	// A set arriving mid-crossfade replaces the incoming one and restarts the fade; updates come far less often
+	if (CrossfadeRemaining == 0)
+	{
+		const FTapSet& Current = TapSets[ActiveSet];
+		ActiveSet = 1 - ActiveSet;
+		FTapSet& Next = TapSets[ActiveSet];
+		Next.NumTaps = Current.NumTaps;
+		FMemory::Memcpy(Next.Delays, Current.Delays, sizeof(int32) * Current.NumTaps);
+		FMemory::Memcpy(Next.Coefficients, Current.Coefficients, sizeof(float) * 4 * Current.NumTaps);
+		Next.HeadStart = Current.HeadStart;
+		Next.HeadEnd = Current.HeadEnd;
+		FMemory::Memcpy(Next.Head + Current.HeadStart, Current.Head + Current.HeadStart, sizeof(float) * (Current.HeadEnd - Current.HeadStart));
+	}
+	CrossfadeRemaining = CrossfadeFrames;
+	return TapSets[ActiveSet];
+}
+
+void FFrequenSeeSparseTapFilter::SetTaps(const FFrequenSeeSparseTap* Taps, int32 NumTaps)
+{
+	FTapSet& Set = BeginUpdate();
+	Set.NumTaps = Taps ? FMath::Min(NumTaps, MaxTaps) : 0;
+	for (int32 Tap = 0; Tap < Set.NumTaps; ++Tap)
+	{
+		const float Delay = FMath::Clamp(Taps[Tap].DelayFrames, 1.0f, float(MaxDelayFrames));
+		const int32 IntegerDelay = FMath::Min(FMath::FloorToInt32(Delay), MaxDelayFrames - 1);
+		const float F = Delay - IntegerDelay;
+		const float Gain = Taps[Tap].Gain;
+
+		// Lagrange weights for the samples IntegerDelay - 1, IntegerDelay, IntegerDelay + 1, IntegerDelay + 2 back
+		Set.Delays[Tap] = IntegerDelay;
+		Set.Coefficients[Tap][0] = Gain * -F * (F - 1.0f) * (F - 2.0f) / 6.0f;
+		Set.Coefficients[Tap][1] = Gain * (F + 1.0f) * (F - 1.0f) * (F - 2.0f) / 2.0f;
+		Set.Coefficients[Tap][2] = Gain * -(F + 1.0f) * F * (F - 2.0f) / 2.0f;
+		Set.Coefficients[Tap][3] = Gain * (F + 1.0f) * F * (F - 1.0f) / 6.0f;
+	}
+}
+
+void FFrequenSeeSparseTapFilter::SetHead(const float* Head, int32 NumFrames)
+{
+	FTapSet& Set = BeginUpdate();
+
+	// only the nonzero span is stored and run; a head that starts with the direct-path delay skips its leading zeros
+	int32 Start = 0;
+	int32 End = Head ? FMath::Min(NumFrames, MaxHeadFrames) : 0;
+	while (Start < End && Head[Start] == 0.0f)
+	{
+		++Start;
+	}
+	while (End > Start && Head[End - 1] == 0.0f)
+	{
+		--End;
+	}
+	Set.HeadStart = Start;
+	Set.HeadEnd = End;
+	FMemory::Memcpy(Set.Head + Start, Head + Start, sizeof(float) * (End - Start));
+}
+
+void FFrequenSeeSparseTapFilter::Process(const float* In, float* Out, int32 NumFrames)
+{
+	checkSlow(IsInitialized());
+	check(NumFrames <= MaxBlockFrames);
+
+	// Append the block to both copies of the ring first, so In may alias Out
+	const int32 BlockStart = WritePosition;
+	const int32 FirstPart = FMath::Min(NumFrames, HistorySize - BlockStart);
+	float* HistoryData = History.GetData();
+	FMemory::Memcpy(HistoryData + BlockStart, In, sizeof(float) * FirstPart);
+	FMemory::Memcpy(HistoryData + BlockStart + HistorySize, In, sizeof(float) * FirstPart);
+	FMemory::Memcpy(HistoryData, In + FirstPart, sizeof(float) * (NumFrames - FirstPart));
+	FMemory::Memcpy(HistoryData + HistorySize, In + FirstPart, sizeof(float) * (NumFrames - FirstPart));
+	WritePosition = (WritePosition + NumFrames) & (HistorySize - 1);
+
+	FMemory::Memzero(Out, sizeof(float) * NumFrames);
+
+	int32 Offset = 0;
+	if (CrossfadeRemaining > 0)
+	{
+		const int32 FadeFrames = FMath::Min(CrossfadeRemaining, NumFrames);
+		const float Step = 1.0f / CrossfadeFrames;
+		const float FadeIn = 1.0f - CrossfadeRemaining * Step;
+		AccumulateTaps(TapSets[ActiveSet], BlockStart, Out, FadeFrames, FadeIn + Step, Step);
+		AccumulateTaps(TapSets[1 - ActiveSet], BlockStart, Out, FadeFrames, 1.0f - FadeIn - Step, -Step);
+		CrossfadeRemaining -= FadeFrames;
+		Offset = FadeFrames;
+	}
+	if (Offset < NumFrames)
+	{
+		AccumulateTaps(TapSets[ActiveSet], BlockStart + Offset, Out + Offset, NumFrames - Offset, 1.0f, 0.0f);
+	}
+}
+
+void FFrequenSeeSparseTapFilter::AccumulateTaps(const FTapSet& Set, int32 BlockStart, float* Out, int32 NumFrames, float StartGain, float GainStep) const
+{
+	const float* HistoryData = History.GetData();
+	for (int32 Tap = 0; Tap < Set.NumTaps; ++Tap)
+	{
+		// Source[n] is the sample IntegerDelay + 2 frames before output frame n; the mirrored ring keeps it contiguous
+		const int32 Start = (BlockStart - Set.Delays[Tap] - 2) & (HistorySize - 1);
+		const float* Source = HistoryData + Start;
+		const float C0 = Set.Coefficients[Tap][0];
+		const float C1 = Set.Coefficients[Tap][1];
+		const float C2 = Set.Coefficients[Tap][2];
+		const float C3 = Set.Coefficients[Tap][3];
+
+		if (GainStep == 0.0f)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Out[Frame] += C0 * Source[Frame + 3] + C1 * Source[Frame + 2] + C2 * Source[Frame + 1] + C3 * Source[Frame];
+			}
+		}
+		else
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				const float Gain = StartGain + GainStep * Frame;
+				Out[Frame] += Gain * (C0 * Source[Frame + 3] + C1 * Source[Frame + 2] + C2 * Source[Frame + 1] + C3 * Source[Frame]);
+			}
+		}
+	}
+
+	// the head is a direct FIR, one contiguous multiply-add pass per coefficient
+	for (int32 Delay = Set.HeadStart; Delay < Set.HeadEnd; ++Delay)
+	{
+		const float Coefficient = Set.Head[Delay];
+		if (Coefficient == 0.0f)
+		{
+			continue;
+		}
+		const float* Source = HistoryData + ((BlockStart - Delay) & (HistorySize - 1));
+		if (GainStep == 0.0f)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Out[Frame] += Coefficient * Source[Frame];
+			}
+		}
+		else
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Out[Frame] += (StartGain + GainStep * Frame) * Coefficient * Source[Frame];
+			}
+		}
+	}
+}
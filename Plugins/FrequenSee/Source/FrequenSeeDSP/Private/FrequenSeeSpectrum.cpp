@@ -0,0 +1,161 @@
+#include "FrequenSeeSpectrum.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX_2 && PLATFORM_ALWAYS_HAS_FMA3
+#include <immintrin.h>
+#define FREQUENSEE_SPECTRUM_AVX2 1
+#else
+#define FREQUENSEE_SPECTRUM_AVX2 0
+#endif
+
+void FSplitComplexSpectrum::Init(int32 InNumBins)
+{
+	NumBins = InNumBins;
+	const int32 PaddedBins = Align(InNumBins, FrequenSeeSpectrum::BinAlignment);
+	Real.SetNumZeroed(PaddedBins);
+	Imag.SetNumZeroed(PaddedBins);
+}
+
+void FSplitComplexSpectrum::Zero()
+{
+	FMemory::Memzero(Real.GetData(), sizeof(float) * Real.Num());
+	FMemory::Memzero(Imag.GetData(), sizeof(float) * Imag.Num());
+}
+
+void FSplitComplexSpectrum::FromInterleaved(const float* Interleaved)
+{
+	float* RESTRICT OutReal = Real.GetData();
+	float* RESTRICT OutImag = Imag.GetData();
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		OutReal[Bin] = Interleaved[2 * Bin];
+		OutImag[Bin] = Interleaved[2 * Bin + 1];
+	}
+}
+
+void FSplitComplexSpectrum::ToInterleaved(float* Interleaved) const
+{
+	const float* RESTRICT InReal = Real.GetData();
+	const float* RESTRICT InImag = Imag.GetData();
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		Interleaved[2 * Bin] = InReal[Bin];
+		Interleaved[2 * Bin + 1] = InImag[Bin];
+	}
+}
+
+namespace FrequenSeeSpectrum
+{
+	void Multiply(const FSplitComplexSpectrum& A, const FSplitComplexSpectrum& B, FSplitComplexSpectrum& Out)
+	{
+		const FSplitComplexSpectrum* APtr = &A;
+		const FSplitComplexSpectrum* BPtr = &B;
+		MultiplyAccumulate(&APtr, &BPtr, 1, Out, false);
+	}
+
+	void MultiplyAccumulate(const FSplitComplexSpectrum* const* A, const FSplitComplexSpectrum* const* B,
+	                        int32 NumPairs, FSplitComplexSpectrum& Out, bool bAccumulate)
+	{
+		const int32 PaddedBins = Out.GetPaddedNumBins();
+		float* RESTRICT OutReal = Out.Real.GetData();
+		float* RESTRICT OutImag = Out.Imag.GetData();
+
+#if FREQUENSEE_SPECTRUM_AVX2
+		// (a + bi)(c + di) = (ac - bd) + (ad + bc)i, two FMAs per output plane
+		for (int32 Bin = 0; Bin < PaddedBins; Bin += 8)
+		{
+			__m256 AccReal = bAccumulate ? _mm256_load_ps(OutReal + Bin) : _mm256_setzero_ps();
+			__m256 AccImag = bAccumulate ? _mm256_load_ps(OutImag + Bin) : _mm256_setzero_ps();
+			for (int32 Pair = 0; Pair < NumPairs; ++Pair)
+			{
+				const __m256 AR = _mm256_load_ps(A[Pair]->Real.GetData() + Bin);
+				const __m256 AI = _mm256_load_ps(A[Pair]->Imag.GetData() + Bin);
+				const __m256 BR = _mm256_load_ps(B[Pair]->Real.GetData() + Bin);
+				const __m256 BI = _mm256_load_ps(B[Pair]->Imag.GetData() + Bin);
+				AccReal = _mm256_fmadd_ps(AR, BR, AccReal);
+				AccReal = _mm256_fnmadd_ps(AI, BI, AccReal);
+				AccImag = _mm256_fmadd_ps(AR, BI, AccImag);
+				AccImag = _mm256_fmadd_ps(AI, BR, AccImag);
+			}
+			_mm256_store_ps(OutReal + Bin, AccReal);
+			_mm256_store_ps(OutImag + Bin, AccImag);
+		}
+#else
+		for (int32 Bin = 0; Bin < PaddedBins; Bin += 4)
+		{
+			VectorRegister4Float AccReal = bAccumulate ? VectorLoadAligned(OutReal + Bin) : VectorZeroFloat();
+			VectorRegister4Float AccImag = bAccumulate ? VectorLoadAligned(OutImag + Bin) : VectorZeroFloat();
+			for (int32 Pair = 0; Pair < NumPairs; ++Pair)
+			{
+				const VectorRegister4Float AR = VectorLoadAligned(A[Pair]->Real.GetData() + Bin);
+				const VectorRegister4Float AI = VectorLoadAligned(A[Pair]->Imag.GetData() + Bin);
+				const VectorRegister4Float BR = VectorLoadAligned(B[Pair]->Real.GetData() + Bin);
+				const VectorRegister4Float BI = VectorLoadAligned(B[Pair]->Imag.GetData() + Bin);
+				AccReal = VectorMultiplyAdd(AR, BR, AccReal);
+				AccReal = VectorNegateMultiplyAdd(AI, BI, AccReal);
+				AccImag = VectorMultiplyAdd(AR, BI, AccImag);
+				AccImag = VectorMultiplyAdd(AI, BR, AccImag);
+			}
+			VectorStoreAligned(AccReal, OutReal + Bin);
+			VectorStoreAligned(AccImag, OutImag + Bin);
+		}
+#endif
+	}
+
+	void MultiplyByGains(const FSplitComplexSpectrum& In, const float* const* Gains,
+	                     FSplitComplexSpectrum* const* Outs, int32 NumOutputs)
+	{
+		// Bandwidth bound, so the 4-wide path is used everywhere
+		const int32 PaddedBins = In.GetPaddedNumBins();
+		const float* InReal = In.Real.GetData();
+		const float* InImag = In.Imag.GetData();
+		for (int32 Bin = 0; Bin < PaddedBins; Bin += 4)
+		{
+			const VectorRegister4Float Re = VectorLoadAligned(InReal + Bin);
+			const VectorRegister4Float Im = VectorLoadAligned(InImag + Bin);
+			for (int32 Output = 0; Output < NumOutputs; ++Output)
+			{
+				const VectorRegister4Float Gain = VectorLoadAligned(Gains[Output] + Bin);
+				VectorStoreAligned(VectorMultiply(Re, Gain), Outs[Output]->Real.GetData() + Bin);
+				VectorStoreAligned(VectorMultiply(Im, Gain), Outs[Output]->Imag.GetData() + Bin);
+			}
+		}
+	}
+
+	void InterpolateBandGains(const float* BandGains, const float* BandCentersHz, int32 NumBands,
+	                          float BinWidthHz, float* OutGains, int32 NumBins)
+	{
+		check(NumBands > 0);
+		int32 Band = 0;
+		for (int32 Bin = 0; Bin < NumBins; ++Bin)
+		{
+			const float FrequencyHz = Bin * BinWidthHz;
+			while (Band < NumBands - 1 && FrequencyHz >= BandCentersHz[Band + 1])
+			{
+				++Band;
+			}
+
+			if (FrequencyHz <= BandCentersHz[0])
+			{
+				OutGains[Bin] = BandGains[0];
+			}
+			else if (Band == NumBands - 1)
+			{
+				OutGains[Bin] = BandGains[NumBands - 1];
+			}
+			else
+			{
+				const float Alpha = FMath::Log2(FrequencyHz / BandCentersHz[Band]) / FMath::Log2(BandCentersHz[Band + 1] / BandCentersHz[Band]);
+				OutGains[Bin] = FMath::Lerp(BandGains[Band], BandGains[Band + 1], Alpha);
+			}
+		}
+	}
+
+	const TCHAR* GetKernelName()
+	{
+#if FREQUENSEE_SPECTRUM_AVX2
+		return TEXT("AVX2/FMA");
+#else
+		return TEXT("VectorRegister4Float");
+#endif
+	}
+}
@@ -0,0 +1,113 @@
+#include "FrequenSeeSpectrum.h"
+
+#include "HAL/IConsoleManager.h"
+#include "kiss_fft.h"
+
+namespace
+{
+	// 4 multiplies + 4 adds per complex multiply-accumulate
+	constexpr double FlopsPerComplexMAC = 8.0;
+
+	/** The loop ConvolveFFT and FFrequenSeeEffect used, extended to sum several partitions. */
+	void InterleavedMultiplyAccumulate(const TArray<TArray<kiss_fft_cpx>>& A, const TArray<TArray<kiss_fft_cpx>>& B,
+	                                   TArray<kiss_fft_cpx>& Out)
+	{
+		const int32 NumBins = Out.Num();
+		for (int32 i = 0; i < NumBins; ++i)
+		{
+			Out[i].r = 0.0f;
+			Out[i].i = 0.0f;
+		}
+		for (int32 Pair = 0; Pair < A.Num(); ++Pair)
+		{
+			for (int32 i = 0; i < NumBins; ++i)
+			{
+				const kiss_fft_cpx& X = A[Pair][i];
+				const kiss_fft_cpx& Y = B[Pair][i];
+				Out[i].r += X.r * Y.r - X.i * Y.i;
+				Out[i].i += X.r * Y.i + X.i * Y.r;
+			}
+		}
+	}
+
+	/**
+	 * FrequenSee.Bench.SpectralMAC [NumBins=513] [NumPartitions=188] [Iterations=200]
+	 * Defaults match a 1 s IR at 48 kHz split into 256-sample partitions (512-point real FFTs).
+	 */
+	void RunSpectralMACBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumBins = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 513;
+		const int32 NumPartitions = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 188;
+		const int32 Iterations = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 200;
+
+		FRandomStream Random(1234);
+
+		TArray<TArray<kiss_fft_cpx>> InterleavedA, InterleavedB;
+		TArray<FSplitComplexSpectrum> SplitA, SplitB;
+		InterleavedA.SetNum(NumPartitions);
+		InterleavedB.SetNum(NumPartitions);
+		SplitA.SetNum(NumPartitions);
+		SplitB.SetNum(NumPartitions);
+		for (int32 Pair = 0; Pair < NumPartitions; ++Pair)
+		{
+			InterleavedA[Pair].SetNumUninitialized(NumBins);
+			InterleavedB[Pair].SetNumUninitialized(NumBins);
+			for (int32 i = 0; i < NumBins; ++i)
+			{
+				InterleavedA[Pair][i] = { Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f) };
+				InterleavedB[Pair][i] = { Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f) };
+			}
+			SplitA[Pair].Init(NumBins);
+			SplitB[Pair].Init(NumBins);
+			SplitA[Pair].FromInterleaved(reinterpret_cast<const float*>(InterleavedA[Pair].GetData()));
+			SplitB[Pair].FromInterleaved(reinterpret_cast<const float*>(InterleavedB[Pair].GetData()));
+		}
+
+		TArray<const FSplitComplexSpectrum*> APtrs, BPtrs;
+		for (int32 Pair = 0; Pair < NumPartitions; ++Pair)
+		{
+			APtrs.Add(&SplitA[Pair]);
+			BPtrs.Add(&SplitB[Pair]);
+		}
+
+		TArray<kiss_fft_cpx> InterleavedOut;
+		InterleavedOut.SetNumZeroed(NumBins);
+		FSplitComplexSpectrum SplitOut;
+		SplitOut.Init(NumBins);
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			InterleavedMultiplyAccumulate(InterleavedA, InterleavedB, InterleavedOut);
+		}
+		const double InterleavedSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FrequenSeeSpectrum::MultiplyAccumulate(APtrs.GetData(), BPtrs.GetData(), NumPartitions, SplitOut, false);
+		}
+		const double SplitSeconds = FPlatformTime::Seconds() - Start;
+
+		float MaxError = 0.0f;
+		for (int32 i = 0; i < NumBins; ++i)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(InterleavedOut[i].r - SplitOut.Real[i]));
+			MaxError = FMath::Max(MaxError, FMath::Abs(InterleavedOut[i].i - SplitOut.Imag[i]));
+		}
+
+		const double GFlop = FlopsPerComplexMAC * NumBins * NumPartitions * Iterations * 1e-9;
+		UE_LOG(LogTemp, Display, TEXT("SpectralMAC: %d bins x %d partitions x %d iterations"), NumBins, NumPartitions, Iterations);
+		UE_LOG(LogTemp, Display, TEXT("  interleaved scalar loop: %.3f ms/iter, %.2f GFLOP/s"),
+		       InterleavedSeconds * 1000.0 / Iterations, GFlop / FMath::Max(InterleavedSeconds, 1e-9));
+		UE_LOG(LogTemp, Display, TEXT("  split-complex %s kernel: %.3f ms/iter, %.2f GFLOP/s"), FrequenSeeSpectrum::GetKernelName(),
+		       SplitSeconds * 1000.0 / Iterations, GFlop / FMath::Max(SplitSeconds, 1e-9));
+		UE_LOG(LogTemp, Display, TEXT("  speedup %.2fx, max abs difference %g"),
+		       InterleavedSeconds / FMath::Max(SplitSeconds, 1e-9), MaxError);
+	}
+
+	FAutoConsoleCommand SpectralMACBenchmarkCommand(
+		TEXT("FrequenSee.Bench.SpectralMAC"),
+		TEXT("Compares the interleaved scalar spectrum multiply against the split-complex multiply-accumulate kernel. Args: [NumBins] [NumPartitions] [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunSpectralMACBenchmark));
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Decay analysis of energy histograms (energy per time bin), e.g. the ray tracer's EnergyBuffer. */
+namespace FrequenSeeDecay
+{
+	/** OutDecayDb[i] = 10 log10 of the energy from bin i onwards relative to the total (Schroeder backward integral). */
+	FREQUENSEEDSP_API void SchroederIntegrate(const float* Energy, int32 NumBins, float* OutDecayDb);
+
+	/**
+	 * Reverberation time in seconds from a least-squares fit of the Schroeder curve, over -5..-25 dB (T20) when the
+	 * histogram has the range, else -5..-15 dB (T10). Returns 0 if the histogram is empty or decays too little to fit.
+	 */
+	FREQUENSEEDSP_API float EstimateT60(const float* Energy, int32 NumBins, float BinSeconds);
+
+	/**
+	 * Level-independent fingerprint of a histogram's decay: its Schroeder curve sampled at NumPoints evenly spaced
+	 * bins, floored at -60 dB. All zeros for an empty histogram.
+	 */
+	FREQUENSEEDSP_API void DecayProfile(const float* Energy, int32 NumBins, float* OutProfileDb, int32 NumPoints);
+
+	/** RMS difference in dB between two decay profiles; a cheap similarity metric between impulse responses. */
+	FREQUENSEEDSP_API float ProfileDistanceDb(const float* ProfileA, const float* ProfileB, int32 NumPoints);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeSlabPool.h"
+
+/**
+ * Eight-line feedback delay network: a parametric stand-in for a convolved late reverb at a fraction of the cost.
+ *
+ * The lines are mixed through a normalized Hadamard matrix. Each line ends in a first-order shelving absorption
+ * filter whose gains at DC, MidFrequencyHz and Nyquist give that line's delay the decay of the low, mid and high
+ * reverberation times. Mono in, stereo out through two orthogonal sets of output signs. SetLevel() scales the output
+ * so the network's impulse response carries a given total energy, which lets it stand in for a measured IR.
+ * Everything is allocated in Init(); the rest is real-time safe.
+ */
+class FREQUENSEEDSP_API FFrequenSeeFDNReverb
+{
+public:
+	static constexpr int32 NumLines = 8;
+	static constexpr int32 NumOutputs = 2;
+
+	void Init(float InSampleRate);
+
+	bool IsInitialized() const { return SampleRate > 0.0f; }
+
+	/**
+	 * Reverberation times in seconds at DC, at MidFrequencyHz and at Nyquist. The mid time is matched only when it lies
+	 * between the other two, otherwise the nearer one wins.
+	 */
+	void SetDecay(float LowT60, float MidT60, float HighT60, float MidFrequencyHz);
+
+	/** Total energy of the reverb's impulse response, e.g. the sum of squares of the IR it replaces. */
+	void SetLevel(float ImpulseEnergy);
+
+	/** Adds the reverb of NumFrames mono frames to Out, NumFrames interleaved stereo frames. */
+	void Process(const float* In, float* Out, int32 NumFrames);
+
+	/** Clears the delay lines and filter state. */
+	void Reset();
+
+private:
+	/** b0 + b1 z^-1 over 1 - Pole z^-1. */
+	struct FShelf
+	{
+		float B0 = 1.0f, B1 = 0.0f, Pole = 0.0f;
+	};
+
+	void UpdateOutputGain();
+
+	float SampleRate = 0.0f;
+
+	int32 Delays[NumLines] = {};
+	/** Power-of-two ring per line, LineSize floats each, back to back. */
+	FFrequenSeeAlignedFloats Lines;
+	int32 LineSize = 0;
+	int32 WritePosition = 0;
+
+	FShelf Shelves[NumLines];
+	float ShelfInput[NumLines] = {};
+	float ShelfOutput[NumLines] = {};
+
+	/** Energy per output of the unscaled network's impulse response, for SetLevel(). */
+	float UnitImpulseEnergy = 0.0f;
+	float ImpulseEnergy = 0.0f;
+	float OutputGain = 0.0f;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeSpectrum.h"
+
+/**
+ * Occlusion voice for one source: gain followed by a lowpass and a highpass biquad (RBJ, Butterworth Q), applied to
+ * interleaved audio of any channel count.
+ *
+ * Channels are processed four at a time in the lanes of a VectorRegister4Float, so a stereo source costs the same as
+ * a mono one. Targets set with SetTargets() are approached smoothly: cutoffs glide in log frequency with a time
+ * constant of SmoothingSeconds and are re-derived into coefficients every CoefficientInterval frames, the gain ramps
+ * linearly between those updates. Everything is allocated in Init(); the rest is real-time safe.
+ */
+class FREQUENSEEDSP_API FFrequenSeeOcclusionFilter
+{
+public:
+	static constexpr float SmoothingSeconds = 0.05f;
+	static constexpr int32 CoefficientInterval = 32;
+
+	void Init(float InSampleRate, int32 InNumChannels);
+
+	bool IsInitialized() const { return SampleRate > 0.0f; }
+	int32 GetNumChannels() const { return NumChannels; }
+
+	/** New values to glide towards. Cutoffs are clamped to [10 Hz, 0.45 * SampleRate]. */
+	void SetTargets(float InGain, float InLowpassHz, float InHighpassHz);
+
+	/** Jumps straight to the targets, e.g. for the first block of a new source. */
+	void SnapToTargets();
+
+	/** Filters NumFrames interleaved frames. In and Out may point to the same buffer. */
+	void Process(const float* In, float* Out, int32 NumFrames);
+
+	/** Clears the filter history and snaps to the targets. */
+	void Reset();
+
+private:
+	/** b0, b1, b2, a1, a2 with a0 normalized away. */
+	struct FBiquadCoefficients
+	{
+		float B0 = 1.0f, B1 = 0.0f, B2 = 0.0f, A1 = 0.0f, A2 = 0.0f;
+	};
+
+	void UpdateCoefficients();
+	void ProcessSpan(const float* In, float* Out, int32 NumFrames);
+
+	float SampleRate = 0.0f;
+	int32 NumChannels = 0;
+	int32 NumLaneGroups = 0;
+
+	float TargetGain = 1.0f;
+	float TargetLowpassHz = 20000.0f;
+	float TargetHighpassHz = 20.0f;
+
+	float CurrentGain = 1.0f;
+	float CurrentLowpassHz = 20000.0f;
+	float CurrentHighpassHz = 20.0f;
+
+	FBiquadCoefficients Lowpass;
+	FBiquadCoefficients Highpass;
+
+	/** Direct form I history per lane group: x[n-1], x[n-2], lowpass y[n-1], y[n-2], highpass y[n-1], y[n-2]. */
+	FFrequenSeeAlignedFloats State;
+};
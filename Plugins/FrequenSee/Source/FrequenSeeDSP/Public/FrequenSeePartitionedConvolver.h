@@ -0,0 +1,148 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeRealFFT.h"
+#include "FrequenSeeSpectrum.h"
+
+/**
+ * An impulse response already cut into partition spectra by FFrequenSeePartitionedConvolver::PrepareImpulseResponse().
+ * Immutable once built, so any number of convolvers can share one.
+ */
+struct FFrequenSeePreparedImpulseResponse
+{
+	int32 BlockSize = 0;
+	int32 NumPartitions = 0;
+	TArray<FSplitComplexSpectrum> Partitions;
+};
+
+using FFrequenSeePreparedImpulseResponsePtr = TSharedPtr<const FFrequenSeePreparedImpulseResponse, ESPMode::ThreadSafe>;
+
+/**
+ * Uniformly partitioned overlap-save convolver for one or more channels sharing one impulse response.
+ *
+ * The impulse response is cut into BlockSize-sample partitions whose 2 * BlockSize point real spectra are kept in
+ * split-complex form. Every block the spectrum of the newest input enters a per-channel frequency-domain delay line,
+ * all partitions are summed in one FrequenSeeSpectrum::MultiplyAccumulate pass, and a single inverse FFT produces
+ * the output. Cost per block and channel is two real FFTs of 2 * BlockSize points plus one multiply-add per bin and
+ * partition.
+ *
+ * With spectral shaping enabled, the unshaped partitions are kept as well and SetSpectralGains() folds a real per-bin
+ * gain curve (e.g. band-wise material absorption) into every partition: a new curve costs one multiply per bin and
+ * partition and no FFTs.
+ *
+ * Process() accepts any number of frames per call: input is staged into BlockSize-frame blocks, which adds a fixed
+ * latency of BlockSize frames but means host block-size changes never reallocate or drop audio.
+ * Everything is allocated in Init(); SetImpulseResponse(), Process() and Reset() are real-time safe.
+ */
+class FREQUENSEEDSP_API FFrequenSeePartitionedConvolver
+{
+public:
+	/**
+	 * Allocates all state for NumChannels channels, BlockSize-frame partitions and IRs of up to MaxIRLength samples.
+	 * bInSpectralShaping keeps a third, unshaped copy of the filter so SetSpectralGains() can be used.
+	 */
+	void Init(int32 InBlockSize, int32 InMaxIRLength, int32 InNumChannels = 1, bool bInSpectralShaping = false);
+
+	bool IsInitialized() const { return BlockSize > 0; }
+	int32 GetBlockSize() const { return BlockSize; }
+	int32 GetNumChannels() const { return Channels.Num(); }
+	int32 GetNumPartitions() const { return NumPartitions[ActiveFilter]; }
+	int32 GetMaxPartitions() const { return Filters[0].Num(); }
+	/** Bins per partition spectrum; bin k sits at k * SampleRate / (2 * BlockSize) Hz. */
+	int32 GetNumBins() const { return FFT.GetNumBins(); }
+	bool HasSpectralShaping() const { return ShapingSource.Num() > 0; }
+
+	/** Frames between a sample entering Process() and its first contribution leaving it. */
+	int32 GetLatency() const { return BlockSize; }
+
+	/**
+	 * Replaces the filter with IR (truncated to the MaxIRLength given to Init). Must be called from the thread that
+	 * calls Process(). Costs one forward FFT per partition and never allocates.
+	 * The input history is kept and the next block crossfades from the old filter to the new one, so audio already
+	 * inside the reverb tail carries on without a click. A prepared response the filter used is released here.
+	 */
+	void SetImpulseResponse(const float* IR, int32 IRLength);
+
+	/**
+	 * Does the FFTs of SetImpulseResponse() ahead of time for a convolver of InBlockSize-frame partitions, so a long IR
+	 * can be built away from the audio thread. Allocates; any thread.
+	 */
+	static FFrequenSeePreparedImpulseResponsePtr PrepareImpulseResponse(int32 InBlockSize, const float* IR, int32 IRLength);
+
+	/**
+	 * Makes Prepared the filter and crossfades to it like SetImpulseResponse(), without FFTs or copies: the convolver
+	 * points at Prepared's spectra (with spectral shaping, scales them into its own bank) and holds a reference while it
+	 * needs them. Prepared must have this convolver's block size; partitions beyond MaxIRPartitions or
+	 * GetMaxPartitions() are left out, so a shortened IR costs no new FFTs, and nullptr clears the filter. Returns the
+	 * response the convolver no longer uses, if any, so the caller decides where its last reference goes away. Same
+	 * thread as Process(); never allocates.
+	 */
+	FFrequenSeePreparedImpulseResponsePtr SetImpulseResponse(FFrequenSeePreparedImpulseResponsePtr Prepared, int32 MaxIRPartitions = MAX_int32);
+
+	/**
+	 * Multiplies the filter by a real gain per bin; NumGains must equal GetNumBins(), nullptr restores a flat
+	 * response. The gains stay applied to later impulse responses. Requires spectral shaping, same thread as
+	 * Process(), crossfades like SetImpulseResponse() and never allocates.
+	 */
+	void SetSpectralGains(const float* Gains, int32 NumGains);
+
+	/** Convolves NumFrames interleaved frames of GetNumChannels() channels. In and Out may point to the same buffer. */
+	void Process(const float* In, float* Out, int32 NumFrames);
+
+	/** Clears the input history (the reverb tail) and any staged audio without touching the filter. */
+	void Reset();
+
+private:
+	struct FChannelState
+	{
+		/** Previous block followed by the block being staged. */
+		FFrequenSeeAlignedFloats InputWindow;
+		/** Output of the last completed block, handed out while the next one is staged. */
+		FFrequenSeeAlignedFloats OutputBlock;
+		/** Ring of the most recent input block spectra; DelayLine[DelayLineHead] is the newest. */
+		TArray<FSplitComplexSpectrum> DelayLine;
+	};
+
+	/** Picks the bank to write a new filter into and schedules the crossfade to it. */
+	int32 BeginFilterUpdate();
+	/** Writes ShapingPointers' spectra * SpectralGains into Filters[FilterIndex]. */
+	void ApplySpectralGains(int32 FilterIndex);
+	void ProcessStagedBlock();
+	void RenderFilter(int32 FilterIndex, float* Out);
+
+	FFrequenSeeRealFFT FFT;
+	int32 BlockSize = 0;
+	int32 StagedFrames = 0;
+	int32 DelayLineHead = 0;
+
+	TArray<FChannelState> Channels;
+
+	/**
+	 * Two filter banks so a new IR can be faded in against the old one. Spectra are pre-scaled by 1 / FFTSize so the
+	 * inverse FFT needs no normalization pass.
+	 */
+	TArray<FSplitComplexSpectrum> Filters[2];
+	/** Point into Filters, or into BankResponses' spectra when a bank plays a prepared response as is. */
+	TArray<const FSplitComplexSpectrum*> FilterPointers[2];
+	FFrequenSeePreparedImpulseResponsePtr BankResponses[2];
+	int32 NumPartitions[2] = { 0, 0 };
+	int32 ActiveFilter = 0;
+	bool bCrossfadePending = false;
+
+	/** Unshaped partitions and the per-bin gain curve folded into the active bank; empty without spectral shaping. */
+	TArray<FSplitComplexSpectrum> ShapingSource;
+	FFrequenSeeAlignedFloats SpectralGains;
+	int32 ShapingSourcePartitions = 0;
+	/** The unshaped partitions the banks are scaled from: ShapingSource, or the spectra of ShapingResponse. */
+	TArray<const FSplitComplexSpectrum*> ShapingPointers;
+	FFrequenSeePreparedImpulseResponsePtr ShapingResponse;
+
+	/** Per-block pointer table into the delay line handed to the multiply-accumulate kernel. */
+	TArray<const FSplitComplexSpectrum*> InputPointers;
+
+	/** Zero-padded partition on the way in, inverse FFT result on the way out. */
+	FFrequenSeeAlignedFloats TimeScratch;
+	/** Output of the outgoing filter during a crossfade. */
+	FFrequenSeeAlignedFloats CrossfadeScratch;
+	FSplitComplexSpectrum Accumulator;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeSpectrum.h"
+
+struct kiss_fftr_state;
+
+/**
+ * Forward and inverse real-input FFT plans of one size, built on kiss_fftr and exchanging split-complex spectra.
+ * A plan owns scratch memory, so one instance must not be used from two threads at once.
+ */
+class FREQUENSEEDSP_API FFrequenSeeRealFFT
+{
+public:
+	FFrequenSeeRealFFT() = default;
+	explicit FFrequenSeeRealFFT(int32 InFFTSize);
+	~FFrequenSeeRealFFT();
+
+	FFrequenSeeRealFFT(const FFrequenSeeRealFFT&) = delete;
+	FFrequenSeeRealFFT& operator=(const FFrequenSeeRealFFT&) = delete;
+
+	/** (Re)builds the plans for an even InFFTSize. Allocates; does nothing if the size is unchanged. */
+	void Init(int32 InFFTSize);
+
+	bool IsInitialized() const { return FFTSize > 0; }
+	int32 GetFFTSize() const { return FFTSize; }
+	int32 GetNumBins() const { return FFTSize / 2 + 1; }
+
+	/** FFTSize time samples -> GetNumBins() bins. OutSpectrum must have been Init'ed with GetNumBins(). */
+	void Forward(const float* TimeData, FSplitComplexSpectrum& OutSpectrum);
+
+	/**
+	 * GetNumBins() bins -> FFTSize time samples.
+	 * Like kiss_fftri this is unnormalized: a forward/inverse round trip scales by FFTSize.
+	 */
+	void Inverse(const FSplitComplexSpectrum& Spectrum, float* OutTimeData);
+
+private:
+	void Release();
+
+	int32 FFTSize = 0;
+	kiss_fftr_state* ForwardCfg = nullptr;
+	kiss_fftr_state* InverseCfg = nullptr;
+
+	/** Interleaved bins handed to / received from kiss_fftr. */
+	FFrequenSeeAlignedFloats Scratch;
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Process-wide pool of 64-byte aligned slabs for the large buffers sources keep asking for in the same few sizes:
+ * impulse responses, convolver partitions and delay rings. Requests are rounded up to a power of two from
+ * SlabAlignment to MaxSlabBytes, and each of those sizes is a slab class with an intrusive free list, so a source that
+ * goes away hands its buffers straight to the next one of a similar shape instead of back to the heap. A class keeps
+ * at most MaxFreeBytesPerClass (and at least MinFreeSlabsPerClass) free; Release() hands anything beyond that back to
+ * the heap, as does Trim() for all free slabs. Larger requests bypass the free lists. Acquire() and Release() hold a
+ * short lock and may be called from any thread; Release() never allocates.
+ */
+class FREQUENSEEDSP_API FFrequenSeeSlabPool
+{
+public:
+	static constexpr SIZE_T SlabAlignment = 64;
+	static constexpr int32 NumClasses = 22;
+	static constexpr SIZE_T MaxSlabBytes = SlabAlignment << (NumClasses - 1);
+	static constexpr SIZE_T MaxFreeBytesPerClass = 4 * 1024 * 1024;
+	static constexpr int32 MinFreeSlabsPerClass = 2;
+
+	/** Size of the slab Acquire() returns for Bytes. */
+	static SIZE_T GetSlabBytes(SIZE_T Bytes)
+	{
+		return Bytes > MaxSlabBytes ? Align(Bytes, SlabAlignment) : FMath::Max(SlabAlignment, SIZE_T(FMath::RoundUpToPowerOfTwo64(Bytes)));
+	}
+
+	struct FClassStats
+	{
+		SIZE_T SlabBytes = 0;
+		int32 NumInUse = 0;
+		int32 NumFree = 0;
+		int32 HighWaterInUse = 0;
+	};
+
+	struct FStats
+	{
+		SIZE_T BytesInUse = 0;
+		SIZE_T BytesFree = 0;
+		SIZE_T HighWaterBytesInUse = 0;
+		/** Acquires served from a free list, and those that had to go to the heap. */
+		uint64 NumReused = 0;
+		uint64 NumHeapAllocations = 0;
+		/** Releases that found their class full, or were above MaxSlabBytes, and went straight back to the heap. */
+		uint64 NumHeapFrees = 0;
+		/** Classes that were ever used. */
+		TArray<FClassStats> Classes;
+	};
+
+	static FFrequenSeeSlabPool& Get();
+
+	/** Returns a slab of at least Bytes (which must be non-zero) and its actual size in OutSlabBytes. */
+	void* Acquire(SIZE_T Bytes, SIZE_T& OutSlabBytes);
+
+	/** Hands back a slab from Acquire() along with the size it reported. */
+	void Release(void* Slab, SIZE_T SlabBytes);
+
+	/** Returns every free slab to the heap. Slabs in use are unaffected. */
+	void Trim();
+
+	FStats GetStats() const;
+
+private:
+	FFrequenSeeSlabPool() = default;
+
+	struct FFreeSlab
+	{
+		FFreeSlab* Next;
+	};
+
+	struct FSlabClass
+	{
+		FFreeSlab* FreeList = nullptr;
+		int32 NumInUse = 0;
+		int32 NumFree = 0;
+		int32 HighWaterInUse = 0;
+	};
+
+	/** Class of a slab GetSlabBytes() returned, or INDEX_NONE above MaxSlabBytes. */
+	static int32 GetClassIndex(SIZE_T SlabBytes)
+	{
+		return SlabBytes > MaxSlabBytes ? INDEX_NONE : int32(FMath::FloorLog2_64(SlabBytes) - FMath::FloorLog2_64(SlabAlignment));
+	}
+	static SIZE_T GetClassSlabBytes(int32 ClassIndex) { return SlabAlignment << ClassIndex; }
+	static int32 GetMaxFreeSlabs(int32 ClassIndex)
+	{
+		return FMath::Max(int32(MaxFreeBytesPerClass / GetClassSlabBytes(ClassIndex)), MinFreeSlabsPerClass);
+	}
+
+	mutable FCriticalSection Lock;
+	FSlabClass Classes[NumClasses];
+	SIZE_T BytesInUse = 0;
+	SIZE_T BytesFree = 0;
+	SIZE_T HighWaterBytesInUse = 0;
+	uint64 NumReused = 0;
+	uint64 NumHeapAllocations = 0;
+	uint64 NumHeapFrees = 0;
+};
+
+/**
+ * TArray allocator that takes its storage from FFrequenSeeSlabPool, 64-byte aligned. Meant for buffers that are sized
+ * once and then reused: capacity is whatever fits the power-of-two slab the request rounds up to.
+ */
+class FFrequenSeePooledAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType
+	{
+	public:
+		ForAnyElementType() = default;
+		ForAnyElementType(const ForAnyElementType&) = delete;
+		ForAnyElementType& operator=(const ForAnyElementType&) = delete;
+
+		~ForAnyElementType()
+		{
+			if (Data)
+			{
+				FFrequenSeeSlabPool::Get().Release(Data, SlabBytes);
+			}
+		}
+
+		void MoveToEmpty(ForAnyElementType& Other)
+		{
+			checkSlow(this != &Other);
+			if (Data)
+			{
+				FFrequenSeeSlabPool::Get().Release(Data, SlabBytes);
+			}
+			Data = Other.Data;
+			SlabBytes = Other.SlabBytes;
+			Other.Data = nullptr;
+			Other.SlabBytes = 0;
+		}
+
+		FScriptContainerElement* GetAllocation() const { return Data; }
+
+		void ResizeAllocation(SizeType CurrentNum, SizeType NewMax, SIZE_T NumBytesPerElement)
+		{
+			const SIZE_T NewBytes = SIZE_T(NewMax) * NumBytesPerElement;
+			if (Data && NewBytes > 0 && FFrequenSeeSlabPool::GetSlabBytes(NewBytes) == SlabBytes)
+			{
+				return;
+			}
+
+			FScriptContainerElement* NewData = nullptr;
+			SIZE_T NewSlabBytes = 0;
+			if (NewBytes > 0)
+			{
+				NewData = static_cast<FScriptContainerElement*>(FFrequenSeeSlabPool::Get().Acquire(NewBytes, NewSlabBytes));
+			}
+			if (Data)
+			{
+				if (NewData && CurrentNum > 0)
+				{
+					FMemory::Memcpy(NewData, Data, FMath::Min(SIZE_T(CurrentNum) * NumBytesPerElement, NewBytes));
+				}
+				FFrequenSeeSlabPool::Get().Release(Data, SlabBytes);
+			}
+			Data = NewData;
+			SlabBytes = NewSlabBytes;
+		}
+
+		SizeType CalculateSlackReserve(SizeType NewMax, SIZE_T NumBytesPerElement) const
+		{
+			return SlabCapacity(NewMax, NumBytesPerElement);
+		}
+
+		SizeType CalculateSlackShrink(SizeType NewMax, SizeType CurrentMax, SIZE_T NumBytesPerElement) const
+		{
+			return SlabCapacity(NewMax, NumBytesPerElement);
+		}
+
+		SizeType CalculateSlackGrow(SizeType NewMax, SizeType CurrentMax, SIZE_T NumBytesPerElement) const
+		{
+			return SlabCapacity(NewMax, NumBytesPerElement);
+		}
+
+		SIZE_T GetAllocatedSize(SizeType CurrentMax, SIZE_T NumBytesPerElement) const { return SlabBytes; }
+
+		bool HasAllocation() const { return Data != nullptr; }
+
+		SizeType GetInitialCapacity() const { return 0; }
+
+	private:
+		/** Elements that fit the slab NewMax elements round up to. */
+		static SizeType SlabCapacity(SizeType NewMax, SIZE_T NumBytesPerElement)
+		{
+			return NewMax > 0 ? SizeType(FMath::Min(FFrequenSeeSlabPool::GetSlabBytes(SIZE_T(NewMax) * NumBytesPerElement) / NumBytesPerElement, SIZE_T(MAX_int32))) : 0;
+		}
+
+		FScriptContainerElement* Data = nullptr;
+		SIZE_T SlabBytes = 0;
+	};
+
+	template <typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		ElementType* GetAllocation() const { return (ElementType*)ForAnyElementType::GetAllocation(); }
+	};
+};
+
+template <>
+struct TAllocatorTraits<FFrequenSeePooledAllocator> : TAllocatorTraitsBase<FFrequenSeePooledAllocator>
+{
+	enum { SupportsMove = true };
+	enum { IsZeroConstruct = true };
+};
+
+/** Float storage aligned to a cache line so spectra can be streamed with full-width aligned SIMD loads; pooled. */
+using FFrequenSeeAlignedFloats = TArray<float, FFrequenSeePooledAllocator>;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeSpectrum.h"
+
+/** One arrival of a sparse FIR: a gain at a possibly fractional delay. */
+struct FFrequenSeeSparseTap
+{
+	float DelayFrames = 0.0f;
+	float Gain = 0.0f;
+};
+
+/**
+ * Sparse FIR for discrete early reflections: a handful of taps at arbitrary delays read from one input history.
+ *
+ * Each tap is a third-order Lagrange fractional delay, so arrivals land at sub-sample accurate times without the
+ * smearing of a binned impulse response, and costs four multiply-adds per frame regardless of its delay. The history
+ * is stored twice back to back, so every tap reads one contiguous span per call. An optional dense head of up to
+ * MaxHeadFrames covers the start of a sampled impulse response that a block convolver can only deliver late. A new tap
+ * set or head is crossfaded in over CrossfadeFrames. Everything is allocated in Init(); the rest is real-time safe.
+ */
+class FREQUENSEEDSP_API FFrequenSeeSparseTapFilter
+{
+public:
+	static constexpr int32 MaxTaps = 32;
+	static constexpr int32 CrossfadeFrames = 256;
+	static constexpr int32 MaxHeadFrames = 512;
+
+	/** Allocates history for delays up to InMaxDelayFrames and Process() calls of up to InMaxBlockFrames. */
+	void Init(int32 InMaxDelayFrames, int32 InMaxBlockFrames);
+
+	bool IsInitialized() const { return HistorySize > 0; }
+	int32 GetMaxDelayFrames() const { return MaxDelayFrames; }
+
+	/**
+	 * Replaces the taps. Delays are clamped to [1, GetMaxDelayFrames()], taps beyond MaxTaps are dropped and nullptr
+	 * clears the filter. Same thread as Process(); never allocates.
+	 */
+	void SetTaps(const FFrequenSeeSparseTap* Taps, int32 NumTaps);
+
+	/**
+	 * Replaces the dense head: Head[k] is applied at a delay of exactly k frames, starting at 0. Frames beyond
+	 * MaxHeadFrames are dropped and nullptr clears the head. Same thread as Process(); never allocates.
+	 */
+	void SetHead(const float* Head, int32 NumFrames);
+
+	/** Writes the sum of all taps and the head for NumFrames mono frames. In and Out may point to the same buffer. */
+	void Process(const float* In, float* Out, int32 NumFrames);
+
+	/** Clears the input history, the taps and the head. */
+	void Reset();
+
+private:
+	/** Integer delays and Lagrange coefficients (gain folded in) of one tap set, plus the head's nonzero span. */
+	struct FTapSet
+	{
+		int32 NumTaps = 0;
+		int32 Delays[MaxTaps];
+		float Coefficients[MaxTaps][4];
+		int32 HeadStart = 0;
+		int32 HeadEnd = 0;
+		float Head[MaxHeadFrames];
+	};
+
+	/** Makes the set an update writes to, copying the current one forward so a tap update keeps the head and vice versa. */
+	FTapSet& BeginUpdate();
+
+	/** Adds Set's output, scaled by a linear ramp from StartGain in steps of GainStep, to Out. */
+	void AccumulateTaps(const FTapSet& Set, int32 BlockStart, float* Out, int32 NumFrames, float StartGain, float GainStep) const;
+
+	int32 MaxDelayFrames = 0;
+	int32 MaxBlockFrames = 0;
+
+	/** Power-of-two ring, stored twice: History[i] == History[i + HistorySize]. */
+	FFrequenSeeAlignedFloats History;
+	int32 HistorySize = 0;
+	int32 WritePosition = 0;
+
+	FTapSet TapSets[2];
+	int32 ActiveSet = 0;
+	/** Frames left in the crossfade from TapSets[1 - ActiveSet] to TapSets[ActiveSet]. */
+	int32 CrossfadeRemaining = 0;
+};
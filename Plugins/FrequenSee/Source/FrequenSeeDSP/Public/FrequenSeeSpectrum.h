@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrequenSeeSlabPool.h"
+
+/**
+ * A spectrum stored as split real / imaginary planes (SoA) instead of interleaved kiss_fft_cpx pairs.
+ * The planes are padded up to a multiple of FrequenSeeSpectrum::BinAlignment bins and the padding is kept at
+ * zero, so the kernels below never need a scalar tail loop.
+ */
+struct FREQUENSEEDSP_API FSplitComplexSpectrum
+{
+	FFrequenSeeAlignedFloats Real;
+	FFrequenSeeAlignedFloats Imag;
+
+	/** Allocates (and zeroes) storage for InNumBins bins. Not real-time safe. */
+	void Init(int32 InNumBins);
+
+	/** Zeroes all bins, including the padding. */
+	void Zero();
+
+	int32 GetNumBins() const { return NumBins; }
+	int32 GetPaddedNumBins() const { return Real.Num(); }
+
+	/** Copies from interleaved (r, i) pairs, e.g. the output of kiss_fftr. */
+	void FromInterleaved(const float* Interleaved);
+
+	/** Copies to interleaved (r, i) pairs, e.g. the input of kiss_fftri. */
+	void ToInterleaved(float* Interleaved) const;
+
+private:
+	int32 NumBins = 0;
+};
+
+namespace FrequenSeeSpectrum
+{
+	/** Bin count granularity of FSplitComplexSpectrum storage (one 64-byte line of floats). */
+	constexpr int32 BinAlignment = 16;
+
+	/** Out = A * B, bin by bin. All spectra must have the same bin count. */
+	FREQUENSEEDSP_API void Multiply(const FSplitComplexSpectrum& A, const FSplitComplexSpectrum& B, FSplitComplexSpectrum& Out);
+
+	/**
+	 * Out = (Out +) sum over p of A[p] * B[p].
+	 * Walks the bins once and keeps the running sum in registers while it visits every pair, so the output
+	 * spectrum is read and written exactly once no matter how many partitions are summed.
+	 * All spectra must have the same bin count and Out must not alias any input. Real-time safe.
+	 */
+	FREQUENSEEDSP_API void MultiplyAccumulate(const FSplitComplexSpectrum* const* A, const FSplitComplexSpectrum* const* B,
+	                                       int32 NumPairs, FSplitComplexSpectrum& Out, bool bAccumulate);
+
+	/**
+	 * Outs[k] = In * Gains[k] for NumOutputs real per-bin gain curves, reading In only once.
+	 * Each curve must hold In.GetPaddedNumBins() 64-byte aligned, finite floats. Outs[k] may alias In only when
+	 * NumOutputs == 1. Real-time safe.
+	 */
+	FREQUENSEEDSP_API void MultiplyByGains(const FSplitComplexSpectrum& In, const float* const* Gains,
+	                                       FSplitComplexSpectrum* const* Outs, int32 NumOutputs);
+
+	/**
+	 * Expands NumBands band gains with the given (ascending) centre frequencies to NumBins per-bin gains, bin k being
+	 * at k * BinWidthHz. Interpolates linearly over log frequency between centres and holds the end values outside.
+	 */
+	FREQUENSEEDSP_API void InterpolateBandGains(const float* BandGains, const float* BandCentersHz, int32 NumBands,
+	                                            float BinWidthHz, float* OutGains, int32 NumBins);
+
+	/** Name of the kernel variant compiled into this build, for logs and benchmarks. */
+	FREQUENSEEDSP_API const TCHAR* GetKernelName();
+}
@@ -0,0 +1,189 @@
+// Reproducible benchmarks of the FrequenSee simulation core: subpath tracing, connection, path evaluation, image sources
+// and impulse response synthesis on procedural scenes, written as JSON so results can be recorded per commit and compared.
+//
+//   FrequenSeeBench [--scene shoebox|corridor|cluttered] [--rays n] [--repeat n] [--seed n] [--commit id] [-o out.json]
+//
+// The audio-thread side (partitioned convolver, FDN, circular buffers) runs on engine types and is benchmarked in the
+// editor with FrequenSee.Bench.Json, which writes the same format.
+//
+// Exits with 1 when the tracer fails the analytic shoebox validation; the results are still written.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FrequenSeeBenchmark.h"
+
+using namespace FrequenSeeCore;
+
+namespace
+{
+	struct FOptions
+	{
+		std::vector<ECannedScene> Scenes;
+		FTracerBenchmarkSettings Benchmark;
+		std::string CommitId;
+		std::string OutputPath;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: FrequenSeeBench [options]\n"
+			"  --scene <name>                shoebox, corridor or cluttered; repeatable (all)\n"
+			"  --rays <n>                    subpath pairs per trace (1000)\n"
+			"  --repeat <n>                  runs per scene, timings are the median (5)\n"
+			"  --seed <n>                    random seed of the first run (1)\n"
+			"  --sampler <random|sobol>      direction sampling of the traced subpaths (sobol)\n"
+			"  --commit <id>                 recorded in the output's context, e.g. $(git rev-parse HEAD)\n"
+			"  -o, --output <file.json>      results path (stdout)\n");
+	}
+
+	bool ParseScene(const std::string& Name, ECannedScene& OutScene)
+	{
+		for (int32_t Index = 0; Index < NumCannedScenes; ++Index)
+		{
+			if (Name == GetCannedSceneName(static_cast<ECannedScene>(Index)))
+			{
+				OutScene = static_cast<ECannedScene>(Index);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ParseOptions(int ArgCount, char** Args, FOptions& Options)
+	{
+		for (int Index = 1; Index < ArgCount; ++Index)
+		{
+			const std::string Arg = Args[Index];
+			if (Arg == "-h" || Arg == "--help")
+			{
+				return false;
+			}
+			if (Index + 1 >= ArgCount)
+			{
+				std::fprintf(stderr, "%s needs a value\n", Arg.c_str());
+				return false;
+			}
+
+			const std::string Value = Args[++Index];
+			bool bValid = true;
+			if (Arg == "--scene")
+			{
+				ECannedScene Scene;
+				bValid = ParseScene(Value, Scene);
+				Options.Scenes.push_back(Scene);
+			}
+			else if (Arg == "--rays")
+			{
+				Options.Benchmark.NumRays = std::atoi(Value.c_str());
+				bValid = Options.Benchmark.NumRays > 0;
+			}
+			else if (Arg == "--repeat")
+			{
+				Options.Benchmark.Repetitions = std::atoi(Value.c_str());
+				bValid = Options.Benchmark.Repetitions > 0;
+			}
+			else if (Arg == "--seed")
+			{
+				Options.Benchmark.Seed = std::strtoull(Value.c_str(), nullptr, 10);
+			}
+			else if (Arg == "--sampler")
+			{
+				bValid = Value == "random" || Value == "sobol";
+				Options.Benchmark.SamplePattern = Value == "random" ? ESamplePattern::Random : ESamplePattern::Sobol;
+			}
+			else if (Arg == "--commit")
+			{
+				Options.CommitId = Value;
+			}
+			else if (Arg == "-o" || Arg == "--output")
+			{
+				Options.OutputPath = Value;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", Arg.c_str());
+				return false;
+			}
+
+			if (!bValid)
+			{
+				std::fprintf(stderr, "Invalid value for %s: %s\n", Arg.c_str(), Value.c_str());
+				return false;
+			}
+		}
+
+		if (Options.Scenes.empty())
+		{
+			for (int32_t Index = 0; Index < NumCannedScenes; ++Index)
+			{
+				Options.Scenes.push_back(static_cast<ECannedScene>(Index));
+			}
+		}
+		return true;
+	}
+}
+
+int main(int ArgCount, char** Args)
+{
+	FOptions Options;
+	if (!ParseOptions(ArgCount, Args, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<FBenchmarkMetric> Metrics;
+	for (const ECannedScene Scene : Options.Scenes)
+	{
+		std::fprintf(stderr, "Benchmarking %s...\n", GetCannedSceneName(Scene));
+		RunTracerBenchmark(Scene, Options.Benchmark, Metrics);
+		RunImageSourceBenchmark(Scene, Options.Benchmark, FImageSourceSettings(), Metrics);
+	}
+	std::fprintf(stderr, "Validating against the analytic shoebox decay...\n");
+	const bool bBidirectionalValid = RunShoeboxValidation(Options.Benchmark, EPathEstimator::Bidirectional, Metrics);
+	const bool bDiffuseRainValid = RunShoeboxValidation(Options.Benchmark, EPathEstimator::DiffuseRain, Metrics);
+	if (!bBidirectionalValid || !bDiffuseRainValid)
+	{
+		std::fprintf(stderr, "Shoebox validation failed for%s%s, see validation.*_error\n", bBidirectionalValid ? "" : " bdpt",
+		             bDiffuseRainValid ? "" : " rain");
+	}
+	const int ExitCode = bBidirectionalValid && bDiffuseRainValid ? 0 : 1;
+
+	std::vector<std::pair<std::string, std::string>> Context;
+	Context.emplace_back("suite", "FrequenSeeBench");
+	if (!Options.CommitId.empty())
+	{
+		Context.emplace_back("commit", Options.CommitId);
+	}
+#ifdef NDEBUG
+	Context.emplace_back("build", "release");
+#else
+	Context.emplace_back("build", "debug");
+#endif
+	Context.emplace_back("rays", std::to_string(Options.Benchmark.NumRays));
+	Context.emplace_back("repetitions", std::to_string(Options.Benchmark.Repetitions));
+	Context.emplace_back("seed", std::to_string(Options.Benchmark.Seed));
+	Context.emplace_back("sampler", Options.Benchmark.SamplePattern == ESamplePattern::Random ? "random" : "sobol");
+	const std::string Json = FormatBenchmarkJson(Context, Metrics);
+
+	if (Options.OutputPath.empty())
+	{
+		std::fputs(Json.c_str(), stdout);
+		return ExitCode;
+	}
+
+	std::ofstream File(Options.OutputPath, std::ios::binary);
+	if (!File.write(Json.data(), static_cast<std::streamsize>(Json.size())))
+	{
+		std::fprintf(stderr, "Cannot write %s\n", Options.OutputPath.c_str());
+		return 1;
+	}
+	std::fprintf(stderr, "Wrote %s\n", Options.OutputPath.c_str());
+	return ExitCode;
+}
@@ -0,0 +1,564 @@
+// Headless driver for the FrequenSee simulation core: traces a triangle-mesh scene between source and listener
+// positions and writes the impulse responses as mono 32-bit float WAV files.
+//
+//   FrequenSeeCLI scene.obj --source x,y,z [--source x,y,z ...] --listener x,y,z [options]
+//
+// The scene is a Wavefront OBJ (v, f and usemtl are read, everything else is skipped). Positions are in the scene's
+// units; the defaults match the plugin, i.e. an OBJ exported from the level in Unreal centimetres traces like the game.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrequenSeeImageSources.h"
+#include "FrequenSeeImpulseSynthesis.h"
+#include "FrequenSeePathTracer.h"
+#include "FrequenSeeTriangleScene.h"
+
+using namespace FrequenSeeCore;
+
+namespace
+{
+	// Same as FAudioOcclusionParams::MaxReflectionTapDelaySeconds, so the early window is rendered like the plugin's
+	constexpr float EarlyWindowSeconds = 0.08f;
+
+	struct FOptions
+	{
+		std::string ScenePath;
+		std::vector<FVec3> Sources;
+		FVec3 Listener;
+		bool bHasListener = false;
+		std::string OutputPath = "ir.wav";
+		std::string EnergyPath;
+		uint64_t Seed = 1;
+		int32_t NumThreads = 1;
+		float DurationSeconds = 1.0f;
+		int32_t SampleRate = 48000;
+		float BinMs = 1.0f;
+		FTracerSettings Tracer;
+		FImageSourceSettings ImageSources;
+		std::map<std::string, std::vector<float>> MaterialAbsorption;
+		std::vector<float> DefaultAbsorption;
+		float Scattering = 0.0f;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: FrequenSeeCLI <scene.obj> --source x,y,z [--source x,y,z ...] --listener x,y,z [options]\n"
+			"  -o, --output <file.wav>       impulse response path; several sources get _<index> appended (ir.wav)\n"
+			"  --energy <file.csv>           also write the energy histograms, broadband and per band\n"
+			"  --rays <n>                    subpath pairs per source (1000)\n"
+			"  --seed <n>                    random seed; equal seeds give identical output (1)\n"
+			"  --sampler <random|sobol>      direction sampling: independent or Owen-scrambled Sobol (sobol)\n"
+			"  --estimator <bdpt|rain>       bidirectional subpath connections or diffuse rain to the listener (bdpt)\n"
+			"  --listener-radius <units>     radius of the listener sphere diffuse rain connects to (50)\n"
+			"  --threads <n>                 threads tracing each source's rays; output does not depend on it (1)\n"
+			"  --duration <seconds>          impulse response length (1.0)\n"
+			"  --rate <hz>                   impulse response sample rate (48000)\n"
+			"  --bin-ms <ms>                 energy histogram bin width (1.0)\n"
+			"  --meters-per-unit <f>         scene units to metres for propagation (0.001, as the plugin)\n"
+			"  --surface-offset <units>      how far bounces start off the surface (0.1)\n"
+			"  --image-order <n>             render specular reflections up to this order with image sources (0: off)\n"
+			"  --material <name>=a,b,c       absorption per band of the OBJ material <name>\n"
+			"  --default-material a,b,c      absorption of faces without a --material (none: no material)\n"
+			"  --scattering <f>              scattering coefficient of every --material and --default-material (0)\n");
+	}
+
+	bool ParseFloats(const std::string& Text, std::vector<float>& OutValues)
+	{
+		OutValues.clear();
+		std::stringstream Stream(Text);
+		std::string Item;
+		while (std::getline(Stream, Item, ','))
+		{
+			char* End = nullptr;
+			const float Value = std::strtof(Item.c_str(), &End);
+			if (End == Item.c_str() || *End != '\0')
+			{
+				return false;
+			}
+			OutValues.push_back(Value);
+		}
+		return !OutValues.empty();
+	}
+
+	bool ParseVector(const std::string& Text, FVec3& OutVector)
+	{
+		std::vector<float> Values;
+		if (!ParseFloats(Text, Values) || Values.size() != 3)
+		{
+			return false;
+		}
+		OutVector = FVec3(Values[0], Values[1], Values[2]);
+		return true;
+	}
+
+	bool ParseOptions(int ArgCount, char** Args, FOptions& Options)
+	{
+		// Image sources only run when asked for, so the default output stays the tracer's alone
+		Options.ImageSources.MaxOrder = 0;
+		for (int Index = 1; Index < ArgCount; ++Index)
+		{
+			const std::string Arg = Args[Index];
+			if (Arg.empty() || Arg[0] != '-')
+			{
+				if (!Options.ScenePath.empty())
+				{
+					std::fprintf(stderr, "More than one scene given: %s\n", Arg.c_str());
+					return false;
+				}
+				Options.ScenePath = Arg;
+				continue;
+			}
+			if (Arg == "-h" || Arg == "--help")
+			{
+				return false;
+			}
+			if (Index + 1 >= ArgCount)
+			{
+				std::fprintf(stderr, "%s needs a value\n", Arg.c_str());
+				return false;
+			}
+
+			const std::string Value = Args[++Index];
+			bool bValid = true;
+			if (Arg == "--source")
+			{
+				FVec3 Source;
+				bValid = ParseVector(Value, Source);
+				Options.Sources.push_back(Source);
+			}
+			else if (Arg == "--listener")
+			{
+				bValid = ParseVector(Value, Options.Listener);
+				Options.bHasListener = true;
+			}
+			else if (Arg == "-o" || Arg == "--output")
+			{
+				Options.OutputPath = Value;
+			}
+			else if (Arg == "--energy")
+			{
+				Options.EnergyPath = Value;
+			}
+			else if (Arg == "--rays")
+			{
+				Options.Tracer.NumRays = std::atoi(Value.c_str());
+				bValid = Options.Tracer.NumRays > 0;
+			}
+			else if (Arg == "--seed")
+			{
+				Options.Seed = std::strtoull(Value.c_str(), nullptr, 10);
+			}
+			else if (Arg == "--sampler")
+			{
+				bValid = Value == "random" || Value == "sobol";
+				Options.Tracer.SamplePattern = Value == "random" ? ESamplePattern::Random : ESamplePattern::Sobol;
+			}
+			else if (Arg == "--estimator")
+			{
+				bValid = Value == "bdpt" || Value == "rain";
+				Options.Tracer.Estimator = Value == "rain" ? EPathEstimator::DiffuseRain : EPathEstimator::Bidirectional;
+			}
+			else if (Arg == "--listener-radius")
+			{
+				Options.Tracer.ListenerRadius = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.Tracer.ListenerRadius > 0.0f;
+			}
+			else if (Arg == "--threads")
+			{
+				Options.NumThreads = std::atoi(Value.c_str());
+				bValid = Options.NumThreads > 0;
+			}
+			else if (Arg == "--duration")
+			{
+				Options.DurationSeconds = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.DurationSeconds > 0.0f;
+			}
+			else if (Arg == "--rate")
+			{
+				Options.SampleRate = std::atoi(Value.c_str());
+				bValid = Options.SampleRate > 0;
+			}
+			else if (Arg == "--bin-ms")
+			{
+				Options.BinMs = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.BinMs > 0.0f;
+			}
+			else if (Arg == "--meters-per-unit")
+			{
+				Options.Tracer.MetersPerUnit = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.Tracer.MetersPerUnit > 0.0f;
+			}
+			else if (Arg == "--surface-offset")
+			{
+				Options.Tracer.SurfaceOffset = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.Tracer.SurfaceOffset >= 0.0f;
+			}
+			else if (Arg == "--image-order")
+			{
+				Options.ImageSources.MaxOrder = std::atoi(Value.c_str());
+				bValid = Options.ImageSources.MaxOrder >= 0;
+			}
+			else if (Arg == "--scattering")
+			{
+				Options.Scattering = std::strtof(Value.c_str(), nullptr);
+				bValid = Options.Scattering >= 0.0f && Options.Scattering <= 1.0f;
+			}
+			else if (Arg == "--material")
+			{
+				const size_t Equals = Value.find('=');
+				std::vector<float> Absorption;
+				bValid = Equals != std::string::npos && Equals > 0 && ParseFloats(Value.substr(Equals + 1), Absorption);
+				if (bValid)
+				{
+					Options.MaterialAbsorption[Value.substr(0, Equals)] = Absorption;
+				}
+			}
+			else if (Arg == "--default-material")
+			{
+				bValid = ParseFloats(Value, Options.DefaultAbsorption);
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", Arg.c_str());
+				return false;
+			}
+
+			if (!bValid)
+			{
+				std::fprintf(stderr, "Invalid value for %s: %s\n", Arg.c_str(), Value.c_str());
+				return false;
+			}
+		}
+
+		if (Options.ScenePath.empty() || Options.Sources.empty() || !Options.bHasListener)
+		{
+			std::fprintf(stderr, "A scene, at least one --source and a --listener are required\n");
+			return false;
+		}
+		Options.Tracer.ImageSourceOrder = Options.ImageSources.MaxOrder;
+		return true;
+	}
+
+	/** OBJ index (1-based, or negative from the end) to a 0-based one, -1 if out of range. */
+	int32_t ResolveIndex(const std::string& Token, int32_t NumVertices)
+	{
+		const int32_t Index = std::atoi(Token.c_str()); // stops at the first '/'
+		const int32_t Resolved = Index < 0 ? NumVertices + Index : Index - 1;
+		return Resolved >= 0 && Resolved < NumVertices ? Resolved : -1;
+	}
+
+	bool LoadObjScene(const FOptions& Options, FTriangleMeshScene& OutScene)
+	{
+		std::ifstream File(Options.ScenePath);
+		if (!File)
+		{
+			std::fprintf(stderr, "Cannot open %s\n", Options.ScenePath.c_str());
+			return false;
+		}
+
+		const int32_t DefaultMaterial = Options.DefaultAbsorption.empty()
+			? -1
+			: OutScene.AddMaterial(MakeSurfaceResponse(Options.DefaultAbsorption.data(), static_cast<int32_t>(Options.DefaultAbsorption.size()), Options.Scattering));
+		std::map<std::string, int32_t> Materials;
+		for (const auto& Entry : Options.MaterialAbsorption)
+		{
+			Materials[Entry.first] = OutScene.AddMaterial(MakeSurfaceResponse(Entry.second.data(), static_cast<int32_t>(Entry.second.size()), Options.Scattering));
+		}
+
+		std::vector<FVec3> Vertices;
+		int32_t CurrentMaterial = DefaultMaterial;
+		std::string Line;
+		int32_t LineNumber = 0;
+		while (std::getline(File, Line))
+		{
+			++LineNumber;
+			std::istringstream Stream(Line);
+			std::string Keyword;
+			Stream >> Keyword;
+			if (Keyword == "v")
+			{
+				FVec3 Vertex;
+				if (!(Stream >> Vertex.X >> Vertex.Y >> Vertex.Z))
+				{
+					std::fprintf(stderr, "%s:%d: malformed vertex\n", Options.ScenePath.c_str(), LineNumber);
+					return false;
+				}
+				Vertices.push_back(Vertex);
+			}
+			else if (Keyword == "f")
+			{
+				std::vector<int32_t> Face;
+				std::string Token;
+				while (Stream >> Token)
+				{
+					const int32_t Index = ResolveIndex(Token, static_cast<int32_t>(Vertices.size()));
+					if (Index < 0)
+					{
+						std::fprintf(stderr, "%s:%d: face index %s out of range\n", Options.ScenePath.c_str(), LineNumber, Token.c_str());
+						return false;
+					}
+					Face.push_back(Index);
+				}
+				// Polygons are fanned into triangles
+				for (size_t Corner = 2; Corner < Face.size(); ++Corner)
+				{
+					OutScene.AddTriangle(Vertices[Face[0]], Vertices[Face[Corner - 1]], Vertices[Face[Corner]], CurrentMaterial);
+				}
+			}
+			else if (Keyword == "usemtl")
+			{
+				std::string Name;
+				Stream >> Name;
+				const auto Found = Materials.find(Name);
+				CurrentMaterial = Found != Materials.end() ? Found->second : DefaultMaterial;
+			}
+		}
+
+		if (OutScene.NumTriangles() == 0)
+		{
+			std::fprintf(stderr, "%s has no faces\n", Options.ScenePath.c_str());
+			return false;
+		}
+		OutScene.Build();
+		return true;
+	}
+
+	void WriteLittleEndian(std::ofstream& File, uint32_t Value, int32_t NumBytes)
+	{
+		for (int32_t Byte = 0; Byte < NumBytes; ++Byte)
+		{
+			File.put(static_cast<char>((Value >> (8 * Byte)) & 0xFF));
+		}
+	}
+
+	bool WriteWav(const std::string& Path, const std::vector<float>& Samples, int32_t SampleRate)
+	{
+		std::ofstream File(Path, std::ios::binary);
+		if (!File)
+		{
+			return false;
+		}
+
+		const uint32_t DataBytes = static_cast<uint32_t>(Samples.size() * sizeof(float));
+		File.write("RIFF", 4);
+		WriteLittleEndian(File, 36 + DataBytes, 4);
+		File.write("WAVEfmt ", 8);
+		WriteLittleEndian(File, 16, 4);
+		WriteLittleEndian(File, 3, 2); // IEEE float
+		WriteLittleEndian(File, 1, 2); // mono
+		WriteLittleEndian(File, static_cast<uint32_t>(SampleRate), 4);
+		WriteLittleEndian(File, static_cast<uint32_t>(SampleRate) * sizeof(float), 4);
+		WriteLittleEndian(File, sizeof(float), 2);
+		WriteLittleEndian(File, 32, 2);
+		File.write("data", 4);
+		WriteLittleEndian(File, DataBytes, 4);
+		for (float Sample : Samples)
+		{
+			uint32_t Bits = 0;
+			std::memcpy(&Bits, &Sample, sizeof(Bits));
+			WriteLittleEndian(File, Bits, 4);
+		}
+		return static_cast<bool>(File);
+	}
+
+	bool WriteEnergyCsv(const std::string& Path, const std::vector<float>& Energy,
+	                    const std::vector<float> (&BandEnergy)[BandCount], float BinSeconds)
+	{
+		std::ofstream File(Path);
+		if (!File)
+		{
+			return false;
+		}
+		File << "time_s,energy";
+		for (int32_t Band = 0; Band < BandCount; ++Band)
+		{
+			File << ",band" << Band;
+		}
+		File << '\n';
+		for (size_t Bin = 0; Bin < Energy.size(); ++Bin)
+		{
+			File << Bin * BinSeconds << ',' << Energy[Bin];
+			for (int32_t Band = 0; Band < BandCount; ++Band)
+			{
+				File << ',' << BandEnergy[Band][Bin];
+			}
+			File << '\n';
+		}
+		return static_cast<bool>(File);
+	}
+
+	/** OutputPath for a single source, with _<Index> before the extension when there are several. */
+	std::string OutputPathFor(const std::string& OutputPath, size_t Index, size_t NumSources)
+	{
+		if (NumSources == 1)
+		{
+			return OutputPath;
+		}
+		const size_t Dot = OutputPath.find_last_of('.');
+		const size_t Slash = OutputPath.find_last_of("/\\");
+		const bool bHasExtension = Dot != std::string::npos && (Slash == std::string::npos || Dot > Slash);
+		const std::string Suffix = "_" + std::to_string(Index);
+		return bHasExtension ? OutputPath.substr(0, Dot) + Suffix + OutputPath.substr(Dot) : OutputPath + Suffix;
+	}
+}
+
+int main(int ArgCount, char** Args)
+{
+	FOptions Options;
+	if (!ParseOptions(ArgCount, Args, Options))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	FTriangleMeshScene Scene;
+	if (!LoadObjScene(Options, Scene))
+	{
+		return 1;
+	}
+	std::printf("%s: %d triangles\n", Options.ScenePath.c_str(), Scene.NumTriangles());
+
+	FImageSourceSolver ImageSources;
+	if (Options.ImageSources.MaxOrder > 0)
+	{
+		std::vector<FReflector> Reflectors;
+		AppendTriangleReflectors(Scene, Reflectors);
+		ImageSources.SetReflectors(Reflectors);
+		std::printf("%d reflector planes for image sources up to order %d\n", ImageSources.NumReflectors(), Options.ImageSources.MaxOrder);
+	}
+
+	FImpulseResponseLayout Layout;
+	Layout.SampleRate = static_cast<float>(Options.SampleRate);
+	Layout.BinSeconds = Options.BinMs * 0.001f;
+	Layout.NumBins = static_cast<int32_t>(std::ceil(Options.DurationSeconds / Layout.BinSeconds));
+	Layout.NumSamples = static_cast<int32_t>(std::ceil(Options.DurationSeconds * Layout.SampleRate));
+	Layout.EarlySeconds = EarlyWindowSeconds;
+
+	FPathBatch Paths;
+	std::vector<FPathBatch> ChunkPaths(Options.NumThreads);
+	std::vector<std::thread> Threads;
+	FArrivalList Arrivals;
+	std::vector<float> Energy(Layout.NumBins);
+	std::vector<float> BandEnergy[BandCount];
+	float* BandData[BandCount];
+	for (int32_t Band = 0; Band < BandCount; ++Band)
+	{
+		BandEnergy[Band].resize(Layout.NumBins);
+		BandData[Band] = BandEnergy[Band].data();
+	}
+	std::vector<float> ImpulseResponse(Layout.NumSamples);
+
+	for (size_t SourceIndex = 0; SourceIndex < Options.Sources.size(); ++SourceIndex)
+	{
+		const auto StartTime = std::chrono::steady_clock::now();
+
+		// Every source gets its own trace, so adding a source does not change the others' output
+		const uint64_t Seed = FRandom(Options.Seed, SourceIndex).NextUInt64();
+		Paths.Reset();
+		if (Options.NumThreads == 1)
+		{
+			TracePaths(Scene, Options.Tracer, Options.Sources[SourceIndex], Options.Listener, Seed, Paths);
+		}
+		else
+		{
+			// One contiguous range of rays per thread, appended in ray order
+			const int32_t NumRays = Options.Tracer.NumRays;
+			for (int32_t Chunk = 0; Chunk < Options.NumThreads; ++Chunk)
+			{
+				const int32_t FirstRay = static_cast<int32_t>(static_cast<int64_t>(NumRays) * Chunk / Options.NumThreads);
+				const int32_t EndRay = static_cast<int32_t>(static_cast<int64_t>(NumRays) * (Chunk + 1) / Options.NumThreads);
+				ChunkPaths[Chunk].Reset();
+				Threads.emplace_back([&, Chunk, FirstRay, EndRay]()
+				{
+					TraceRays(Scene, Options.Tracer, Options.Sources[SourceIndex], Options.Listener, Seed, FirstRay,
+					          EndRay - FirstRay, ChunkPaths[Chunk]);
+				});
+			}
+			for (std::thread& Thread : Threads)
+			{
+				Thread.join();
+			}
+			Threads.clear();
+			for (const FPathBatch& Chunk : ChunkPaths)
+			{
+				AppendPaths(Chunk, Paths);
+			}
+		}
+
+		// Normalized by the ray count like the plugin's UpdateSource, minus the early reflection taps it splits off
+		const float NormalizationFactor = 1.0f / static_cast<float>(Options.Tracer.NumRays);
+		Arrivals.Reset();
+		auto AddArrival = [&](const FPathEnergy& Result, float Normalization)
+		{
+			if (Result.DelaySeconds >= Options.DurationSeconds)
+			{
+				return;
+			}
+			FArrival Arrival;
+			Arrival.DelaySeconds = Result.DelaySeconds;
+			Arrival.Energy = Result.Gain * Normalization;
+			Arrival.Direction = Result.Direction;
+			for (int32_t Band = 0; Band < BandCount; ++Band)
+			{
+				Arrival.BandEnergy[Band] = Arrival.Energy * Result.BandReflectance[Band];
+			}
+			Arrivals.Add(Arrival);
+		};
+		for (const FPathRange& Path : Paths.ConnectedPaths)
+		{
+			AddArrival(EvaluatePath(Options.Tracer, Paths.GetVertices(Path), Path.NumVertices, Path.NumForwardVertices), NormalizationFactor);
+		}
+		// Image-source paths are exact, so they are not averaged over the rays
+		size_t NumImagePaths = 0;
+		if (Options.ImageSources.MaxOrder > 0)
+		{
+			ImageSources.Update(Scene, Options.Tracer, Options.ImageSources, Options.Sources[SourceIndex], Options.Listener);
+			for (const FPathEnergy& Result : ImageSources.GetPaths())
+			{
+				AddArrival(Result, 1.0f);
+			}
+			NumImagePaths = ImageSources.GetPaths().size();
+		}
+		Arrivals.Finalize();
+		Arrivals.ToHistograms(Layout.BinSeconds, Layout.NumBins, Energy.data(), BandData);
+		SynthesizeImpulseResponse(Arrivals, Energy.data(), Layout, ImpulseResponse.data());
+
+		const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTime).count();
+		float TotalEnergy = 0.0f;
+		for (float Value : Energy)
+		{
+			TotalEnergy += Value;
+		}
+
+		const std::string OutputPath = OutputPathFor(Options.OutputPath, SourceIndex, Options.Sources.size());
+		if (!WriteWav(OutputPath, ImpulseResponse, Options.SampleRate))
+		{
+			std::fprintf(stderr, "Cannot write %s\n", OutputPath.c_str());
+			return 1;
+		}
+		if (!Options.EnergyPath.empty())
+		{
+			const std::string EnergyPath = OutputPathFor(Options.EnergyPath, SourceIndex, Options.Sources.size());
+			if (!WriteEnergyCsv(EnergyPath, Energy, BandEnergy, Layout.BinSeconds))
+			{
+				std::fprintf(stderr, "Cannot write %s\n", EnergyPath.c_str());
+				return 1;
+			}
+		}
+
+		std::printf("source %zu: %zu of %d paths connected, %zu image-source paths, %d arrivals, energy %g, %.1f ms -> %s\n",
+		            SourceIndex, Paths.ConnectedPaths.size(), Options.Tracer.NumRays, NumImagePaths, Arrivals.Num(), TotalEnergy,
+		            Milliseconds, OutputPath.c_str());
+	}
+	return 0;
+}
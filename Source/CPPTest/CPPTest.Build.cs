@@ -20,8 +20,7 @@ public class CPPTest : ModuleRules
             "Synthesis"
         });
 
-		PublicIncludePaths.Add(Path.Combine(ModuleDirectory, "ThirdParty", "KissFFT"));
-		PrivateDependencyModuleNames.AddRange(new string[] { "FrequenSee" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "FrequenSee", "FrequenSeeDSP" });
 		
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
@@ -2,32 +2,26 @@
 
 
 #include "FrequenSeeEffect.h"
+#include "Misc/ScopeLock.h"
+#include "Tasks/Task.h"
 
 
 // Useful header for various DSP-related utility functions.
 #include "DSP/Dsp.h"
-static void MakeDefaultReverbIR(
-    TArray<float>& IR,
+static int32 MakeDefaultReverbIR(
+    TArray<float>& IR,                          // sized by the caller; never resized here
     float         ReverbTime        = 5.0f,    // seconds
     int32         SampleRate        = 48000,
     float         ReflectionDelay   = 0.05f   // seconds → user‐tweakable!
 )
 {
-    // 1) Do we really need to build one?
-    bool bNeedIR = (IR.Num() == 0);
-    if (!bNeedIR)
-    {
-        for (float v : IR)
-            if (!FMath::IsNearlyZero(v))
-                return;   // already has data
-        bNeedIR = true;   // all zeros → rebuild
-    }
-
-    // 2) Allocate
-    const int32 N = FMath::CeilToInt(ReverbTime * SampleRate);
-    IR.Init(0.0f, N);
+    // 1) Length, limited to what the caller allocated
+    const int32 N = FMath::Min(FMath::CeilToInt(ReverbTime * SampleRate), IR.Num());
+    if (N <= 0)
+        return 0;
+    FMemory::Memzero(IR.GetData(), sizeof(float) * N);
 
-    // 3) Early reflections (now offset by ReflectionDelay)
+    // 2) Early reflections (offset by ReflectionDelay)
     const float BaseTapsSec[] = { 0.003f, 0.008f, 0.011f };
     const float TapGain[]     = { 0.8f,   0.6f,   0.5f   };
     static_assert(UE_ARRAY_COUNT(BaseTapsSec) == UE_ARRAY_COUNT(TapGain), "mismatch");
@@ -40,47 +34,86 @@ static void MakeDefaultReverbIR(
             IR[TapSample] += TapGain[i];
     }
 
-    // 4) Late‐reverb tail (unchanged)
+    // 3) Late‐reverb tail; the envelope is a running product instead of one Exp per sample
     FRandomStream RNG(12345);
-    const float DecayCoeff = -3.0f / (ReverbTime * SampleRate); // –60 dB @ T60
+    const float DecayPerSample = FMath::Exp(-3.0f / (ReverbTime * SampleRate)); // –60 dB @ T60
+    float env = 1.0f;
     for (int32 n = 0; n < N; ++n)
     {
-        float env   = FMath::Exp(DecayCoeff * n);
         float noise = RNG.GetFraction() * 2.f - 1.f; // [–1,1]
         IR[n] += env * noise * 0.25f;                // –12 dB RMS
+        env *= DecayPerSample;
     }
 
-    // 5) Normalize so direct path (sample 0) is 1.0
+    // 4) Normalize so direct path (sample 0) is 1.0
     if (FMath::IsNearlyZero(IR[0]))
         IR[0] = 1.f;
 
-    UE_LOG(LogTemp, Warning,
-        TEXT("IR generated: Size=%d, Delay=%.3f s → FirstSample=%f"),
-        IR.Num(), ReflectionDelay, IR.Num() ? IR[0] : -1.f);
+    return N;
 }
 
 
 // -------------------------------------------------------------
-//  Initialization: just grab channel count & build IR
+//  Initialization: allocate for the longest IR, then request it
 // -------------------------------------------------------------
 void FFrequenSeeEffect::Init(const FSoundEffectSourceInitData& InInitData)
 {
-    NumChannels = InInitData.NumSourceChannels;
+    NumChannels = FMath::Max(InInitData.NumSourceChannels, 1);
+    SampleRate  = FMath::RoundToInt(InInitData.SampleRate);
     VolumeScale = 0.5f;
     bIsActive   = true;
 
-    // Build a mono IR once:
-    MakeDefaultReverbIR(IRTimeDomain,
-                        /*ReverbTime=*/5.0f,
-                        InInitData.SampleRate);
+    // Everything the audio thread touches is sized here; ProcessAudio never allocates and OnPresetChanged only launches a build
+    const int32 MaxIRLength = FMath::CeilToInt(MaxReverbTimeSeconds * SampleRate);
+    Convolver.Init(ConvolutionBlockSize, MaxIRLength, NumChannels);
+    Handoff = MakeShared<FImpulseResponseHandoff, ESPMode::ThreadSafe>();
 
-    // Leave FFT-config allocation until we know block-size
-    BlockSize = 0;
-    FwdCfg = InvCfg = nullptr;
-}
+    // The convolver starts silent; the first IR is built like any preset change and faded in once it is ready
+    ReverbTimeSeconds      = 0.0f;
+    ReflectionDelaySeconds = 0.0f;
+    RebuildImpulseResponse(MaxReverbTimeSeconds, 0.05f);
 
+    UE_LOG(LogTemp, Log,
+        TEXT("FrequenSeeEffect: %d channel(s), up to %d partitions, latency %d frames"),
+        NumChannels, Convolver.GetMaxPartitions(), Convolver.GetLatency());
+}
 
 
+void FFrequenSeeEffect::RebuildImpulseResponse(float ReverbTime, float ReflectionDelay)
+{
+    ReverbTime = FMath::Clamp(ReverbTime, 0.1f, MaxReverbTimeSeconds);
+    ReflectionDelay = FMath::Max(ReflectionDelay, 0.0f);
+    if (ReverbTime == ReverbTimeSeconds && ReflectionDelay == ReflectionDelaySeconds)
+        return;
+
+    ReverbTimeSeconds      = ReverbTime;
+    ReflectionDelaySeconds = ReflectionDelay;
+
+    // Up to 5 s of IR and one FFT per partition are far too much for one render callback
+    const int32 Request = Handoff->LatestRequest.fetch_add(1) + 1;
+    UE::Tasks::Launch(UE_SOURCE_LOCATION,
+        [Handoff = Handoff, Request, ReverbTime, ReflectionDelay, SampleRate = SampleRate]()
+        {
+            if (Handoff->LatestRequest.load() != Request)
+                return;
+
+            TArray<float> IR;
+            IR.SetNumZeroed(FMath::CeilToInt(MaxReverbTimeSeconds * SampleRate));
+            const int32 IRLength = MakeDefaultReverbIR(IR, ReverbTime, SampleRate, ReflectionDelay);
+            FFrequenSeePreparedImpulseResponsePtr Prepared = FFrequenSeePartitionedConvolver::PrepareImpulseResponse(ConvolutionBlockSize, IR.GetData(), IRLength);
+
+            // An IR that was never heard and the one the render thread retired go away here, after the lock
+            FFrequenSeePreparedImpulseResponsePtr Unheard, Retired;
+            FScopeLock Lock(&Handoff->Lock);
+            if (Request < Handoff->ReadyRequest)
+                return;
+            Unheard = MoveTemp(Handoff->Ready);
+            Retired = MoveTemp(Handoff->Retired);
+            Handoff->Ready = MoveTemp(Prepared);
+            Handoff->ReadyRequest = Request;
+            Handoff->bReady.store(true, std::memory_order_release);
+        });
+}
 
 
 void FFrequenSeeEffect::OnPresetChanged()
@@ -91,90 +124,36 @@ void FFrequenSeeEffect::OnPresetChanged()
 	// Update the instance's variables based on the settings values. 
 	// Note that Settings variable was created by the GET_EFFECT_SETTINGS macro.
 	VolumeScale = Audio::ConvertToLinear(Settings.VolumeAttenuationDb);
+
+	// Preset changes arrive on the audio render thread between ProcessAudio calls; the tail keeps ringing while the
+	// new IR is built in the background
+	RebuildImpulseResponse(Settings.ReverbTimeSeconds, Settings.ReflectionDelaySeconds);
 }
 
 // -------------------------------------------------------------
-//  ProcessAudio: overlap-add convolution w/ dynamic FFT size
+//  ProcessAudio: uniformly partitioned overlap-save convolution
 // -------------------------------------------------------------
 void FFrequenSeeEffect::ProcessAudio(
     const FSoundEffectSourceInputData& InData,
     float*                             OutAudio)
 {
-    // If block-size changed (or first time), recompute FFT size & configs
-    if (BlockSize != InData.NumSamples)
-    {
-        // 1) Update block size
-        BlockSize = InData.NumSamples;
-
-        // 2) Compute FFT size = smallest power-of-two ≥ (block + IR – 1)
-        FFTSize = 1u << FMath::CeilLogTwo(BlockSize + IRTimeDomain.Num() - 1);
-
-        // 3) Free any old kiss-fft configs
-        if (FwdCfg) kiss_fft_free(FwdCfg);
-        if (InvCfg) kiss_fft_free(InvCfg);
+    // NumSamples counts interleaved samples; the convolver restages any frame count into its own blocks
+    const int32 NumFrames = InData.NumSamples / NumChannels;
 
-        // 4) Allocate new configs
-        FwdCfg = kiss_fft_alloc(FFTSize, /*inverse=*/0, nullptr, nullptr);
-        InvCfg = kiss_fft_alloc(FFTSize, /*inverse=*/1, nullptr, nullptr);
-
-        // 5) Resize all our circular buffers
-        Tail       .SetNumZeroed(FFTSize - BlockSize);
-        IROverlap  .SetNumZeroed(BlockSize);
-
-        FFTInput   .Init(kiss_fft_cpx{0,0}, FFTSize);
-        FFTResult  .Init(kiss_fft_cpx{0,0}, FFTSize);
-        FFTIR      .Init(kiss_fft_cpx{0,0}, FFTSize);
-
-        // 6) Pre-FFT the IR
-        {
-            TArray<kiss_fft_cpx> tmp;
-            tmp.Init({0,0}, FFTSize);
-            for (int32 i = 0; i < IRTimeDomain.Num(); ++i)
-                tmp[i].r = IRTimeDomain[i];
-            kiss_fft(FwdCfg, tmp.GetData(), FFTIR.GetData());
-        }
-    }
-
-    // ------- ZERO the entire output buffer to start clean -------
-    FMemory::Memzero(OutAudio, sizeof(float) * BlockSize);
-
-    // ------- 0) Copy only as much of the old tail as fits -------
-    int32 NumToCopy = FMath::Min<int32>(Tail.Num(), BlockSize);
-    for (int32 n = 0; n < NumToCopy; ++n)
-        OutAudio[n] = Tail[n];
-
-    // ------- 1) Pack the new block into FFTInput -------------
-    for (int32 n = 0; n < BlockSize; ++n)
-    {
-        FFTInput[n].r = InData.InputSourceEffectBufferPtr[n];
-        FFTInput[n].i = 0.f;
-    }
-    for (int32 n = BlockSize; n < FFTSize; ++n)
-        FFTInput[n] = {0,0};
-
-    // ------- 2) FFT → multiply by IR → IFFT -------------
-    kiss_fft(FwdCfg, FFTInput.GetData(), FFTResult.GetData());
-    for (int32 n = 0; n < FFTSize; ++n)
+    // ------- 0) Pick up a rebuilt IR: pointing at its spectra costs no FFTs; a busy build just waits a callback -------
+    if (Handoff->bReady.load(std::memory_order_acquire) && Handoff->Lock.TryLock())
     {
-        float ar = FFTResult[n].r, ai = FFTResult[n].i;
-        float br = FFTIR[n].r,     bi = FFTIR[n].i;
-        FFTResult[n].r = ar*br - ai*bi;
-        FFTResult[n].i = ar*bi + ai*br;
+        // Every hand-over follows a build that cleared Retired, so nothing is released here
+        Handoff->Retired = Convolver.SetImpulseResponse(MoveTemp(Handoff->Ready));
+        Handoff->bReady.store(false, std::memory_order_relaxed);
+        Handoff->Lock.Unlock();
     }
-    kiss_fft(InvCfg, FFTResult.GetData(), FFTInput.GetData()); // reuse buffer
-
-    // ------- 3) Overlap-add (and scale by 1/FFTSize) -------
-    const float Scale = 1.f / FFTSize;
-    // add current block
-    for (int32 n = 0; n < BlockSize; ++n)
-        OutAudio[n] += FFTInput[n].r * Scale;
 
-    // stash the new tail for next time
-    for (int32 n = 0; n < Tail.Num(); ++n)
-        Tail[n] = FFTInput[n + BlockSize].r * Scale;
+    // ------- 1) FFT → multiply-accumulate all IR partitions → IFFT, per channel -------
+    Convolver.Process(InData.InputSourceEffectBufferPtr, OutAudio, NumFrames);
 
-    // ------- 4) Apply global gain -------------
-    for (int32 n = 0; n < BlockSize; ++n)
+    // ------- 2) Apply global gain -------------
+    for (int32 n = 0; n < NumFrames * NumChannels; ++n)
         OutAudio[n] *= VolumeScale;
 }
 
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "ThirdParty/KissFFT/kiss_fft.h"
+#include "FrequenSeePartitionedConvolver.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
 #include "Sound/SoundEffectSource.h"
 #include "FrequenSeeEffect.generated.h"
 
@@ -22,8 +24,20 @@ struct CPPTEST_API FFrequenSeeEffectSettings
 		meta = (ClampMin = "-96.0", UIMin = "-96.0", UIMax = "10.0"))
 	float VolumeAttenuationDb;
 
+	// Decay time of the generated reverb impulse response, in seconds.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SourceEffect|Preset",
+		meta = (ClampMin = "0.1", ClampMax = "5.0", UIMin = "0.1", UIMax = "5.0"))
+	float ReverbTimeSeconds;
+
+	// Offset of the early reflections in the generated impulse response, in seconds.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SourceEffect|Preset",
+		meta = (ClampMin = "0.0", ClampMax = "0.5", UIMin = "0.0", UIMax = "0.5"))
+	float ReflectionDelaySeconds;
+
 	FFrequenSeeEffectSettings()
 		: VolumeAttenuationDb(0.0f)
+		, ReverbTimeSeconds(5.0f)
+		, ReflectionDelaySeconds(0.05f)
 	{
 	}
 };
@@ -45,23 +59,49 @@ public:
 	// Process the input block of audio. Called on audio thread.
 	virtual void ProcessAudio(const FSoundEffectSourceInputData& InData, float* OutAudioBufferData) override;
 
-	kiss_fft_cfg FwdCfg;
-	kiss_fft_cfg InvCfg;
-	TArray<kiss_fft_cpx> FFTInput;
-	TArray<kiss_fft_cpx> FFTIR;
-	TArray<kiss_fft_cpx> FFTResult;
-	TArray<float> IRTimeDomain;
-	TArray<float> IROverlap;
-	int32 FFTSize = 2048;
-	int32 BlockSize = 0;
-	/** Overlap‑add spill‑over buffer: length = FFTSize - BlockSize.
-		Holds the part of the convolved signal that belongs to the next block. */
-	TArray<float> Tail;
+	/** Partition size of the convolver; adds this many frames of latency independent of the host block size. */
+	static constexpr int32 ConvolutionBlockSize = 256;
+
+	/** Longest impulse response the effect can hold, in seconds. Everything is allocated for this in Init(). */
+	static constexpr float MaxReverbTimeSeconds = 5.0f;
+
+	/** Uniformly partitioned real-FFT convolver shared with the FrequenSee reverb plugin, one channel per source channel. */
+	FFrequenSeePartitionedConvolver Convolver;
 protected:
+	/**
+	 * Where a background build leaves a partitioned IR for the audio render thread, which only ever try-locks it.
+	 * Shared with the build tasks, so one still running when the effect goes away has somewhere to write.
+	 */
+	struct FImpulseResponseHandoff
+	{
+		FCriticalSection Lock;
+		/** Newest IR the render thread has not taken yet. */
+		FFrequenSeePreparedImpulseResponsePtr Ready;
+		int32 ReadyRequest = 0;
+		/** The IR the convolver let go of at the last hand-over, released by the next build instead of the render thread. */
+		FFrequenSeePreparedImpulseResponsePtr Retired;
+		std::atomic<bool> bReady{ false };
+		/** Bumped by every rebuild; a build overtaken by a later one is dropped. */
+		std::atomic<int32> LatestRequest{ 0 };
+	};
+
+	/**
+	 * Generates and partitions the IR on a background task; ProcessAudio() hands it to the convolver, which crossfades
+	 * to it on its next block. Called from Init() and on the audio render thread, neither of which does the work itself.
+	 */
+	void RebuildImpulseResponse(float ReverbTime, float ReflectionDelay);
+
+	TSharedPtr<FImpulseResponseHandoff, ESPMode::ThreadSafe> Handoff;
+
 	// Attenuation of sound in linear units
 	float VolumeScale;
 
 	int32 NumChannels;
+	int32 SampleRate;
+
+	/** Settings of the last requested IR; zero until Init() requests the first. */
+	float ReverbTimeSeconds = 0.0f;
+	float ReflectionDelaySeconds = 0.0f;
 };
 
 // ========================================================================